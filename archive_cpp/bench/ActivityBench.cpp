@@ -0,0 +1,83 @@
+// Ticks a large population of entities either all at once or only those
+// around two activity areas (camera and hero) plus a few timers, to show
+// that the scheduled tick cost follows the local population.
+
+#include "BenchUtils.h"
+#include "game/ActivityScheduler.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct Entity
+{
+    int32_t     x;
+    int32_t     y;
+    int32_t     phase = 0;
+    uint32_t    updates = 0;
+};
+
+static void UpdateEntity(Entity& e)
+{
+    // stand-in for a bit of event logic
+    e.phase = (e.phase * 1103515245 + 12345) & 0x7fffffff;
+    ++e.updates;
+}
+
+int main()
+{
+    constexpr int worldWidth = 1024 * 32;
+    constexpr int worldHeight = 256 * 32;
+    constexpr int ticks = 1000;
+    const int counts[] = {1000, 10000, 100000};
+
+    std::mt19937 rng(33);
+    for (int count : counts)
+    {
+        std::uniform_int_distribution<int> x(0, worldWidth - 32);
+        std::uniform_int_distribution<int> y(0, worldHeight - 32);
+        std::vector<Entity> entities(count);
+        BroadPhaseGrid grid(worldWidth, worldHeight, 128);
+        for (int i = 0; i < count; ++i)
+        {
+            entities[i].x = x(rng);
+            entities[i].y = y(rng);
+            grid.Insert({entities[i].x, entities[i].y, 32, 32}, i);
+        }
+        char name[64];
+
+        bench::Stopwatch sw;
+        for (int t = 0; t < ticks; ++t)
+        {
+            for (auto& e : entities)
+            {
+                UpdateEntity(e);
+            }
+        }
+        std::snprintf(name, sizeof(name), "%6d entities, update all", count);
+        bench::Report(name, sw.ElapsedMs() / ticks, count);
+
+        // a 640x480 view with a 320 px margin and the hero inside of it
+        ActivityScheduler scheduler(count);
+        for (int i = 0; i < 100; ++i)
+        {
+            scheduler.WakeAt(i % count, GameClock::now());
+        }
+        long active = 0;
+        sw.Restart();
+        for (int t = 0; t < ticks; ++t)
+        {
+            int vx = (t * 8) % (worldWidth - 640);
+            const Rectangle2D areas[] = {{vx - 320, 2000 - 320, 640 + 640, 480 + 640},
+                                         {vx + 300 - 320, 2200 - 320, 32 + 640, 32 + 640}};
+            scheduler.Tick(GameClock::now(), grid, areas, 2, [&](int e)
+            {
+                UpdateEntity(entities[e]);
+            });
+            active += scheduler.GetActiveCount();
+        }
+        std::snprintf(name, sizeof(name), "%6d entities, scheduled (%ld active)", count, active / ticks);
+        bench::Report(name, sw.ElapsedMs() / ticks, count);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+// Builds and copies a large number of animations and reports how long it
+// takes and how many heap allocations the copies and strategy switches make.
+
+#include "BenchUtils.h"
+#include "gfx/Animation.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+static std::atomic<long> allocationCount{0};
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+int main()
+{
+    constexpr int animationCount = 100000;
+    constexpr int framesPerAnimation = 8;
+
+    std::vector<SurfaceSharedPtr> frames;
+    for (int i = 0; i < framesPerAnimation; ++i)
+    {
+        frames.push_back(std::make_shared<Surface>(32, 32));
+    }
+
+    std::vector<Animation> animations;
+    animations.reserve(animationCount);
+
+    bench::Stopwatch sw;
+    long allocs = allocationCount;
+    for (int i = 0; i < animationCount; ++i)
+    {
+        Animation a(10);
+        for (const auto& f : frames)
+        {
+            a.PushFrame(f);
+        }
+        a.SetStrategy(AnimationStrategy::Normal);
+        animations.push_back(std::move(a));
+    }
+    bench::Report("build", sw.ElapsedMs(), animationCount);
+    std::printf("  allocations: %ld\n", allocationCount - allocs);
+
+    std::vector<Animation> copies;
+    copies.reserve(animationCount);
+    sw.Restart();
+    allocs = allocationCount;
+    for (const auto& a : animations)
+    {
+        copies.push_back(a);
+    }
+    bench::Report("copy", sw.ElapsedMs(), animationCount);
+    std::printf("  allocations: %ld\n", allocationCount - allocs);
+
+    sw.Restart();
+    allocs = allocationCount;
+    for (auto& a : copies)
+    {
+        a.SetStrategy(AnimationStrategy::AnimateTillLastFrame);
+        a.SetStrategy(AnimationStrategy::OnlyFirtsFrame);
+    }
+    bench::Report("strategy switch (x2)", sw.ElapsedMs(), 2.0 * animationCount);
+    std::printf("  allocations: %ld\n", allocationCount - allocs);
+
+    sw.Restart();
+    auto now = GameClock::now();
+    long checksum = 0;
+    for (auto& a : animations)
+    {
+        a.Update(now + miliseconds(150));
+        checksum += a.IsFinished() ? 1 : 0;
+    }
+    bench::Report("update", sw.ElapsedMs(), animationCount);
+    std::printf("  checksum: %ld\n", checksum);
+
+    return 0;
+}
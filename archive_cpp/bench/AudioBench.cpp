@@ -0,0 +1,289 @@
+// Sound path end to end, headless. An animation file with samples in every
+// set is written and read: the load keeps the sample blocks compressed and
+// the cost it no longer pays, inflating and decoding every set, is timed
+// on its own; decoded samples are checked against what was written. The
+// mixer is checked against reference output, then timed mixing 32 looping
+// voices, counting heap allocations while it mixes. Last the mixer runs
+// behind an AudioDevice on SDL's dummy driver, where no allocation may
+// happen on the audio thread.
+
+#include "BenchUtils.h"
+#include "SyntheticAssets.h"
+#include "audio/AudioDevice.h"
+#include "audio/Mixer.h"
+#include "audio/SampleBank.h"
+#include "data/Jazz2AnimFormat.h"
+#include "utils/MemoryStats.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static std::atomic<long> allocationCount{0};
+static std::atomic<long> otherThreadAllocationCount{0};
+static std::thread::id mainThread;
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (std::this_thread::get_id() != mainThread)
+    {
+        ++otherThreadAllocationCount;
+    }
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+constexpr int setCount = 100;
+constexpr int samplesPerSet = 8;
+constexpr int sampleRate = 22050;
+
+// a tone with some noise, half a second; 8 bit samples only keep the high
+// byte, so theirs is zero and they read back exactly
+J2SampleContent MakeSample(bool sixteenBit, std::mt19937& rng)
+{
+    J2SampleContent s;
+    s.rate = sampleRate;
+    s.sixteenBit = sixteenBit;
+    s.frames.resize(sampleRate / 2);
+    const double frequency = 200.0 + rng() % 800;
+    for (size_t i = 0; i < s.frames.size(); ++i)
+    {
+        const double tone = 12000.0 * std::sin(2.0 * 3.14159265358979 * frequency * i / sampleRate);
+        const int frame = static_cast<int>(tone) + static_cast<int>(rng() % 4001) - 2000;
+        s.frames[i] = static_cast<int16_t>(sixteenBit ? frame : frame & ~0xff);
+    }
+    return s;
+}
+
+SamplePtr ToSample(const std::vector<int16_t>& frames, int rate)
+{
+    std::shared_ptr<Sample> s = std::make_shared<Sample>();
+    s->rate = rate;
+    s->frames = frames;
+    return s;
+}
+
+bool Check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        std::printf("  failed: %s\n", what);
+    }
+    return ok;
+}
+
+// one voice at the output rate comes out as it is, at half the rate every
+// other frame is interpolated, a stopped loop goes silent
+bool MixerCorrect()
+{
+    bool correct = true;
+    std::vector<int16_t> frames(1000);
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        frames[i] = static_cast<int16_t>(static_cast<int>((i * 7919) % 60000) - 30000);
+    }
+    {
+        Mixer mixer(sampleRate);
+        mixer.Play(ToSample(frames, sampleRate));
+        std::vector<int16_t> out(2 * 2 * frames.size());
+        mixer.Mix(out.data(), static_cast<int>(out.size() / 2));
+        bool same = true;
+        for (size_t i = 0; i < out.size() / 2; ++i)
+        {
+            const int16_t expected = i < frames.size() ? frames[i] : 0;
+            same = same && out[2 * i] == expected && out[2 * i + 1] == expected;
+        }
+        correct = Check(same, "frames at the output rate") && correct;
+        mixer.CollectFinished();
+        correct = Check(mixer.GetBusyVoiceCount() == 0, "finished voice collected") && correct;
+    }
+    {
+        Mixer mixer(sampleRate);
+        mixer.Play(ToSample(frames, sampleRate / 2), 1.0f, 1.0f);
+        std::vector<int16_t> out(2 * 2 * frames.size());
+        mixer.Mix(out.data(), static_cast<int>(out.size() / 2));
+        bool same = true;
+        for (size_t i = 0; i + 1 < frames.size(); ++i)
+        {
+            const int between = frames[i] + ((frames[i + 1] - frames[i]) * 32768 >> 16);
+            same = same && out[4 * i] == 0 && out[4 * i + 1] == frames[i] && out[4 * i + 3] == between;
+        }
+        correct = Check(same, "frames at half the output rate, panned right") && correct;
+    }
+    {
+        Mixer mixer(sampleRate);
+        const Mixer::VoiceId voice = mixer.Play(ToSample(frames, sampleRate), 1.0f, 0.0f, true);
+        std::vector<int16_t> out(2 * 3 * frames.size());
+        mixer.Mix(out.data(), static_cast<int>(out.size() / 2));
+        const bool looped = out[2 * frames.size() + 2] == frames[1];
+        mixer.Stop(voice);
+        mixer.Mix(out.data(), 64);
+        bool silent = true;
+        for (int i = 0; i < 128; ++i)
+        {
+            silent = silent && out[i] == 0;
+        }
+        correct = Check(looped && silent, "loop and stop") && correct;
+    }
+    return correct;
+}
+
+}
+
+int main()
+{
+    mainThread = std::this_thread::get_id();
+    std::mt19937 rng(50);
+    bool correct = true;
+
+    char dir[] = "/tmp/AudioBenchXXXXXX";
+    if (mkdtemp(dir) == nullptr)
+    {
+        std::perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    const std::string file = std::string(dir) + "/Sounds.j2a";
+    J2SampleSetsContent written(setCount);
+    for (auto& set : written)
+    {
+        for (int i = 0; i < samplesPerSet; ++i)
+        {
+            set.push_back(MakeSample(i % 2 == 0, rng));
+        }
+    }
+    Jazz2AnimFormat::Write(file, bench::SyntheticAnimSets(setCount, 1, 1, 8, 50), written);
+
+    {
+        std::printf("%d sets of %d samples, %.1f s of sound\n", setCount, samplesPerSet,
+                    setCount * samplesPerSet * 0.5);
+        bench::Stopwatch sw;
+        Jazz2AnimFormat anims(file);
+        bench::Report("load, samples kept compressed", sw.ElapsedMs(), 1);
+        std::printf("  audio memory: %lld bytes\n",
+                    static_cast<long long>(MemoryStats::Get(MemoryCategory::Audio).bytes));
+
+        SampleBank bank(anims);
+        sw.Restart();
+        SamplePtr first = bank.Get(setCount / 2, 0);
+        bench::Report("first use of a sample, one set decoded", sw.ElapsedMs(), 1);
+        correct = Check(bank.GetDecodedSetCount() == 1, "one set decoded") && correct;
+        correct = Check(first && first->frames == written[setCount / 2][0].frames, "first sample") && correct;
+
+        sw.Restart();
+        std::vector<std::vector<SamplePtr>> all;
+        for (int s = 0; s < setCount; ++s)
+        {
+            all.push_back(anims.DecodeSamples(s));
+        }
+        bench::Report("decoding every set, what the load skips", sw.ElapsedMs(), setCount);
+        std::printf("  audio memory: %lld bytes\n",
+                    static_cast<long long>(MemoryStats::Get(MemoryCategory::Audio).bytes));
+        bool same = true;
+        for (int s = 0; s < setCount; ++s)
+        {
+            same = same && all[s].size() == written[s].size();
+            for (size_t i = 0; same && i < all[s].size(); ++i)
+            {
+                same = all[s][i]->rate == written[s][i].rate && all[s][i]->frames == written[s][i].frames;
+            }
+        }
+        correct = Check(same, "samples read back") && correct;
+    }
+    std::remove(file.c_str());
+    rmdir(dir);
+
+    correct = MixerCorrect() && correct;
+
+    {
+        // 32 loops at the rates JJ2 uses, mixed to 44.1 kHz in 1024 frame
+        // buffers, as the callback would
+        constexpr int outputRate = 44100;
+        constexpr int bufferFrames = 1024;
+        constexpr int seconds = 60;
+        Mixer mixer(outputRate);
+        std::vector<SamplePtr> samples;
+        const int rates[] = {8000, 11025, 22050, 44100};
+        for (int i = 0; i < Mixer::voiceCount; ++i)
+        {
+            J2SampleContent s = MakeSample(true, rng);
+            samples.push_back(ToSample(s.frames, rates[i % 4]));
+            mixer.Play(samples.back(), 0.25f, (i % 5 - 2) / 2.0f, true);
+        }
+        correct = Check(mixer.GetBusyVoiceCount() == Mixer::voiceCount, "all voices playing") && correct;
+        std::vector<int16_t> out(bufferFrames * Mixer::channelCount);
+        const int buffers = seconds * outputRate / bufferFrames;
+        const long allocs = allocationCount;
+        bench::Stopwatch sw;
+        for (int b = 0; b < buffers; ++b)
+        {
+            mixer.Mix(out.data(), bufferFrames);
+        }
+        const double ms = sw.ElapsedMs();
+        bench::Report("mixing 32 voices, buffers", ms, buffers);
+        std::printf("  %.0fx real time, allocations: %ld\n", seconds * 1000.0 / ms, allocationCount - allocs);
+        correct = Check(allocationCount == allocs, "no allocation while mixing") && correct;
+    }
+
+    {
+        setenv("SDL_AUDIODRIVER", "dummy", 1);
+        try
+        {
+            AudioDevice device(44100, 512);
+            std::vector<SamplePtr> samples;
+            for (int i = 0; i < Mixer::voiceCount; ++i)
+            {
+                J2SampleContent s = MakeSample(true, rng);
+                samples.push_back(ToSample(s.frames, sampleRate));
+            }
+            const long allocs = otherThreadAllocationCount;
+            for (int round = 0; round < 4; ++round)
+            {
+                for (const auto& s : samples)
+                {
+                    device.GetMixer().Play(s, 0.25f, 0.0f, round % 2 == 0);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                device.GetMixer().StopAll();
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            const long audioAllocs = otherThreadAllocationCount - allocs;
+            std::printf("%s driver, %d Hz: %llu frames mixed, allocations off the main thread: %ld\n",
+                        device.GetDriverName(), device.GetRate(),
+                        static_cast<unsigned long long>(device.GetMixer().GetMixedFrames()), audioAllocs);
+            correct = Check(device.GetMixer().GetMixedFrames() > 0, "the callback ran") && correct;
+            correct = Check(audioAllocs == 0, "no allocation on the audio thread") && correct;
+        }
+        catch (const std::exception& ex)
+        {
+            std::printf("no dummy audio driver: %s\n", ex.what());
+        }
+    }
+
+    std::printf("results %s\n", correct ? "correct" : "WRONG");
+    return correct ? EXIT_SUCCESS : EXIT_FAILURE;
+}
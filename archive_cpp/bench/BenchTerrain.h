@@ -0,0 +1,73 @@
+#ifndef BENCHTERRAIN_H
+#define BENCHTERRAIN_H
+
+// Synthetic headless terrain shared by the collision benchmarks.
+
+#include "game/Layer.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace bench
+{
+
+inline TileSetPtr BuildTileSet(std::mt19937& rng)
+{
+    // tile 0 is empty, 1 is solid, the rest are random slopes and noise
+    constexpr int tileCount = 64;
+    auto ts = std::make_shared<TileSet>(tileCount);
+    std::vector<char> mask(TileSet::collisionMaskSize), flipped(TileSet::collisionMaskSize);
+    for (int id = 0; id < tileCount; ++id)
+    {
+        std::fill(mask.begin(), mask.end(), 0);
+        std::fill(flipped.begin(), flipped.end(), 0);
+        for (int y = 0; y < TileSet::tileSize; ++y)
+        {
+            for (int x = 0; x < TileSet::tileSize; ++x)
+            {
+                bool solid = id == 1
+                        || (id > 1 && id < 32 && y >= x * id / 32)
+                        || (id >= 32 && rng() % 4 == 0);
+                if (solid)
+                {
+                    int bit = y * TileSet::tileSize + x;
+                    int flippedBit = y * TileSet::tileSize + TileSet::tileSize - 1 - x;
+                    mask[bit / 8] |= 1 << (bit % 8);
+                    flipped[flippedBit / 8] |= 1 << (flippedBit % 8);
+                }
+            }
+        }
+        ts->AddTile(nullptr, nullptr, &mask[0], &flipped[0]);
+    }
+    return ts;
+}
+
+inline Layer BuildLayer(const TileSetPtr& ts, std::mt19937& rng)
+{
+    constexpr int width = 256;
+    constexpr int height = 64;
+    Layer layer(width, height, false, false, false, false, ts);
+    for (int ty = 0; ty < height; ++ty)
+    {
+        for (int tx = 0; tx < width; ++tx)
+        {
+            // about one third of the cells are filled, the bottom is solid
+            TileId id = 0;
+            if (ty >= height - 4)
+            {
+                id = 1;
+            }
+            else if (rng() % 3 == 0)
+            {
+                id = static_cast<TileId>(1 + rng() % (ts->GetStaticTileCount() - 1));
+            }
+            layer.SetTile(tx, ty, id, rng() % 2 == 0);
+        }
+    }
+    return layer;
+}
+
+}
+
+#endif // BENCHTERRAIN_H
@@ -0,0 +1,37 @@
+#ifndef BENCHUTILS_H
+#define BENCHUTILS_H
+
+#include <chrono>
+#include <cstdio>
+
+namespace bench
+{
+
+class Stopwatch
+{
+public:
+    Stopwatch()
+        : start(std::chrono::steady_clock::now())
+    { }
+    void Restart()
+    {
+        start = std::chrono::steady_clock::now();
+    }
+    double ElapsedMs() const
+    {
+        std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - start;
+        return d.count();
+    }
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+inline void Report(const char* name, double ms, double ops)
+{
+    double per_sec = ms > 0.0 ? ops / (ms / 1000.0) : 0.0;
+    std::printf("%-48s %10.3f ms %16.0f ops/s\n", name, ms, per_sec);
+}
+
+}
+
+#endif // BENCHUTILS_H
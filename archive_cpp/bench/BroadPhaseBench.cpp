@@ -0,0 +1,121 @@
+// Inserts, moves and removes many dynamic entities in the broad phase grid
+// and queries overlapping pairs. The pairs are checked against a brute
+// force search.
+
+#include "BenchUtils.h"
+#include "game/BroadPhaseGrid.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<int, int>> PairList;
+
+static PairList BruteForcePairs(const std::vector<Rectangle2D>& boxes)
+{
+    PairList pairs;
+    for (int a = 0; a < static_cast<int>(boxes.size()); ++a)
+    {
+        for (int b = a + 1; b < static_cast<int>(boxes.size()); ++b)
+        {
+            if (BroadPhaseGrid::Overlap(boxes[a], boxes[b]))
+            {
+                pairs.emplace_back(a, b);
+            }
+        }
+    }
+    return pairs;
+}
+
+static int Run(int count, std::mt19937& rng)
+{
+    constexpr int worldWidth = 256 * 32;
+    constexpr int worldHeight = 64 * 32;
+    constexpr int ticks = 100;
+    std::uniform_int_distribution<int> x(0, worldWidth - 1);
+    std::uniform_int_distribution<int> y(0, worldHeight - 1);
+    std::uniform_int_distribution<int> size(8, 96);
+    std::uniform_int_distribution<int> d(-8, 8);
+
+    std::vector<Rectangle2D> boxes(count);
+    for (auto& b : boxes)
+    {
+        b = {x(rng), y(rng), size(rng), size(rng)};
+    }
+
+    BroadPhaseGrid grid(worldWidth, worldHeight, 128);
+    std::vector<BroadPhaseGrid::ProxyId> ids(count);
+    char name[64];
+
+    bench::Stopwatch sw;
+    for (int i = 0; i < count; ++i)
+    {
+        ids[i] = grid.Insert(boxes[i], i);
+    }
+    std::snprintf(name, sizeof(name), "%5d entities, insert", count);
+    bench::Report(name, sw.ElapsedMs(), count);
+
+    sw.Restart();
+    for (int t = 0; t < ticks; ++t)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            boxes[i].x += d(rng);
+            boxes[i].y += d(rng);
+            grid.Move(ids[i], boxes[i]);
+        }
+    }
+    std::snprintf(name, sizeof(name), "%5d entities, move", count);
+    bench::Report(name, sw.ElapsedMs(), double(count) * ticks);
+
+    PairList pairs;
+    sw.Restart();
+    for (int t = 0; t < ticks; ++t)
+    {
+        pairs.clear();
+        grid.QueryPairs([&](BroadPhaseGrid::ProxyId a, BroadPhaseGrid::ProxyId b)
+        {
+            int ua = grid.GetUserData(a);
+            int ub = grid.GetUserData(b);
+            pairs.emplace_back(std::min(ua, ub), std::max(ua, ub));
+        });
+    }
+    std::snprintf(name, sizeof(name), "%5d entities, pair query (%d pairs)", count,
+                  static_cast<int>(pairs.size()));
+    bench::Report(name, sw.ElapsedMs() / ticks, 1);
+
+    sw.Restart();
+    PairList expected = BruteForcePairs(boxes);
+    std::snprintf(name, sizeof(name), "%5d entities, brute force pairs", count);
+    bench::Report(name, sw.ElapsedMs(), 1);
+
+    sw.Restart();
+    for (int i = 0; i < count; ++i)
+    {
+        grid.Remove(ids[i]);
+    }
+    std::snprintf(name, sizeof(name), "%5d entities, remove", count);
+    bench::Report(name, sw.ElapsedMs(), count);
+
+    std::sort(pairs.begin(), pairs.end());
+    return (pairs != expected || grid.GetProxyCount() != 0) ? 1 : 0;
+}
+
+int main()
+{
+    std::mt19937 rng(31);
+    int errors = 0;
+    const int counts[] = {100, 1000, 10000};
+    for (int count : counts)
+    {
+        errors += Run(count, rng);
+    }
+    if (errors != 0)
+    {
+        std::printf("grid pairs differ from the brute force pairs\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+// Compares terrain sweeps through the per-pixel functor path (layer ->
+// tile set -> collision mask) with sweeps over the level-wide collision
+// bitmap. Both must give exactly the same results. Also measures the box
+// resolver that moves whole bodies in a single call.
+
+#include "BenchTerrain.h"
+#include "BenchUtils.h"
+#include "CollisionEngine.h"
+#include "game/CollisionBitmap.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct LayerTerrain
+{
+    LayerTerrain(const Layer& l)
+        : layer(l)
+    { }
+    bool operator()(int x, int y) const
+    {
+        return layer.IsCollidableAt(x, y);
+    }
+private:
+    const Layer& layer;
+};
+
+struct Query
+{
+    Point2D p;
+    Vector2D v;
+};
+
+static std::vector<Query> BuildQueries(const Layer& layer, int maxDelta, std::mt19937& rng)
+{
+    constexpr int queryCount = 1000000;
+    std::vector<Query> queries(queryCount);
+    std::uniform_int_distribution<int> x(0, layer.GetWidth() - 1);
+    std::uniform_int_distribution<int> y(0, layer.GetHeight() - 1);
+    std::uniform_int_distribution<int> d(-maxDelta, maxDelta);
+    for (auto& q : queries)
+    {
+        q.p = {x(rng), y(rng)};
+        q.v = {d(rng), d(rng)};
+    }
+    return queries;
+}
+
+template <class TerrainGetterFn>
+static long Run(const char* name, const TerrainGetterFn& terrain,
+                const std::vector<Query>& queries, std::vector<Vector2D>& out)
+{
+    out.resize(queries.size());
+    long collisions = 0;
+    bench::Stopwatch sw;
+    for (unsigned i = 0; i < queries.size(); ++i)
+    {
+        Vector2D v = queries[i].v;
+        collisions += CollisionEngine::AdjustMovementVector(terrain, queries[i].p, v);
+        out[i] = v;
+    }
+    bench::Report(name, sw.ElapsedMs(), queries.size());
+    return collisions;
+}
+
+static bool BoxOverlaps(const CollisionBitmap& bitmap, int x, int y, int w, int h)
+{
+    int hit = 0;
+    for (int row = y; row < y + h; ++row)
+    {
+        if (bitmap.FirstSolidInRow(row, x, x + w - 1, hit))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// checks that boxes which start in free space never end up in the terrain
+static int RunBoxes(const CollisionBitmap& bitmap, const std::vector<Query>& queries)
+{
+    constexpr int boxSize = 32;
+    const Vector2D hull[] = {{0, 0}, {boxSize - 1, 0}, {boxSize - 1, boxSize - 1}, {0, boxSize - 1}};
+    long checksum = 0;
+
+    bench::Stopwatch sw;
+    for (const auto& q : queries)
+    {
+        Vector2D v = q.v;
+        for (const auto& h : hull)
+        {
+            CollisionEngine::AdjustMovementVector(bitmap, {q.p.x + h.dx, q.p.y + h.dy}, v);
+        }
+        checksum += v.dx + v.dy;
+    }
+    bench::Report("box 32x32, four corner sweeps", sw.ElapsedMs(), queries.size());
+
+    sw.Restart();
+    for (const auto& q : queries)
+    {
+        auto r = CollisionEngine::SweepBox(bitmap, {q.p.x, q.p.y, boxSize, boxSize}, q.v);
+        checksum += r.moved.dx + r.moved.dy + r.contacts.onTheGround;
+    }
+    bench::Report("box 32x32, SweepBox", sw.ElapsedMs(), queries.size());
+
+    int errors = 0;
+    for (const auto& q : queries)
+    {
+        if (BoxOverlaps(bitmap, q.p.x, q.p.y, boxSize, boxSize))
+        {
+            continue;
+        }
+        auto r = CollisionEngine::SweepBox(bitmap, {q.p.x, q.p.y, boxSize, boxSize}, q.v);
+        errors += BoxOverlaps(bitmap, q.p.x + r.moved.dx, q.p.y + r.moved.dy, boxSize, boxSize);
+    }
+    std::printf("(checksum %ld)\n", checksum);
+    return errors;
+}
+
+int main()
+{
+    std::mt19937 rng(28);
+    auto ts = bench::BuildTileSet(rng);
+    Layer layer = bench::BuildLayer(ts, rng);
+
+    bench::Stopwatch sw;
+    CollisionBitmap bitmap(layer);
+    bench::Report("build bitmap 256x64 tiles", sw.ElapsedMs(), 1);
+
+    LayerTerrain functor(layer);
+    int mismatches = 0;
+    for (int y = 0; y < layer.GetHeight(); ++y)
+    {
+        for (int x = 0; x < layer.GetWidth(); ++x)
+        {
+            mismatches += functor(x, y) != bitmap(x, y);
+        }
+    }
+
+    const int deltas[] = {8, 64, 512};
+    for (int maxDelta : deltas)
+    {
+        auto queries = BuildQueries(layer, maxDelta, rng);
+        std::vector<Vector2D> expected, actual;
+        char name[64];
+        std::snprintf(name, sizeof(name), "sweep functor, |d| <= %d", maxDelta);
+        long c1 = Run(name, functor, queries, expected);
+        std::snprintf(name, sizeof(name), "sweep bitmap, |d| <= %d", maxDelta);
+        long c2 = Run(name, bitmap, queries, actual);
+        mismatches += c1 != c2;
+        for (unsigned i = 0; i < queries.size(); ++i)
+        {
+            mismatches += expected[i].dx != actual[i].dx || expected[i].dy != actual[i].dy;
+        }
+    }
+
+    int boxErrors = RunBoxes(bitmap, BuildQueries(layer, 16, rng));
+    if (boxErrors != 0)
+    {
+        std::printf("SweepBox moved %d boxes into the terrain\n", boxErrors);
+        return EXIT_FAILURE;
+    }
+
+    if (mismatches != 0)
+    {
+        std::printf("bitmap and functor disagree in %d cases\n", mismatches);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+// Resolves growing batches of bodies against the terrain on the calling
+// thread and on the job system, and checks that the results are identical.
+
+#include "BenchTerrain.h"
+#include "BenchUtils.h"
+#include "game/CollisionWorld.h"
+#include "utils/JobSystem.h"
+
+#include <cstdlib>
+#include <random>
+
+static BodyBatch BuildBodies(const CollisionBitmap& terrain, int count, std::mt19937& rng)
+{
+    std::uniform_int_distribution<int> x(0, terrain.GetWidth() - 32);
+    std::uniform_int_distribution<int> y(0, terrain.GetHeight() - 32);
+    std::uniform_int_distribution<int> size(8, 32);
+    std::uniform_int_distribution<int> d(-12, 12);
+    BodyBatch bodies;
+    for (int i = 0; i < count; ++i)
+    {
+        bodies.Add({x(rng), y(rng), size(rng), size(rng)}, {d(rng), d(rng)});
+    }
+    return bodies;
+}
+
+static uint64_t Hash(const BodyBatch& b)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (int i = 0; i < b.Size(); ++i)
+    {
+        const int64_t values[] = {b.x[i], b.y[i], b.dx[i], b.dy[i], b.contacts[i]};
+        for (auto v : values)
+        {
+            h = (h ^ static_cast<uint64_t>(v)) * 1099511628211ull;
+        }
+    }
+    return h;
+}
+
+static uint64_t Run(const CollisionBitmap& terrain, const CollisionWorld& world,
+                    const BodyBatch& initial, int ticks)
+{
+    BodyBatch bodies = initial;
+    bench::Stopwatch sw;
+    for (int t = 0; t < ticks; ++t)
+    {
+        // bodies fall and keep walking after each resolve
+        for (int i = 0; i < bodies.Size(); ++i)
+        {
+            bodies.dy[i] = std::min(bodies.dy[i] + 1, 12);
+            if (bodies.dx[i] == 0)
+            {
+                bodies.dx[i] = (i & 1) ? 4 : -4;
+            }
+        }
+        world.Resolve(terrain, bodies);
+    }
+    char name[64];
+    std::snprintf(name, sizeof(name), "%5d bodies, %-10s, per tick", initial.Size(),
+                  world.GetExecution() == CollisionWorld::Execution::Inline ? "inline" : "job system");
+    bench::Report(name, sw.ElapsedMs() / ticks, initial.Size());
+    return Hash(bodies);
+}
+
+int main()
+{
+    std::mt19937 rng(30);
+    auto ts = bench::BuildTileSet(rng);
+    CollisionBitmap terrain(bench::BuildLayer(ts, rng));
+
+    std::printf("job system: %d threads\n", JobSystem::Instance().WorkerCount() + 1);
+    CollisionWorld single(CollisionWorld::Execution::Inline);
+    CollisionWorld multi(CollisionWorld::Execution::JobSystem);
+
+    int mismatches = 0;
+    const int counts[] = {1, 10, 100, 1000, 10000};
+    for (int count : counts)
+    {
+        BodyBatch bodies = BuildBodies(terrain, count, rng);
+        const int ticks = std::max(10, 100000 / count);
+        uint64_t h1 = Run(terrain, single, bodies, ticks);
+        uint64_t h2 = Run(terrain, multi, bodies, ticks);
+        mismatches += h1 != h2;
+    }
+
+    if (mismatches != 0)
+    {
+        std::printf("results depend on where the bodies are resolved\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
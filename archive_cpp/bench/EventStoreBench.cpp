@@ -0,0 +1,141 @@
+// Updates and renders 5k animated pickups stored in the EventStore and,
+// for comparison, as individually allocated objects with virtual methods
+// (the layout the events used before).
+
+#include "BenchUtils.h"
+#include "game/EventStore.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+class LegacyEvent
+{
+public:
+    virtual ~LegacyEvent() { }
+    virtual void Update(const time_point& now) = 0;
+    virtual void Render(Surface& screen, const WorldTransformations& tr) = 0;
+};
+
+class LegacyPickup : public LegacyEvent
+{
+public:
+    LegacyPickup(const Animation& a, const Point2D& p)
+        : animation(a)
+        , position(p)
+    { }
+    virtual void Update(const time_point& now) override
+    {
+        animation.Update(now);
+    }
+    virtual void Render(Surface& screen, const WorldTransformations& tr) override
+    {
+        const Surface& s = animation.GetCurrentFrame();
+        Point2D p = tr.FromUniverseToScreen(position);
+        screen.Draw(s, NormalizeToDisplay(s, {p.x, p.y, 32, 32}));
+    }
+private:
+    Animation   animation;
+    std::string message;
+    Point2D     position;
+};
+
+}
+
+int main()
+{
+    constexpr int pickupCount = 5000;
+    constexpr int updateTicks = 1000;
+    constexpr int renderFrames = 20;
+
+    Animation anim(10);
+    for (int i = 0; i < 8; ++i)
+    {
+        anim.PushFrame(std::make_shared<Surface>(24, 24));
+    }
+    anim.SetStrategy(AnimationStrategy::Normal);
+
+    std::mt19937 rng(34);
+    std::uniform_int_distribution<int> x(0, 640 - 32);
+    std::uniform_int_distribution<int> y(0, 480 - 32);
+    std::vector<Point2D> positions(pickupCount);
+    for (auto& p : positions)
+    {
+        p = {x(rng), y(rng)};
+    }
+
+    EventStore store;
+    int animId = store.AddAnimation(anim);
+    std::vector<int> all(pickupCount);
+    for (int i = 0; i < pickupCount; ++i)
+    {
+        all[i] = store.Add(EventType::Bonus, 0, positions[i]);
+        store.SetAnimation(all[i], animId);
+    }
+    store.SortByType();
+
+    // interleave the objects with other allocations, as during level loading
+    std::vector<std::unique_ptr<LegacyEvent>> legacy;
+    std::vector<std::unique_ptr<char[]>> noise;
+    for (int i = 0; i < pickupCount; ++i)
+    {
+        legacy.emplace_back(new LegacyPickup(anim, positions[i]));
+        noise.emplace_back(new char[64 + rng() % 512]);
+    }
+    std::shuffle(legacy.begin(), legacy.end(), rng);
+
+    Surface screen(640, 480);
+    WorldTransformations tr;
+    tr.SetUniverseSize(640, 480);
+    tr.SetScreenSize(640, 480);
+    tr.SetCameraPositionInUniverse({0, 0}, PositionAnchor::LeftTop);
+
+    time_point now = GameClock::now();
+    bench::Stopwatch sw;
+    for (int t = 0; t < updateTicks; ++t)
+    {
+        now += miliseconds(16);
+        store.Update(now, all);
+    }
+    bench::Report("5k pickups, EventStore update", sw.ElapsedMs() / updateTicks, pickupCount);
+
+    sw.Restart();
+    for (int t = 0; t < updateTicks; ++t)
+    {
+        now += miliseconds(16);
+        for (auto& e : legacy)
+        {
+            e->Update(now);
+        }
+    }
+    bench::Report("5k pickups, virtual objects update", sw.ElapsedMs() / updateTicks, pickupCount);
+
+    RenderQueue queue;
+    RenderSnapshot snapshot;
+    sw.Restart();
+    for (int f = 0; f < renderFrames; ++f)
+    {
+        queue.Begin({0, 0, screen.getWidth(), screen.getHeight()});
+        snapshot.Clear();
+        store.Capture(snapshot, all, 0);
+        snapshot.Submit(queue, tr);
+        queue.Submit(screen);
+    }
+    bench::Report("5k pickups, EventStore render", sw.ElapsedMs() / renderFrames, pickupCount);
+
+    sw.Restart();
+    for (int f = 0; f < renderFrames; ++f)
+    {
+        for (auto& e : legacy)
+        {
+            e->Render(screen, tr);
+        }
+    }
+    bench::Report("5k pickups, virtual objects render", sw.ElapsedMs() / renderFrames, pickupCount);
+
+    return EXIT_SUCCESS;
+}
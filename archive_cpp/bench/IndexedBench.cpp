@@ -0,0 +1,134 @@
+// Renders three parallax tile layers, once as RGBA tiles through the
+// RenderQueue and once composited in 8 bit and resolved through the palette.
+// A palette fade runs in the indexed case: it only rebuilds the
+// NativePalette, the RGBA tiles would have to be converted again.
+
+#include "BenchUtils.h"
+#include "game/Layer.h"
+#include "gfx/IndexedSurface.h"
+#include "gfx/RenderQueue.h"
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+int main()
+{
+    constexpr int widthInTiles = 256;
+    constexpr int heightInTiles = 64;
+    constexpr int tileCount = 16;
+    constexpr int layerCount = 3;
+    constexpr int frames = 50;
+
+    std::mt19937 rng(38);
+    Palette palette;
+    for (int i = 0; i < 256; ++i)
+    {
+        palette.colors[i] = Color32(rng() & 0xff, rng() & 0xff, rng() & 0xff);
+    }
+
+    // the same tiles in both formats, about half of the pixels transparent
+    auto ts = std::make_shared<TileSet>(tileCount);
+    for (int i = 0; i < tileCount; ++i)
+    {
+        auto image = std::make_shared<Surface>(32, 32);
+        auto indexed = std::make_shared<IndexedSurface>(32, 32);
+        for (int y = 0; y < 32; ++y)
+        {
+            for (int x = 0; x < 32; ++x)
+            {
+                uint8_t index = (i == 0 || (x + y + i) % 4 < 2) ? IndexedSurface::transparent
+                                                                : static_cast<uint8_t>(1 + rng() % 255);
+                indexed->PutPixel(x, y, index);
+                image->PutPixel(x, y, index == IndexedSurface::transparent ? Color32(0, 0, 0, 0) : palette.colors[index]);
+            }
+        }
+        char mask[TileSet::collisionMaskSize] = {};
+        ts->AddTile(image, image, mask, mask);
+        ts->SetIndexedImages(static_cast<TileId>(i), indexed, indexed);
+    }
+    std::vector<Layer> layers;
+    for (int l = 0; l < layerCount; ++l)
+    {
+        layers.emplace_back(widthInTiles, heightInTiles, true, false, false, false, ts);
+        for (int ty = 0; ty < heightInTiles; ++ty)
+        {
+            for (int tx = 0; tx < widthInTiles; ++tx)
+            {
+                layers.back().SetTile(tx, ty, static_cast<TileId>(rng() % tileCount), false);
+            }
+        }
+    }
+
+    constexpr int worldWidth = widthInTiles * TileCoordinates::tileWidth;
+    constexpr int worldHeight = heightInTiles * TileCoordinates::tileHeight;
+    Surface screen(640, 480);
+    WorldTransformations tr;
+    tr.SetUniverseSize(worldWidth, worldHeight);
+    tr.SetScreenSize(screen.getWidth(), screen.getHeight());
+    auto moveCamera = [&](int f)
+    {
+        tr.SetCameraPositionInUniverse({(f * 97) % (worldWidth - 640), (f * 31) % (worldHeight - 480)},
+                                       PositionAnchor::LeftTop);
+    };
+
+    bench::Stopwatch sw;
+    RenderQueue queue;
+    for (int f = 0; f < frames; ++f)
+    {
+        moveCamera(f);
+        queue.Begin({0, 0, screen.getWidth(), screen.getHeight()});
+        for (int l = 0; l < layerCount; ++l)
+        {
+            layers[l].Render(queue, tr, static_cast<uint8_t>(l));
+        }
+        queue.Submit(screen);
+    }
+    bench::Report("RGBA tiles through the render queue", sw.ElapsedMs() / frames, 1);
+
+    IndexedSurface frame(screen.getWidth(), screen.getHeight());
+    sw.Restart();
+    for (int f = 0; f < frames; ++f)
+    {
+        moveCamera(f);
+        frame.Fill(IndexedSurface::transparent);
+        for (int l = 0; l < layerCount; ++l)
+        {
+            layers[l].Render(frame, tr);
+        }
+        frame.Resolve(NativePalette(palette, screen), screen);
+    }
+    bench::Report("indexed compositing + resolve", sw.ElapsedMs() / frames, 1);
+
+    // fade to black, the frame stays the same
+    sw.Restart();
+    for (int f = 0; f < frames; ++f)
+    {
+        Palette faded;
+        for (int i = 0; i < 256; ++i)
+        {
+            const Color32& c = palette.colors[i];
+            int k = frames - f;
+            faded.colors[i] = Color32(c.GetR() * k / frames, c.GetG() * k / frames, c.GetB() * k / frames);
+        }
+        frame.Resolve(NativePalette(faded, screen), screen);
+    }
+    bench::Report("palette fade (resolve only)", sw.ElapsedMs() / frames, 1);
+
+    // identical output on every code path (scalar, AVX2)
+    frame.Resolve(NativePalette(palette, screen), screen);
+    int pitch = 0;
+    const uint32_t* pixels = screen.LockPixels(pitch);
+    uint32_t hash = 2166136261u;
+    for (int y = 0; y < screen.getHeight(); ++y)
+    {
+        for (int x = 0; x < screen.getWidth(); ++x)
+        {
+            hash = (hash ^ pixels[y * pitch + x]) * 16777619u;
+        }
+    }
+    screen.UnlockPixels();
+    std::printf("resolved frame hash: %08x\n", hash);
+    return EXIT_SUCCESS;
+}
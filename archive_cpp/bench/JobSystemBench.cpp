@@ -0,0 +1,180 @@
+// Scheduling overhead: a batch of small tasks (summing a slice of an
+// array) run with a std::thread per task, submitted one by one to the
+// JobSystem and waited for, and through JobSystem::ParallelFor, with three
+// workers plus the waiting thread. A second part chains stages through
+// SubmitAfter. Every result is checked against a serial sum.
+
+#include "BenchUtils.h"
+#include "utils/JobSystem.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int taskCount = 2000;
+constexpr int sliceSize = 512;
+
+struct Batch
+{
+    std::vector<uint32_t>   values;
+    std::vector<uint64_t>   sums;
+
+    void SumSlices(int first, int last)
+    {
+        for (int t = first; t < last; ++t)
+        {
+            uint64_t sum = 0;
+            for (int i = t * sliceSize; i < (t + 1) * sliceSize; ++i)
+            {
+                sum += values[i];
+            }
+            sums[t] = sum;
+        }
+    }
+    uint64_t Total() const { return std::accumulate(sums.begin(), sums.end(), uint64_t{0}); }
+};
+
+void RunSlice(Job& job)
+{
+    static_cast<Batch*>(const_cast<void*>(job.data))->SumSlices(job.begin, job.end);
+}
+
+// each stage doubles what the one before it left in value
+struct Stage
+{
+    uint64_t*   value;
+};
+
+void RunStage(Job& job)
+{
+    *static_cast<const Stage*>(job.data)->value *= 2;
+}
+
+}
+
+int main()
+{
+    constexpr int rounds = 20;
+
+    std::mt19937 rng(43);
+    Batch batch;
+    batch.values.resize(taskCount * sliceSize);
+    for (auto& v : batch.values)
+    {
+        v = rng() & 0xffff;
+    }
+    batch.sums.resize(taskCount);
+    batch.SumSlices(0, taskCount);
+    const uint64_t expected = batch.Total();
+    bool correct = true;
+
+    bench::Stopwatch sw;
+    for (int r = 0; r < rounds; ++r)
+    {
+        std::fill(batch.sums.begin(), batch.sums.end(), 0);
+        batch.SumSlices(0, taskCount);
+        correct = correct && batch.Total() == expected;
+    }
+    bench::Report("serial", sw.ElapsedMs() / rounds, taskCount);
+
+    sw.Restart();
+    for (int r = 0; r < rounds; ++r)
+    {
+        std::fill(batch.sums.begin(), batch.sums.end(), 0);
+        std::vector<std::thread> threads;
+        threads.reserve(taskCount);
+        for (int t = 0; t < taskCount; ++t)
+        {
+            threads.emplace_back([&batch, t]() { batch.SumSlices(t, t + 1); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        correct = correct && batch.Total() == expected;
+    }
+    bench::Report("std::thread per task", sw.ElapsedMs() / rounds, taskCount);
+
+    JobSystem jobs(3);
+    std::vector<Job> slices(taskCount);
+    sw.Restart();
+    for (int r = 0; r < rounds; ++r)
+    {
+        std::fill(batch.sums.begin(), batch.sums.end(), 0);
+        JobCounter counter;
+        for (int t = 0; t < taskCount; ++t)
+        {
+            slices[t].function = &RunSlice;
+            slices[t].data = &batch;
+            slices[t].begin = t;
+            slices[t].end = t + 1;
+            jobs.Submit(slices[t], counter);
+        }
+        jobs.Wait(counter);
+        correct = correct && batch.Total() == expected;
+    }
+    bench::Report("JobSystem, a job per task", sw.ElapsedMs() / rounds, taskCount);
+
+    sw.Restart();
+    for (int r = 0; r < rounds; ++r)
+    {
+        std::fill(batch.sums.begin(), batch.sums.end(), 0);
+        jobs.ParallelFor(0, taskCount, 16, [&batch](int first, int last) { batch.SumSlices(first, last); });
+        correct = correct && batch.Total() == expected;
+    }
+    bench::Report("JobSystem::ParallelFor", sw.ElapsedMs() / rounds, taskCount);
+
+    // nested: a ParallelFor inside jobs, the outer jobs wait without blocking a worker
+    sw.Restart();
+    for (int r = 0; r < rounds; ++r)
+    {
+        std::fill(batch.sums.begin(), batch.sums.end(), 0);
+        jobs.ParallelFor(0, 4, 1, [&](int first, int last)
+        {
+            for (int q = first; q < last; ++q)
+            {
+                jobs.ParallelFor(q * taskCount / 4, (q + 1) * taskCount / 4, 16,
+                                 [&batch](int a, int b) { batch.SumSlices(a, b); });
+            }
+        });
+        correct = correct && batch.Total() == expected;
+    }
+    bench::Report("JobSystem::ParallelFor, nested", sw.ElapsedMs() / rounds, taskCount);
+
+    // dependencies: stage s runs only after stage s - 1, so value ends as 2^stages
+    constexpr int stageCount = 32;
+    std::vector<Job> stageJobs(stageCount);
+    std::vector<Stage> stages(stageCount);
+    sw.Restart();
+    for (int r = 0; r < rounds; ++r)
+    {
+        uint64_t value = 1;
+        std::vector<JobCounter> done(stageCount);
+        for (int s = 0; s < stageCount; ++s)
+        {
+            stages[s].value = &value;
+            stageJobs[s].function = &RunStage;
+            stageJobs[s].data = &stages[s];
+            if (s == 0)
+            {
+                jobs.Submit(stageJobs[s], done[s]);
+            }
+            else
+            {
+                jobs.SubmitAfter(done[s - 1], stageJobs[s], done[s]);
+            }
+        }
+        jobs.Wait(done[stageCount - 1]);
+        correct = correct && value == (uint64_t{1} << stageCount);
+    }
+    bench::Report("JobSystem, chain of dependent jobs", sw.ElapsedMs() / rounds, stageCount);
+
+    std::printf("hardware threads: %u, results %s\n", std::thread::hardware_concurrency(),
+                correct ? "correct" : "WRONG");
+    return correct ? EXIT_SUCCESS : EXIT_FAILURE;
+}
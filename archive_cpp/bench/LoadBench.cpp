@@ -0,0 +1,230 @@
+// Load path throughput on generated files: a 4096 tile TSF tile set and an
+// animation file are written once, then levels of growing size. Per level
+// the zlib streams are inflated on their own, the file is parsed by
+// Jazz2LevelFormat, and ResourceFactory::LoadLevel runs twice, the first
+// time parsing and converting, the second time converting only (the parsed
+// level is cached). Every file is read back and checked against what was
+// written. With a directory argument the files are written there and
+// kept, usable with OpenJazz --media.
+
+#include "BenchUtils.h"
+#include "SyntheticAssets.h"
+#include "data/ResourceFactory.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+
+constexpr int tileCount = 4096;
+const char tileSetFile[] = "Synthetic.j2t";
+
+std::vector<char> ReadWholeFile(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// inflates the four streams of a J2L file, returns the inflated size
+size_t InflateLevel(const std::vector<char>& file)
+{
+    // compressed and uncompressed sizes of the four streams
+    constexpr size_t sizesOffset = 230;
+    constexpr size_t dataOffset = 262;
+    int32_t sizes[8];
+    std::memcpy(sizes, &file[sizesOffset], sizeof(sizes));
+    size_t offset = dataOffset;
+    size_t total = 0;
+    std::vector<unsigned char> out;
+    for (int s = 0; s < 4; ++s)
+    {
+        uLongf length = static_cast<uLongf>(sizes[2 * s + 1]);
+        out.resize(length);
+        if (::uncompress(out.data(), &length, reinterpret_cast<const Bytef*>(&file[offset]),
+                         static_cast<uLong>(sizes[2 * s])) != Z_OK)
+        {
+            throw std::runtime_error("inflating a level stream failed");
+        }
+        offset += sizes[2 * s];
+        total += length;
+    }
+    return total;
+}
+
+size_t FileSize(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+    return static_cast<size_t>(file.tellg());
+}
+
+bool SameLayers(const J2LevelContent& written, const Jazz2LevelFormat& read)
+{
+    const auto& layers = read.getLayers();
+    if (layers.size() != written.layers.size())
+    {
+        return false;
+    }
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+        const J2Layer& a = written.layers[l];
+        const J2Layer& b = layers[l];
+        if (a.width != b.width || a.height != b.height || a.tileX != b.tileX || a.tileY != b.tileY)
+        {
+            return false;
+        }
+        if (a.grid.size() != b.grid.size())
+        {
+            return false;
+        }
+        for (size_t t = 0; t < a.grid.size(); ++t)
+        {
+            if (a.grid[t].id != b.grid[t].id || a.grid[t].flipped != b.grid[t].flipped ||
+                a.grid[t].x != b.grid[t].x || a.grid[t].y != b.grid[t].y)
+            {
+                return false;
+            }
+        }
+    }
+    // the reader has an event for every tile of the action layer, most are empty
+    size_t events = 0;
+    for (const auto& e : read.getEvents())
+    {
+        events += e.EventId != 0;
+    }
+    return events == written.events.size();
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::string dir;
+    const bool keep = argc > 1;
+    if (keep)
+    {
+        dir = argv[1];
+    }
+    else
+    {
+        char name[] = "/tmp/LoadBenchXXXXXX";
+        if (mkdtemp(name) == nullptr)
+        {
+            std::perror("mkdtemp");
+            return EXIT_FAILURE;
+        }
+        dir = name;
+    }
+    if (dir.back() != '/')
+    {
+        dir += '/';
+    }
+
+    bool correct = true;
+    std::vector<std::string> written;
+    auto path = [&dir](const std::string& name) { return dir + name; };
+
+    bench::Stopwatch sw;
+    const J2TileSetContent tileSet = bench::SyntheticTileSet(tileCount, 45);
+    Jazz2TileFormat::Write(path(tileSetFile), tileSet);
+    written.push_back(tileSetFile);
+    bench::Report("write tile set, tiles", sw.ElapsedMs(), tileCount);
+
+    sw.Restart();
+    {
+        Jazz2TileFormat tiles(path(tileSetFile));
+        correct = correct && tiles.GetTileSet().size() == static_cast<size_t>(tileCount);
+    }
+    bench::Report("load tile set (inflate, convert), tiles", sw.ElapsedMs(), tileCount);
+
+    // the level builder and the hero look up sets up to 99, animations up to 92
+    constexpr int setCount = 110;
+    constexpr int animationsPerSet = 100;
+    sw.Restart();
+    Jazz2AnimFormat::Write(path("Anims.j2a"), bench::SyntheticAnimSets(setCount, animationsPerSet, 2, 32, 45));
+    written.push_back("Anims.j2a");
+    bench::Report("write animations, animations", sw.ElapsedMs(), setCount * animationsPerSet);
+
+    sw.Restart();
+    {
+        Jazz2AnimFormat anims(path("Anims.j2a"));
+        correct = correct && anims.GetAnimationSetLength() == static_cast<unsigned>(setCount) &&
+                  anims.GetAnimationLength(setCount - 1) == static_cast<unsigned>(animationsPerSet);
+    }
+    bench::Report("load animations, animations", sw.ElapsedMs(), setCount * animationsPerSet);
+
+    // a small level first, so the tile set and animations are cached when
+    // the timed levels load
+    const J2LevelContent warmUp = bench::SyntheticLevel("Warm up", tileSetFile, tileCount, 64, 32, 0.02, 1);
+    Jazz2LevelFormat::Write(path("WarmUp.j2l"), warmUp);
+    written.push_back("WarmUp.j2l");
+    ResourceFactory& factory = ResourceFactory::GetInstance();
+    factory.SetResourcePath(dir);
+    factory.LoadLevel("WarmUp.j2l");
+
+    for (int scale : {1, 4, 16, 64})
+    {
+        const int width = 256 * (scale >= 16 ? scale / 4 : scale);
+        const int height = 64 * (scale >= 16 ? 4 : 1);
+        const int tiles = width * height;
+        const std::string name = "Synthetic" + std::to_string(scale) + ".j2l";
+        const J2LevelContent level = bench::SyntheticLevel(name, tileSetFile, tileCount, width, height, 0.02,
+                                                           static_cast<uint32_t>(scale));
+        Jazz2LevelFormat::Write(path(name), level);
+        written.push_back(name);
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%dx%d, %zu KB", width, height, FileSize(path(name)) / 1024);
+        std::printf("%s\n", label);
+
+        constexpr int rounds = 3;
+        const std::vector<char> file = ReadWholeFile(path(name));
+        sw.Restart();
+        for (int r = 0; r < rounds; ++r)
+        {
+            correct = InflateLevel(file) > 0 && correct;
+        }
+        bench::Report("  inflate, tiles", sw.ElapsedMs() / rounds, tiles);
+
+        sw.Restart();
+        for (int r = 0; r < rounds; ++r)
+        {
+            Jazz2LevelFormat parsed(path(name));
+            correct = SameLayers(level, parsed) && correct;
+        }
+        bench::Report("  parse (read, inflate, decode), tiles", sw.ElapsedMs() / rounds, tiles);
+
+        sw.Restart();
+        LevelPtr loaded = factory.LoadLevel(name);
+        bench::Report("  LoadLevel, tiles", sw.ElapsedMs(), tiles);
+        correct = correct && loaded->GetUniverseSize().w == width * 32 &&
+                  loaded->GetUniverseSize().h == height * 32;
+        loaded.reset();
+
+        sw.Restart();
+        for (int r = 0; r < rounds; ++r)
+        {
+            loaded = factory.LoadLevel(name);
+        }
+        bench::Report("  LoadLevel, parsed level cached, tiles", sw.ElapsedMs() / rounds, tiles);
+    }
+
+    if (!keep)
+    {
+        for (const auto& name : written)
+        {
+            std::remove(path(name).c_str());
+        }
+        rmdir(dir.c_str());
+    }
+
+    std::printf("results %s\n", correct ? "correct" : "WRONG");
+    return correct ? EXIT_SUCCESS : EXIT_FAILURE;
+}
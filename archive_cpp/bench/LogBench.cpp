@@ -0,0 +1,116 @@
+// Cost of a log statement on the calling thread: the asynchronous
+// MicroLogger against the previous design, which pushed every character
+// through a virtual call to each writer synchronously. Both write to
+// /dev/null; lines are logged in bursts, as a frame would.
+
+#include "BenchUtils.h"
+#include "utils/MicroLogger.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class LegacyWriter
+{
+public:
+    virtual ~LegacyWriter() { }
+    virtual void Write(char c) = 0;
+    virtual void Write(double d) = 0;
+    virtual void Write(int i) = 0;
+};
+
+class LegacyFileWriter : public LegacyWriter
+{
+public:
+    LegacyFileWriter()
+        : out("/dev/null")
+    { }
+    virtual void Write(char c) override { out << c; }
+    virtual void Write(double d) override { out << d; }
+    virtual void Write(int i) override { out << i; }
+private:
+    std::ofstream out;
+};
+
+class LegacyLogger
+{
+public:
+    std::vector<std::unique_ptr<LegacyWriter>> writers;
+
+    template <typename T>
+    void Write(T v)
+    {
+        for (auto& w : writers)
+        {
+            w->Write(v);
+        }
+    }
+    void Write(const char* s)
+    {
+        while (*s)
+        {
+            Write(*s++);
+        }
+    }
+};
+
+}
+
+int main()
+{
+    constexpr int bursts = 200;
+    constexpr int linesPerBurst = 200;
+
+    LegacyLogger legacy;
+    legacy.writers.emplace_back(new LegacyFileWriter());
+    legacy.writers.emplace_back(new LegacyFileWriter());
+    bench::Stopwatch sw;
+    double ms = 0;
+    for (int b = 0; b < bursts; ++b)
+    {
+        sw.Restart();
+        for (int i = 0; i < linesPerBurst; ++i)
+        {
+            legacy.Write("Frame ");
+            legacy.Write(b * linesPerBurst + i);
+            legacy.Write(" resolved in ");
+            legacy.Write(1.25);
+            legacy.Write(" ms\n");
+        }
+        ms += sw.ElapsedMs();
+    }
+    bench::Report("synchronous per character", ms / (bursts * linesPerBurst), 1);
+
+    LOG.AppendWriter(std::unique_ptr<ILogWriter>{new FileWriter("/dev/null")});
+    LOG.AppendWriter(std::unique_ptr<ILogWriter>{new FileWriter("/dev/null")});
+    ms = 0;
+    for (int b = 0; b < bursts; ++b)
+    {
+        sw.Restart();
+        for (int i = 0; i < linesPerBurst; ++i)
+        {
+            LOG << "Frame " << b * linesPerBurst + i << " resolved in " << 1.25 << " ms\n";
+        }
+        ms += sw.ElapsedMs();
+        // the rest of the frame, the flush thread gets the core
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bench::Report("asynchronous ring buffer", ms / (bursts * linesPerBurst), 1);
+
+    sw.Restart();
+    for (int i = 0; i < bursts * linesPerBurst; ++i)
+    {
+        LOG_DEBUG << "Frame " << i << " resolved in " << 1.25 << " ms\n";
+    }
+    bench::Report(OPENJAZZ_LOG_LEVEL > OPENJAZZ_LOG_DEBUG ? "LOG_DEBUG (compiled out)" : "LOG_DEBUG (enabled)",
+                  sw.ElapsedMs() / (bursts * linesPerBurst), 1);
+    LOG.Flush();
+    std::printf("dropped records: %llu\n", static_cast<unsigned long long>(LOG.GetDroppedCount()));
+    return EXIT_SUCCESS;
+}
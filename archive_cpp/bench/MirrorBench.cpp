@@ -0,0 +1,104 @@
+// Flipped sprites: a pre-mirrored copy of every frame made with
+// Surface::Copy (rotozoom, as Animation::SetUpMirroredFrames did) against
+// Surface::DrawMirrored, which reads the rows backwards at blit time.
+// Reports the load cost, the memory of the copies and the draw cost, and
+// checks DrawMirrored against an exact mirror image drawn with Draw.
+
+#include "BenchUtils.h"
+#include "gfx/Surface.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+uint32_t Hash(Surface& s)
+{
+    int pitch = 0;
+    const uint32_t* pixels = s.LockPixels(pitch);
+    uint32_t hash = 2166136261u;
+    for (int y = 0; y < s.getHeight(); ++y)
+    {
+        for (int x = 0; x < s.getWidth(); ++x)
+        {
+            hash = (hash ^ pixels[y * pitch + x]) * 16777619u;
+        }
+    }
+    s.UnlockPixels();
+    return hash;
+}
+
+}
+
+int main()
+{
+    // about the hero: a few hundred frames, translucent edges
+    constexpr int frameCount = 400;
+    constexpr int frameWidth = 48;
+    constexpr int frameHeight = 48;
+    constexpr int draws = 20000;
+
+    std::mt19937 rng(39);
+    std::vector<std::unique_ptr<Surface>> frames;
+    std::vector<std::unique_ptr<Surface>> exact;
+    for (int i = 0; i < frameCount; ++i)
+    {
+        frames.emplace_back(new Surface(frameWidth, frameHeight));
+        exact.emplace_back(new Surface(frameWidth, frameHeight));
+        for (int y = 0; y < frameHeight; ++y)
+        {
+            for (int x = 0; x < frameWidth; ++x)
+            {
+                int a = (x + y) % 5 == 0 ? 0 : ((x * y) % 7 == 0 ? 128 : 255);
+                Color32 c(rng() & 0xff, rng() & 0xff, rng() & 0xff, a);
+                frames.back()->PutPixel(x, y, c);
+                exact.back()->PutPixel(frameWidth - 1 - x, y, c);
+            }
+        }
+    }
+
+    bench::Stopwatch sw;
+    SurfaceCopyEffects eff;
+    eff.flipVertically = true;
+    std::vector<std::unique_ptr<Surface>> mirrored;
+    for (const auto& f : frames)
+    {
+        mirrored.emplace_back(new Surface(f->Copy(eff)));
+    }
+    bench::Report("load: pre-mirrored copies", sw.ElapsedMs(), frameCount);
+    std::printf("%-48s %10.1f KiB\n", "memory of the copies", frameCount * frameWidth * frameHeight * 4 / 1024.0);
+    bench::Report("load: DrawMirrored (nothing to do)", 0, 0);
+
+    Surface screen(640, 480, false);
+    auto position = [](int i) { return (i * 37) % (640 - frameWidth); };
+    sw.Restart();
+    for (int i = 0; i < draws; ++i)
+    {
+        screen.Draw(*mirrored[i % frameCount], position(i), (i * 11) % (480 - frameHeight));
+    }
+    bench::Report("draw: pre-mirrored copy", sw.ElapsedMs(), draws);
+
+    sw.Restart();
+    for (int i = 0; i < draws; ++i)
+    {
+        screen.DrawMirrored(*frames[i % frameCount], position(i), (i * 11) % (480 - frameHeight));
+    }
+    bench::Report("draw: DrawMirrored", sw.ElapsedMs(), draws);
+
+    // pixel exactness, clipped at every edge too
+    Surface a(640, 480, false);
+    Surface b(640, 480, false);
+    const int xs[] = {-20, 0, 100, 620};
+    const int ys[] = {-30, 0, 200, 460};
+    for (int i = 0; i < 4; ++i)
+    {
+        a.Draw(*exact[i], xs[i], ys[i]);
+        b.DrawMirrored(*frames[i], xs[i], ys[i]);
+    }
+    bool same = Hash(a) == Hash(b);
+    std::printf("DrawMirrored matches the exact mirror image: %s\n", same ? "yes" : "NO");
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,161 @@
+// The same frames (three tile layers, 2000 sprites, some mirrored, text and
+// pixels, all through the RenderQueue) drawn headless by both render
+// backends: the surface blitter and SDL_Renderer with textures on SDL's
+// software renderer. Reports the time per frame, the texture uploads and
+// how many pixels of the last frame differ between the two.
+
+#include "BenchUtils.h"
+#include "game/Layer.h"
+#include "gfx/RenderQueue.h"
+#include "gfx/SurfaceBackend.h"
+#include "gfx/TextureBackend.h"
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Scene
+{
+    std::vector<Layer>                      layers;
+    std::vector<std::unique_ptr<Surface>>   sprites;
+    std::vector<Point2D>                    positions;
+    TextRun                                 text;
+};
+
+void DrawFrame(Scene& scene, RenderQueue& queue, IRenderBackend& backend, int f)
+{
+    WorldTransformations tr;
+    tr.SetUniverseSize(scene.layers[0].GetWidth() * TileCoordinates::tileWidth,
+                       scene.layers[0].GetHeight() * TileCoordinates::tileHeight);
+    tr.SetScreenSize(backend.Width(), backend.Height());
+    tr.SetCameraPositionInUniverse({f * 13, f * 5}, PositionAnchor::LeftTop);
+
+    backend.BeginFrame();
+    queue.Begin({0, 0, backend.Width(), backend.Height()});
+    for (size_t l = 0; l < scene.layers.size(); ++l)
+    {
+        scene.layers[l].Render(queue, tr, static_cast<uint8_t>(l));
+    }
+    for (size_t i = 0; i < scene.positions.size(); ++i)
+    {
+        const Surface& s = *scene.sprites[i % scene.sprites.size()];
+        int x = (scene.positions[i].x + f * 3) % backend.Width();
+        int y = scene.positions[i].y;
+        if (i % 2 == 0)
+        {
+            queue.PushSprite(10, s, x, y);
+        }
+        else
+        {
+            queue.PushSpriteMirrored(10, s, x, y);
+        }
+        queue.PushPixel(11, x, y, {255, 255, 255});
+    }
+    queue.PushText(12, scene.text, 300, 45);
+    queue.Submit(backend);
+    backend.Present();
+}
+
+}
+
+int main()
+{
+    constexpr int frames = 60;
+    constexpr int width = 640;
+    constexpr int height = 480;
+
+    std::mt19937 rng(41);
+    Scene scene;
+    auto ts = std::make_shared<TileSet>(16);
+    for (int i = 0; i < 16; ++i)
+    {
+        auto image = std::make_shared<Surface>(32, 32);
+        for (int y = 0; y < 32; ++y)
+        {
+            for (int x = 0; x < 32; ++x)
+            {
+                image->PutPixel(x, y, Color32(rng() & 0xff, rng() & 0xff, rng() & 0xff, (x ^ y) % 3 ? 255 : 0));
+            }
+        }
+        char mask[TileSet::collisionMaskSize] = {};
+        ts->AddTile(image, image, mask, mask);
+    }
+    for (int l = 0; l < 3; ++l)
+    {
+        scene.layers.emplace_back(128, 64, true, false, false, false, ts);
+        for (int ty = 0; ty < 64; ++ty)
+        {
+            for (int tx = 0; tx < 128; ++tx)
+            {
+                scene.layers.back().SetTile(tx, ty, static_cast<TileId>(rng() % 16), false);
+            }
+        }
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        scene.sprites.emplace_back(new Surface(24, 32));
+        for (int y = 0; y < 32; ++y)
+        {
+            for (int x = 0; x < 24; ++x)
+            {
+                scene.sprites.back()->PutPixel(x, y, Color32(rng() & 0xff, rng() & 0xff, rng() & 0xff, x < 12 ? 255 : 0));
+            }
+        }
+    }
+    for (int i = 0; i < 2000; ++i)
+    {
+        scene.positions.push_back({static_cast<int>(rng() % width), static_cast<int>(rng() % (height - 32))});
+    }
+    scene.text.Set("Draw calls", {255, 255, 255, 160});
+
+    RenderQueue queue;
+    Surface a(width, height, false);
+    SurfaceBackend surfaceBackend(a);
+    bench::Stopwatch sw;
+    for (int f = 0; f < frames; ++f)
+    {
+        DrawFrame(scene, queue, surfaceBackend, f);
+    }
+    char name[96];
+    std::snprintf(name, sizeof(name), "surface backend (%d draw calls/frame)", queue.GetStats().drawCalls);
+    bench::Report(name, sw.ElapsedMs() / frames, 1);
+
+    Surface b(width, height, false);
+    TextureBackend textureBackend(b);
+    sw.Restart();
+    DrawFrame(scene, queue, textureBackend, 0);
+    bench::Report("texture backend, first frame", sw.ElapsedMs(), 1);
+    int firstUploads = textureBackend.GetUploadCount();
+    sw.Restart();
+    for (int f = 1; f < frames; ++f)
+    {
+        DrawFrame(scene, queue, textureBackend, f);
+    }
+    std::snprintf(name, sizeof(name), "texture backend (%d batches/frame)", queue.GetStats().batches);
+    bench::Report(name, sw.ElapsedMs() / (frames - 1), 1);
+    std::printf("textures: %d uploaded on the first frame, %d on the next %d frames\n",
+                firstUploads, textureBackend.GetUploadCount() - firstUploads, frames - 1);
+
+    // the same frame on both, blending may round differently
+    DrawFrame(scene, queue, surfaceBackend, frames);
+    DrawFrame(scene, queue, textureBackend, frames);
+    int pitchA = 0;
+    int pitchB = 0;
+    const uint32_t* pa = a.LockPixels(pitchA);
+    const uint32_t* pb = b.LockPixels(pitchB);
+    int differing = 0;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            differing += pa[y * pitchA + x] != pb[y * pitchB + x];
+        }
+    }
+    b.UnlockPixels();
+    a.UnlockPixels();
+    std::printf("pixels differing between the backends: %d of %d\n", differing, width * height);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+// Renders a scrolling view over a tile layer and 20k sprites spread over a
+// large level: once drawing every sprite directly (clipping left to the
+// blitter, as Level::Render did before) and once through the RenderQueue
+// with the sprites culled by the broad phase grid.
+
+#include "BenchUtils.h"
+#include "game/BroadPhaseGrid.h"
+#include "game/Layer.h"
+#include "gfx/RenderQueue.h"
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+int main()
+{
+    constexpr int widthInTiles = 512;
+    constexpr int heightInTiles = 128;
+    constexpr int worldWidth = widthInTiles * TileCoordinates::tileWidth;
+    constexpr int worldHeight = heightInTiles * TileCoordinates::tileHeight;
+    constexpr int spriteCount = 20000;
+    constexpr int frames = 50;
+
+    std::mt19937 rng(35);
+    auto ts = std::make_shared<TileSet>(16);
+    for (int i = 0; i < 16; ++i)
+    {
+        char mask[TileSet::collisionMaskSize] = {};
+        ts->AddTile(std::make_shared<Surface>(32, 32), std::make_shared<Surface>(32, 32), mask, mask);
+    }
+    Layer layer(widthInTiles, heightInTiles, false, false, false, false, ts);
+    for (int ty = 0; ty < heightInTiles; ++ty)
+    {
+        for (int tx = 0; tx < widthInTiles; ++tx)
+        {
+            layer.SetTile(tx, ty, static_cast<TileId>(rng() % 4 == 0 ? 1 + rng() % 15 : 0), false);
+        }
+    }
+
+    // a few sprite images shared by many sprites, like animation frames
+    std::vector<std::unique_ptr<Surface>> images;
+    for (int i = 0; i < 8; ++i)
+    {
+        images.emplace_back(new Surface(24, 24));
+    }
+    std::uniform_int_distribution<int> x(0, worldWidth - 32);
+    std::uniform_int_distribution<int> y(0, worldHeight - 32);
+    std::vector<Point2D> positions(spriteCount);
+    std::vector<int> imageIds(spriteCount);
+    BroadPhaseGrid grid(worldWidth, worldHeight, 4 * TileCoordinates::tileWidth);
+    for (int i = 0; i < spriteCount; ++i)
+    {
+        positions[i] = {x(rng), y(rng)};
+        imageIds[i] = rng() % images.size();
+        grid.Insert({positions[i].x, positions[i].y, 32, 32}, i);
+    }
+
+    Surface screen(640, 480);
+    WorldTransformations tr;
+    tr.SetUniverseSize(worldWidth, worldHeight);
+    tr.SetScreenSize(screen.getWidth(), screen.getHeight());
+    auto cameraAt = [&](int f)
+    {
+        tr.SetCameraPositionInUniverse({(f * 97) % (worldWidth - 640), (f * 31) % (worldHeight - 480)},
+                                       PositionAnchor::LeftTop);
+        return tr.GetCameraPositionInUniverse(PositionAnchor::LeftTop);
+    };
+
+    bench::Stopwatch sw;
+    long drawn = 0;
+    for (int f = 0; f < frames; ++f)
+    {
+        Point2D origin = cameraAt(f);
+        RenderQueue tiles;
+        tiles.Begin({0, 0, screen.getWidth(), screen.getHeight()});
+        layer.Render(tiles, tr, 0);
+        tiles.Submit(screen);
+        drawn += tiles.GetStats().drawCalls;
+        for (int i = 0; i < spriteCount; ++i)
+        {
+            screen.Draw(*images[imageIds[i]], positions[i].x - origin.x, positions[i].y - origin.y);
+        }
+        drawn += spriteCount;
+    }
+    char name[96];
+    std::snprintf(name, sizeof(name), "immediate (%ld draw calls/frame)", drawn / frames);
+    bench::Report(name, sw.ElapsedMs() / frames, spriteCount);
+
+    RenderQueue queue;
+    long batches = 0;
+    long culled = 0;
+    drawn = 0;
+    sw.Restart();
+    for (int f = 0; f < frames; ++f)
+    {
+        Point2D origin = cameraAt(f);
+        queue.Begin({0, 0, screen.getWidth(), screen.getHeight()});
+        layer.Render(queue, tr, 0);
+        grid.QueryRect({origin.x, origin.y, screen.getWidth(), screen.getHeight()},
+                       [&](BroadPhaseGrid::ProxyId id)
+        {
+            int i = grid.GetUserData(id);
+            queue.PushSprite(1, *images[imageIds[i]], positions[i].x - origin.x, positions[i].y - origin.y);
+        });
+        queue.Submit(screen);
+        drawn += queue.GetStats().drawCalls;
+        batches += queue.GetStats().batches;
+        culled += queue.GetStats().culled;
+    }
+    std::snprintf(name, sizeof(name), "render queue (%ld draw calls, %ld batches/frame)",
+                  drawn / frames, batches / frames);
+    bench::Report(name, sw.ElapsedMs() / frames, spriteCount);
+    std::printf("culled by the queue: %ld/frame\n", culled / frames);
+    return EXIT_SUCCESS;
+}
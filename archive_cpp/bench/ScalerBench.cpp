@@ -0,0 +1,128 @@
+// Cost of a frame of three tile layers for a 1024x768 window: drawn at the
+// window resolution, and drawn at 1/2, 1/3 and 1/4 of it and presented
+// through UpscaleInteger. The scaler alone is compared with a per pixel
+// loop and checked against it.
+
+#include "BenchUtils.h"
+#include "game/Layer.h"
+#include "gfx/IntegerScaler.h"
+#include "gfx/RenderQueue.h"
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+void UpscaleNaive(const uint32_t* src, int srcPitch, int width, int height,
+                  uint32_t* dst, int dstPitch, int factor)
+{
+    for (int y = 0; y < height * factor; ++y)
+    {
+        for (int x = 0; x < width * factor; ++x)
+        {
+            dst[y * dstPitch + x] = src[(y / factor) * srcPitch + x / factor];
+        }
+    }
+}
+
+}
+
+int main()
+{
+    constexpr int windowWidth = 1024;
+    constexpr int windowHeight = 768;
+    constexpr int widthInTiles = 256;
+    constexpr int heightInTiles = 64;
+    constexpr int frames = 30;
+
+    std::mt19937 rng(40);
+    auto ts = std::make_shared<TileSet>(16);
+    for (int i = 0; i < 16; ++i)
+    {
+        auto image = std::make_shared<Surface>(32, 32);
+        for (int y = 0; y < 32; ++y)
+        {
+            for (int x = 0; x < 32; ++x)
+            {
+                image->PutPixel(x, y, Color32(rng() & 0xff, rng() & 0xff, rng() & 0xff, (x + y) % 3 ? 255 : 0));
+            }
+        }
+        char mask[TileSet::collisionMaskSize] = {};
+        ts->AddTile(image, image, mask, mask);
+    }
+    std::vector<Layer> layers;
+    for (int l = 0; l < 3; ++l)
+    {
+        layers.emplace_back(widthInTiles, heightInTiles, true, false, false, false, ts);
+        for (int ty = 0; ty < heightInTiles; ++ty)
+        {
+            for (int tx = 0; tx < widthInTiles; ++tx)
+            {
+                layers.back().SetTile(tx, ty, static_cast<TileId>(rng() % 16), false);
+            }
+        }
+    }
+
+    Surface window(windowWidth, windowHeight, false);
+    RenderQueue queue;
+    for (int scale = 1; scale <= 4; ++scale)
+    {
+        Surface screen(windowWidth / scale, windowHeight / scale, false);
+        WorldTransformations tr;
+        tr.SetUniverseSize(widthInTiles * 32, heightInTiles * 32);
+        tr.SetScreenSize(screen.getWidth(), screen.getHeight());
+        bench::Stopwatch sw;
+        for (int f = 0; f < frames; ++f)
+        {
+            tr.SetCameraPositionInUniverse({f * 53, f * 17}, PositionAnchor::LeftTop);
+            queue.Begin({0, 0, screen.getWidth(), screen.getHeight()});
+            for (int l = 0; l < 3; ++l)
+            {
+                layers[l].Render(queue, tr, static_cast<uint8_t>(l));
+            }
+            queue.Submit(screen);
+            if (scale > 1)
+            {
+                UpscaleInteger(screen, window, scale, 0, 0);
+            }
+        }
+        char name[96];
+        std::snprintf(name, sizeof(name), "frame at %dx%d, scale %d", screen.getWidth(), screen.getHeight(), scale);
+        bench::Report(name, sw.ElapsedMs() / frames, 1);
+    }
+
+    // the scaler alone
+    bool same = true;
+    for (int scale = 2; scale <= 4; ++scale)
+    {
+        int w = windowWidth / scale;
+        int h = windowHeight / scale;
+        std::vector<uint32_t> src(w * h);
+        for (auto& p : src)
+        {
+            p = rng();
+        }
+        std::vector<uint32_t> expected(windowWidth * windowHeight);
+        std::vector<uint32_t> actual(windowWidth * windowHeight);
+        bench::Stopwatch sw;
+        for (int f = 0; f < frames; ++f)
+        {
+            UpscaleNaive(src.data(), w, w, h, expected.data(), windowWidth, scale);
+        }
+        char name[96];
+        std::snprintf(name, sizeof(name), "%dx upscale, per pixel", scale);
+        bench::Report(name, sw.ElapsedMs() / frames, 1);
+        sw.Restart();
+        for (int f = 0; f < frames; ++f)
+        {
+            UpscaleInteger(src.data(), w, w, h, actual.data(), windowWidth, scale);
+        }
+        std::snprintf(name, sizeof(name), "%dx upscale, UpscaleInteger", scale);
+        bench::Report(name, sw.ElapsedMs() / frames, 1);
+        same = same && expected == actual;
+    }
+    std::printf("UpscaleInteger matches the per pixel loop: %s\n", same ? "yes" : "NO");
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,153 @@
+// Frame pacing with a simulation step of uneven cost (usually 2 ms, every
+// tenth step 25 ms) and a render of 4 ms: the serial loop App::Run had,
+// against a simulation thread publishing RenderSnapshots through a
+// TripleBuffer to the render loop. Reports the frames drawn, the worst
+// interval between frames and the steps simulated; every snapshot read is
+// checked to be one whole step.
+
+#include "BenchUtils.h"
+#include "game/RenderSnapshot.h"
+#include "utils/TripleBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int itemsPerSnapshot = 500;
+constexpr std::chrono::milliseconds runTime{2000};
+constexpr std::chrono::milliseconds stepPeriod{30};
+
+void Work(double ms)
+{
+    bench::Stopwatch sw;
+    while (sw.ElapsedMs() < ms)
+    { }
+}
+
+double StepCost(int step)
+{
+    return step % 10 == 9 ? 25.0 : 2.0;
+}
+
+// the camera is written first and last, a torn snapshot would mix two steps
+void Capture(RenderSnapshot& s, const Surface& sprite, int step)
+{
+    s.Clear();
+    s.camera = {step, 0};
+    for (int i = 0; i < itemsPerSnapshot; ++i)
+    {
+        s.AddSprite(1, sprite, {step, i});
+    }
+    s.camera.y = step * 7 + 1;
+}
+
+struct Result
+{
+    int frames = 0;
+    int steps = 0;
+    double worstFrameMs = 0;
+    bool consistent = true;
+};
+
+// renders what it gets, the camera tells the step it belongs to
+void Render(const RenderSnapshot& s, RenderQueue& queue, WorldTransformations& tr, Result& r)
+{
+    tr.SetCameraPositionInUniverse({0, 0}, PositionAnchor::LeftTop);
+    queue.Begin({-100000, -100000, 200000, 200000});
+    s.Submit(queue, tr);
+    r.consistent = r.consistent && static_cast<int>(s.Size()) == itemsPerSnapshot
+                   && s.camera.y == s.camera.x * 7 + 1;
+    Work(4.0);
+}
+
+void Report(const char* name, const Result& r)
+{
+    std::printf("%-30s %5d frames, worst frame %6.1f ms, %3d steps, snapshots %s\n", name, r.frames,
+                r.worstFrameMs, r.steps, r.consistent ? "whole" : "TORN");
+}
+
+}
+
+int main()
+{
+    Surface sprite(8, 8);
+    RenderQueue queue;
+    WorldTransformations tr;
+    tr.SetUniverseSize(100000, 100000);
+    tr.SetScreenSize(640, 480);
+
+    // serial: step when due, then render
+    {
+        Result r;
+        RenderSnapshot s;
+        auto start = std::chrono::steady_clock::now();
+        auto nextStep = start;
+        auto lastFrame = start;
+        while (std::chrono::steady_clock::now() - start < runTime)
+        {
+            if (std::chrono::steady_clock::now() >= nextStep)
+            {
+                Work(StepCost(r.steps));
+                Capture(s, sprite, r.steps++);
+                nextStep += stepPeriod;
+            }
+            Render(s, queue, tr, r);
+            ++r.frames;
+            auto now = std::chrono::steady_clock::now();
+            r.worstFrameMs = std::max(r.worstFrameMs, std::chrono::duration<double, std::milli>(now - lastFrame).count());
+            lastFrame = now;
+        }
+        Report("serial update + render", r);
+    }
+
+    // threaded: the simulation publishes, the render loop takes the newest
+    {
+        Result r;
+        TripleBuffer<RenderSnapshot> snapshots;
+        Capture(snapshots.Back(), sprite, 0);
+        snapshots.Publish();
+        std::atomic<bool> running{true};
+        std::atomic<int> steps{1};
+        std::thread simulation([&]()
+        {
+            auto next = std::chrono::steady_clock::now();
+            while (running)
+            {
+                int step = steps;
+                Work(StepCost(step));
+                Capture(snapshots.Back(), sprite, step);
+                snapshots.Publish();
+                steps = step + 1;
+                next = std::max(next + stepPeriod, std::chrono::steady_clock::now());
+                std::this_thread::sleep_until(next);
+            }
+        });
+        auto start = std::chrono::steady_clock::now();
+        auto lastFrame = start;
+        int lastStep = -1;
+        while (std::chrono::steady_clock::now() - start < runTime)
+        {
+            const RenderSnapshot& s = snapshots.Acquire();
+            // steps only go forward and a snapshot is never half written
+            r.consistent = r.consistent && s.camera.x >= lastStep;
+            lastStep = s.camera.x;
+            Render(s, queue, tr, r);
+            ++r.frames;
+            auto now = std::chrono::steady_clock::now();
+            r.worstFrameMs = std::max(r.worstFrameMs, std::chrono::duration<double, std::milli>(now - lastFrame).count());
+            lastFrame = now;
+        }
+        running = false;
+        simulation.join();
+        r.steps = steps;
+        Report("simulation thread + snapshots", r);
+    }
+
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+// Draws 32x32 sprites at growing fill ratios onto an 8 bit frame, once as
+// rectangles (IndexedSurface::Draw, every pixel tested for transparency)
+// and once as span sprites (only the opaque runs copied). The opaque
+// pixels are a disc, one span per row as in pickups, or scattered in runs
+// of 4 on average as in sparks and glyphs, the worst case for spans. Both
+// frames are compared after each ratio, flipped span sprites against
+// mirrored rectangles, and the spans of frames read back from a J2A file
+// against the pixels written.
+
+#include "BenchUtils.h"
+#include "data/Jazz2AnimFormat.h"
+#include "gfx/IndexedSurface.h"
+#include "gfx/SpanSprite.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr int spriteSize = 32;
+
+// runs of opaque pixels end with a chance of 1/4, transparent runs so that
+// fill of the pixels are opaque
+std::vector<uint8_t> MakePixels(int width, int height, double fill, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    const double endOpaque = 0.25;
+    const double startOpaque = fill >= 1.0 ? 1.0 : std::min(1.0, fill / (1.0 - fill) * endOpaque);
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height);
+    bool opaque = chance(rng) < fill;
+    for (auto& p : pixels)
+    {
+        opaque = opaque ? fill >= 1.0 || chance(rng) >= endOpaque : chance(rng) < startOpaque;
+        p = opaque ? static_cast<uint8_t>(1 + rng() % 255) : IndexedSurface::transparent;
+    }
+    return pixels;
+}
+
+// a centered disc covering fill of the square, at most pi / 4; all of it
+// for 1
+std::vector<uint8_t> MakeDisc(int size, double fill, std::mt19937& rng)
+{
+    const double r2 = fill * size * size / 3.14159265358979;
+    std::vector<uint8_t> pixels(static_cast<size_t>(size) * size);
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            const double dx = x + 0.5 - size / 2.0;
+            const double dy = y + 0.5 - size / 2.0;
+            const bool opaque = fill >= 1.0 || dx * dx + dy * dy < r2;
+            pixels[y * size + x] = opaque ? static_cast<uint8_t>(1 + rng() % 255) : IndexedSurface::transparent;
+        }
+    }
+    return pixels;
+}
+
+IndexedSurface ToSurface(const std::vector<uint8_t>& pixels, int size, bool mirrored)
+{
+    IndexedSurface s(size, size);
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            s.PutPixel(mirrored ? size - 1 - x : x, y, pixels[y * size + x]);
+        }
+    }
+    return s;
+}
+
+bool SameFrame(const IndexedSurface& a, const IndexedSurface& b)
+{
+    for (int y = 0; y < a.getHeight(); ++y)
+    {
+        if (std::memcmp(a.Row(y), b.Row(y), a.getWidth()) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// frames of one animation written to a J2A file and read back as spans
+bool RleRoundTrip(std::mt19937& rng)
+{
+    char dir[] = "/tmp/SpanSpriteBenchXXXXXX";
+    if (mkdtemp(dir) == nullptr)
+    {
+        std::perror("mkdtemp");
+        return false;
+    }
+    const std::string file = std::string(dir) + "/Sprites.j2a";
+    // frames wider than a run, so runs end at row ends and go on
+    J2AnimSetsContent sets(1, std::vector<J2AnimationContent>(1));
+    const double fills[] = {0.05, 0.3, 0.7, 1.0};
+    for (double fill : fills)
+    {
+        J2FrameContent f;
+        f.width = 200;
+        f.height = 24;
+        f.pixels = MakePixels(f.width, f.height, fill, rng);
+        sets[0][0].frames.push_back(f);
+    }
+    Jazz2AnimFormat::Write(file, sets);
+    bool correct = true;
+    {
+        Jazz2AnimFormat anims(file);
+        const std::vector<SpanSpritePtr> sprites = anims.GetSpanSprites(0, 0);
+        correct = sprites.size() == sets[0][0].frames.size();
+        for (size_t i = 0; correct && i < sprites.size(); ++i)
+        {
+            const J2FrameContent& f = sets[0][0].frames[i];
+            IndexedSurface drawn(f.width, f.height);
+            sprites[i]->Draw(drawn, 0, 0);
+            for (int y = 0; y < f.height; ++y)
+            {
+                correct = correct && std::memcmp(drawn.Row(y), &f.pixels[y * f.width], f.width) == 0;
+            }
+        }
+    }
+    std::remove(file.c_str());
+    rmdir(dir);
+    return correct;
+}
+
+}
+
+int main()
+{
+    constexpr int width = 320;
+    constexpr int height = 200;
+    constexpr int spriteCount = 16;
+    constexpr int draws = 200000;
+
+    std::mt19937 rng(49);
+    bool correct = RleRoundTrip(rng);
+
+    // positions partly off the frame on every side
+    std::vector<int> xs(draws);
+    std::vector<int> ys(draws);
+    for (int i = 0; i < draws; ++i)
+    {
+        xs[i] = static_cast<int>(rng() % (width + spriteSize)) - spriteSize / 2;
+        ys[i] = static_cast<int>(rng() % (height + spriteSize)) - spriteSize / 2;
+    }
+
+    IndexedSurface rectFrame(width, height);
+    IndexedSurface spanFrame(width, height);
+    for (int shape = 0; shape < 2; ++shape)
+    {
+        for (int percent : {5, 10, 25, 50, 75, 100})
+        {
+            std::vector<IndexedSurface> rects;
+            std::vector<IndexedSurface> mirroredRects;
+            std::vector<SpanSprite> spans;
+            int opaque = 0;
+            for (int s = 0; s < spriteCount; ++s)
+            {
+                const double fill = percent / 100.0;
+                const std::vector<uint8_t> pixels = shape == 0 ? MakeDisc(spriteSize, fill, rng)
+                                                               : MakePixels(spriteSize, spriteSize, fill, rng);
+                rects.push_back(ToSurface(pixels, spriteSize, false));
+                mirroredRects.push_back(ToSurface(pixels, spriteSize, true));
+                spans.emplace_back(rects.back());
+                opaque += spans.back().GetOpaquePixelCount();
+            }
+            std::printf("%s, fill %d%%, %.1f%% opaque\n", shape == 0 ? "disc" : "scattered runs", percent,
+                        100.0 * opaque / (spriteCount * spriteSize * spriteSize));
+
+            bench::Stopwatch sw;
+            rectFrame.Fill(IndexedSurface::transparent);
+            for (int i = 0; i < draws; ++i)
+            {
+                rectFrame.Draw(rects[i % spriteCount], xs[i], ys[i]);
+            }
+            bench::Report("  rectangles, sprites", sw.ElapsedMs(), draws);
+
+            sw.Restart();
+            spanFrame.Fill(IndexedSurface::transparent);
+            for (int i = 0; i < draws; ++i)
+            {
+                spans[i % spriteCount].Draw(spanFrame, xs[i], ys[i]);
+            }
+            bench::Report("  spans, sprites", sw.ElapsedMs(), draws);
+            correct = SameFrame(rectFrame, spanFrame) && correct;
+
+            sw.Restart();
+            spanFrame.Fill(IndexedSurface::transparent);
+            for (int i = 0; i < draws; ++i)
+            {
+                spans[i % spriteCount].Draw(spanFrame, xs[i], ys[i], true);
+            }
+            bench::Report("  spans flipped, sprites", sw.ElapsedMs(), draws);
+
+            rectFrame.Fill(IndexedSurface::transparent);
+            for (int i = 0; i < draws; ++i)
+            {
+                rectFrame.Draw(mirroredRects[i % spriteCount], xs[i], ys[i]);
+            }
+            correct = SameFrame(rectFrame, spanFrame) && correct;
+        }
+    }
+
+    std::printf("results %s\n", correct ? "correct" : "WRONG");
+    return correct ? EXIT_SUCCESS : EXIT_FAILURE;
+}
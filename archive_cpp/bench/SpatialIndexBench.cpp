@@ -0,0 +1,151 @@
+// Compares BSPTree2D with the uniform BroadPhaseGrid for point entities:
+// rectangle queries of several sizes and relocation of all entities. Both
+// structures must report the same entities.
+
+#include "BenchUtils.h"
+#include "game/BroadPhaseGrid.h"
+#include "utils/BSPTree2D.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct Entity
+{
+    int     id = -1;
+    Point2D position{0, 0};
+};
+
+struct EntityPosition
+{
+    Point2D operator()(const Entity& e) const
+    {
+        return e.position;
+    }
+};
+
+typedef BSPTree2D<Entity, EntityPosition> Tree;
+
+int main()
+{
+    constexpr int worldWidth = 256 * 32;
+    constexpr int worldHeight = 64 * 32;
+    constexpr int entityCount = 10000;
+    constexpr int queryCount = 20000;
+    constexpr int ticks = 50;
+
+    std::mt19937 rng(32);
+    std::uniform_int_distribution<int> x(0, worldWidth - 1);
+    std::uniform_int_distribution<int> y(0, worldHeight - 1);
+    std::uniform_int_distribution<int> d(-16, 16);
+
+    Tree tree({0, 0, worldWidth, worldHeight}, 128, 128);
+    BroadPhaseGrid grid(worldWidth, worldHeight, 128);
+    std::vector<Tree::Handle> treeHandles(entityCount);
+    std::vector<BroadPhaseGrid::ProxyId> gridIds(entityCount);
+    std::vector<Point2D> positions(entityCount);
+    for (auto& p : positions)
+    {
+        p = {x(rng), y(rng)};
+    }
+
+    bench::Stopwatch sw;
+    for (int i = 0; i < entityCount; ++i)
+    {
+        Entity e;
+        e.id = i;
+        e.position = positions[i];
+        treeHandles[i] = tree.Insert(e);
+    }
+    bench::Report("tree insert", sw.ElapsedMs(), entityCount);
+
+    sw.Restart();
+    for (int i = 0; i < entityCount; ++i)
+    {
+        gridIds[i] = grid.Insert({positions[i].x, positions[i].y, 1, 1}, i);
+    }
+    bench::Report("grid insert", sw.ElapsedMs(), entityCount);
+
+    for (auto& p : positions)
+    {
+        p.x += d(rng);
+        p.y += d(rng);
+    }
+
+    sw.Restart();
+    for (int t = 0; t < ticks; ++t)
+    {
+        for (int i = 0; i < entityCount; ++i)
+        {
+            tree.Get(treeHandles[i]).position = positions[i];
+            tree.Relocate(treeHandles[i]);
+        }
+    }
+    bench::Report("tree relocate", sw.ElapsedMs(), double(entityCount) * ticks);
+
+    sw.Restart();
+    for (int t = 0; t < ticks; ++t)
+    {
+        for (int i = 0; i < entityCount; ++i)
+        {
+            grid.Move(gridIds[i], {positions[i].x, positions[i].y, 1, 1});
+        }
+    }
+    bench::Report("grid move", sw.ElapsedMs(), double(entityCount) * ticks);
+
+    int mismatches = 0;
+    const int sizes[] = {32, 320, 2048};
+    for (int size : sizes)
+    {
+        std::vector<Rectangle2D> queries(queryCount);
+        for (auto& q : queries)
+        {
+            q = {x(rng) - size / 2, y(rng) - size / 2, size, size};
+        }
+        char name[64];
+
+        long treeFound = 0;
+        sw.Restart();
+        for (const auto& q : queries)
+        {
+            tree.Query(q, [&](Tree::Handle, const Entity& e)
+            {
+                treeFound += e.id + 1;
+            });
+        }
+        std::snprintf(name, sizeof(name), "tree query %dx%d", size, size);
+        bench::Report(name, sw.ElapsedMs(), queryCount);
+
+        long gridFound = 0;
+        sw.Restart();
+        for (const auto& q : queries)
+        {
+            grid.QueryRect(q, [&](BroadPhaseGrid::ProxyId id)
+            {
+                gridFound += grid.GetUserData(id) + 1;
+            });
+        }
+        std::snprintf(name, sizeof(name), "grid query %dx%d", size, size);
+        bench::Report(name, sw.ElapsedMs(), queryCount);
+
+        mismatches += treeFound != gridFound;
+    }
+
+    for (int i = 0; i < entityCount; i += 2)
+    {
+        tree.Erase(treeHandles[i]);
+    }
+    long left = 0;
+    tree.Query({-worldWidth, -worldHeight, 3 * worldWidth, 3 * worldHeight}, [&](Tree::Handle, const Entity& e)
+    {
+        left += e.id % 2;
+    });
+    mismatches += left != entityCount / 2 || tree.Size() != entityCount / 2;
+
+    if (mismatches != 0)
+    {
+        std::printf("tree and grid disagree\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+#ifndef SYNTHETICASSETS_H
+#define SYNTHETICASSETS_H
+
+// Generated game files for the load benchmarks, the original assets cannot
+// be shipped. Everything is random but reproducible from the seed.
+
+#include "data/Jazz2AnimFormat.h"
+#include "data/Jazz2LevelFormat.h"
+#include "data/Jazz2TileFormat.h"
+#include "data/JJ2LevelBuilder.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+namespace bench
+{
+
+// tiles with a transparent border on every fourth, solid bottom halves on
+// every other; more than 1024 tiles make a TSF tile set
+inline J2TileSetContent SyntheticTileSet(int tileCount, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    J2TileSetContent c;
+    c.title = "Synthetic";
+    for (int i = 0; i < 256; ++i)
+    {
+        c.palette[i] = static_cast<int32_t>(rng() & 0x00ffffff);
+    }
+    c.images.resize(static_cast<size_t>(tileCount) * 1024);
+    c.transparencyMasks.resize(static_cast<size_t>(tileCount) * 128);
+    c.collisionMasks.resize(static_cast<size_t>(tileCount) * 128);
+    c.flippedCollisionMasks.resize(static_cast<size_t>(tileCount) * 128);
+    for (int t = 0; t < tileCount; ++t)
+    {
+        const uint8_t base = static_cast<uint8_t>(rng());
+        for (int p = 0; p < 1024; ++p)
+        {
+            c.images[t * 1024 + p] = static_cast<char>(base + (rng() & 7));
+        }
+        for (int b = 0; b < 128; ++b)
+        {
+            const int row = b / 4;
+            const bool border = t % 4 == 0 && (row < 2 || row > 29);
+            c.transparencyMasks[t * 128 + b] = border ? 0 : char(0xff);
+            const bool solid = t % 2 == 0 && row >= 16;
+            c.collisionMasks[t * 128 + b] = solid ? char(0xff) : 0;
+            c.flippedCollisionMasks[t * 128 + b] = solid ? char(0xff) : 0;
+        }
+    }
+    return c;
+}
+
+// setCount sets of animationsPerSet animations; the level builder and the
+// hero need at least 100 sets of 100 animations
+inline J2AnimSetsContent SyntheticAnimSets(int setCount, int animationsPerSet, int framesPerAnimation,
+                                           int frameSize, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    J2AnimSetsContent sets(setCount);
+    for (auto& set : sets)
+    {
+        set.resize(animationsPerSet);
+        for (auto& a : set)
+        {
+            a.fps = static_cast<short>(5 + rng() % 20);
+            a.frames.resize(framesPerAnimation);
+            for (auto& f : a.frames)
+            {
+                f.width = static_cast<short>(frameSize);
+                f.height = static_cast<short>(frameSize);
+                f.hotspotX = static_cast<short>(-frameSize / 2);
+                f.hotspotY = static_cast<short>(-frameSize);
+                f.pixels.resize(static_cast<size_t>(frameSize) * frameSize);
+                // a filled ellipse, transparent corners
+                const int r = frameSize / 2;
+                for (int y = 0; y < frameSize; ++y)
+                {
+                    for (int x = 0; x < frameSize; ++x)
+                    {
+                        const int dx = x - r;
+                        const int dy = y - r;
+                        const bool inside = dx * dx + dy * dy < r * r;
+                        f.pixels[y * frameSize + x] = inside ? static_cast<uint8_t>(1 + rng() % 255) : 0;
+                    }
+                }
+            }
+        }
+    }
+    return sets;
+}
+
+// Layers 3 to 5 are width x height, the action layer (4) full, the other
+// two sparse; layer 8 is a small repeating background. Tiles come in
+// groups of four from a pool, as the format needs them to repeat. Events
+// (coins, gems, food, springs) cover eventDensity of the action layer.
+inline J2LevelContent SyntheticLevel(const std::string& name, const std::string& tileSet, int tileCount,
+                                     int width, int height, double eventDensity, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    J2LevelContent c;
+    c.name = name;
+    c.tileSet = tileSet;
+    c.tsf = tileCount > MAX_TILES_123;
+    const int maxIds = c.tsf ? MAX_TILES_124 : MAX_TILES_123;
+    c.animOffset = static_cast<short>(tileCount);
+    const int animated = std::min(16, maxIds - tileCount);
+    for (int a = 0; a < animated; ++a)
+    {
+        Animated_Tile t = {};
+        t.Speed = 10;
+        t.FrameCount = 4;
+        for (int f = 0; f < t.FrameCount; ++f)
+        {
+            t.Frame[f] = static_cast<short>(1 + rng() % (tileCount - 1));
+        }
+        c.animTiles.push_back(t);
+    }
+
+    const int idCount = tileCount + animated;
+    std::vector<uint16_t> pool(4 * 4096);
+    for (auto& id : pool)
+    {
+        id = static_cast<uint16_t>(1 + rng() % (idCount - 1));
+    }
+    auto fill = [&](J2Layer& layer, int w, int h, int emptyPercent)
+    {
+        layer.width = w;
+        layer.height = h;
+        layer.grid.reserve(static_cast<size_t>(w) * h);
+        for (int y = 0; y < h; ++y)
+        {
+            for (int qx = 0; qx < w; qx += 4)
+            {
+                const bool empty = static_cast<int>(rng() % 100) < emptyPercent;
+                const uint16_t* quad = &pool[4 * (rng() % 4096)];
+                const bool flipped = rng() % 16 == 0;
+                for (int x = qx; x < std::min(qx + 4, w); ++x)
+                {
+                    layer.grid.push_back({empty ? 0 : quad[x - qx], flipped, x, y, 0});
+                }
+            }
+        }
+    };
+    c.layers.resize(8);
+    fill(c.layers[2], width, height, 70);
+    fill(c.layers[3], width, height, 0);
+    fill(c.layers[4], width, height, 70);
+    fill(c.layers[7], 8, 8, 0);
+    c.layers[7].tileX = true;
+    c.layers[7].tileY = true;
+
+    const uint8_t kinds[] = {SilverCoin, GoldCoin, RedGem, GreenGem, BlueGem, Apple, Banana, Cherry,
+                             Pizza, Burger, RedSpring, GreenSpring, BlueSpring, Energy};
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (chance(rng) < eventDensity)
+            {
+                c.events.push_back({kinds[rng() % sizeof(kinds)], {0, 0, 0}, x, y});
+            }
+        }
+    }
+    c.events.push_back({HeroStartPos, {0, 0, 0}, width / 2, height / 2});
+    return c;
+}
+
+}
+
+#endif // SYNTHETICASSETS_H
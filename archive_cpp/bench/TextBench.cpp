@@ -0,0 +1,55 @@
+// Draws a HUD line and 20 console lines per frame, rasterizing every
+// string each frame versus keeping them in cached text runs, with the
+// built-in font packed into a glyph atlas.
+
+#include "BenchUtils.h"
+#include "gfx/TextRun.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int main()
+{
+    constexpr int lineCount = 20;
+    constexpr int frames = 2000;
+
+    std::vector<std::string> console;
+    for (int i = 0; i < lineCount; ++i)
+    {
+        console.push_back("Loading level Castle1.j2l, layer " + std::to_string(i) + " ready");
+    }
+    Surface screen(1024, 768);
+
+    bench::Stopwatch sw;
+    for (int f = 0; f < frames; ++f)
+    {
+        // the FPS value changes once a second, about every 60 frames
+        TextRun fps;
+        fps.Set("FPS = " + std::to_string(60 + f / 60), {255, 255, 255, 160});
+        screen.Draw(*fps.GetSurface(), 300, 30);
+        for (int i = 0; i < lineCount; ++i)
+        {
+            TextRun line;
+            line.Set(console[i], {255, 255, 255, 160});
+            screen.Draw(*line.GetSurface(), 10, 10 * (i + 1));
+        }
+    }
+    bench::Report("21 strings, rasterized every frame", sw.ElapsedMs() / frames, lineCount + 1);
+
+    TextRun fps;
+    std::vector<TextRun> lines(lineCount);
+    sw.Restart();
+    for (int f = 0; f < frames; ++f)
+    {
+        fps.Set("FPS = " + std::to_string(60 + f / 60), {255, 255, 255, 160});
+        screen.Draw(*fps.GetSurface(), 300, 30);
+        for (int i = 0; i < lineCount; ++i)
+        {
+            lines[i].Set(console[i], {255, 255, 255, 160});
+            screen.Draw(*lines[i].GetSurface(), 10, 10 * (i + 1));
+        }
+    }
+    bench::Report("21 strings, cached text runs", sw.ElapsedMs() / frames, lineCount + 1);
+    return EXIT_SUCCESS;
+}
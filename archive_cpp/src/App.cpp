@@ -4,43 +4,109 @@
 #include "game/Game.h"
 #include "game/ResourceDbg.h"
 #include "data/ResourceFactory.h"
+#include "utils/MemoryStats.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <stdlib.h>
 #include <time.h>
-#include <SDL2/SDL2_gfxPrimitives.h>
 
-#include <boost/format.hpp>
+namespace {
 
-App::App()
+// the simulation steps this often, recorded or not
+constexpr std::chrono::milliseconds updateStateDelay{30};
+
+}
+
+App::App(int scale, RenderBackendType backend, const std::string& recordFile)
+    : recordFile(recordFile)
 {
     // Initialize gfx
-    GraphicsEngine::getInstance().InitializeGfxMode(1024, 768);
+    GraphicsEngine::getInstance().InitializeGfxMode(1024, 768, scale, backend);
     // initialize rng
-    srand(time(NULL));
+    const uint32_t seed = static_cast<uint32_t>(time(NULL));
+    srand(seed);
     // initialize fps routines
     SDL_initFramerate(&fpsManager);
     SDL_setFramerate(&fpsManager, FPS_UPPER_LIMIT);
     // initialize logger
     LOG.AppendWriter(std::unique_ptr<ConsoleWriter>{new ConsoleWriter()});
-    logWriter = new GameConsoleWriter(GraphicsEngine::getInstance().Screen());
+    logWriter = new GameConsoleWriter(GraphicsEngine::getInstance().Backend());
     LOG.AppendWriter(
         std::unique_ptr<GameConsoleWriter>{logWriter}
     );
+    try
+    {
+        audio.reset(new AudioDevice());
+        LOG_INFO << "Audio at " << audio->GetRate() << " Hz, " << audio->GetDriverName() << " driver\n";
+    }
+    catch (const std::exception& ex)
+    {
+        LOG_ERROR << ex.what() << ", playing without sound\n";
+    }
+    // text is drawn with a JJ2 font if the animation file has one
+    FontPtr font = ResourceFactory::GetInstance().LoadFont("Anims.j2a");
+    if (font)
+    {
+        GraphicsEngine::getInstance().SetFont(font);
+    }
     // initialize few default story boards
     storyBoards.reserve(5);
     const std::string firstLev = "Castle1.j2l";
+    if (!recordFile.empty())
+    {
+        inputLog.level = firstLev;
+        inputLog.seed = seed;
+        inputLog.stepMs = static_cast<uint16_t>(updateStateDelay.count());
+        inputLog.width = static_cast<uint16_t>(GraphicsEngine::getInstance().Width());
+        inputLog.height = static_cast<uint16_t>(GraphicsEngine::getInstance().Height());
+        inputLog.startTime = SDL_GetTicks();
+        GameClock::SetVirtualTime(GameClock::time_point(GameClock::duration(inputLog.startTime)));
+    }
     storyBoards.push_back(std::unique_ptr<IStoryBoard>{new Game(firstLev)});
     storyBoards.push_back(std::unique_ptr<IStoryBoard>{
                               ResourceFactory::GetInstance().LoadDeveloperPreview(firstLev)});
 }
 
 App::~App()
-{ }
+{
+    isRunning = false;
+    if (simulationThread.joinable())
+    {
+        simulationThread.join();
+    }
+}
+
+void App::Simulate()
+{
+    auto next = std::chrono::steady_clock::now();
+    while (isRunning)
+    {
+        // the game story board is the one recorded, its clock only moves with its steps
+        const unsigned board = currentStoryBoardIndx;
+        const bool record = !recordFile.empty() && board == 0;
+        if (record)
+        {
+            GameClock::SetVirtualTime(GameClock::time_point(
+                GameClock::duration(inputLog.startTime + recordedSteps++ * inputLog.stepMs)));
+        }
+        HandleInput(board, record);
+        storyBoards[board]->UpdateState(GameClock::now().time_since_epoch().count());
+        // a slow step delays the next ones, not the frames
+        next = std::max(next + updateStateDelay, std::chrono::steady_clock::now());
+        std::this_thread::sleep_until(next);
+    }
+}
 
 void App::Run()
 {
-    static const long updateStateDelay = 30;
-    LOG.printf("Press F2 to change the view\n");
+    LOG_INFO.printf("Press F2 to change the view, F3 to toggle 8 bit rendering, F4 for memory use, "
+               "F5 to play the next sound\n");
+    LOG_INFO << "Rendering at " << GraphicsEngine::getInstance().Width() << "x"
+        << GraphicsEngine::getInstance().Height() << ", scale " << GraphicsEngine::getInstance().Scale()
+        << ", " << GraphicsEngine::getInstance().Backend().GetName() << " backend\n";
+    simulationThread = std::thread(&App::Simulate, this);
     SDL_Event Event;
     while (isRunning)
     {
@@ -48,13 +114,6 @@ void App::Run()
         {
             OnEvent(&Event);
         }        
-        long time = SDL_GetTicks();
-        if (time - oldTime > updateStateDelay)
-        {
-            HandleInput();
-            storyBoards[currentStoryBoardIndx]->UpdateState(time);
-            oldTime = time;
-        }
         GraphicsEngine::getInstance().BeginFrame();
 
         long currentTime = SDL_GetTicks();
@@ -62,8 +121,14 @@ void App::Run()
         storyBoards[currentStoryBoardIndx]->Render(currentTime);
 
         frameCounter.Tick(currentTime);
-        std::string fps_mess = (boost::format("FPS = %|-5.1f|") % frameCounter.GetFPS()).str();
-        GraphicsEngine::getInstance().Screen().WriteText(fps_mess, 300, 30, {255, 255, 255, 160});
+        if (frameCounter.GetFPS() != shownFps)
+        {
+            shownFps = frameCounter.GetFPS();
+            char fps_mess[32];
+            std::snprintf(fps_mess, sizeof(fps_mess), "FPS = %-5.1f", shownFps);
+            fpsText.Set(fps_mess, {255, 255, 255, 160});
+        }
+        GraphicsEngine::getInstance().Backend().DrawText(fpsText, 300, 30);
 
         if (printLoggerOnScreen)
         {
@@ -72,6 +137,12 @@ void App::Run()
 
         GraphicsEngine::getInstance().Render();
     }
+    simulationThread.join();
+    if (!recordFile.empty())
+    {
+        inputLog.Save(recordFile);
+        LOG_INFO << "Recorded " << inputLog.StepCount() << " steps to " << recordFile << "\n";
+    }
 }
 
 void App::OnExit()
@@ -99,12 +170,25 @@ void App::OnKeyDown(SDL_Keycode sym, Uint16 /*mod*/, Uint16 /*unicode*/)
         printLoggerOnScreen = !printLoggerOnScreen;
         break;
     case SDLK_F2:
-        ++currentStoryBoardIndx;
-        if (currentStoryBoardIndx >= storyBoards.size())
+        currentStoryBoardIndx = (currentStoryBoardIndx + 1) % storyBoards.size();
+        break;
+    case SDLK_F3:
+    {
+        auto& engine = GraphicsEngine::getInstance();
+        engine.SetIndexedMode(!engine.IsIndexedMode());
+        LOG_INFO << (engine.IsIndexedMode() ? "8 bit indexed rendering\n" : "32 bit rendering\n");
+        break;
+    }
+    case SDLK_F4:
+        LOG_INFO << MemoryStats::GetReport();
+        for (const auto& v : MemoryStats::GetBudgetViolations())
         {
-            currentStoryBoardIndx = 0;
+            LOG_WARNING << "Over budget: " << v << "\n";
         }
         break;
+    case SDLK_F5:
+        PlayNextSound();
+        break;
     case SDLK_w:
         heroUp = true;
         break;
@@ -155,40 +239,58 @@ void App::OnKeyUp(SDL_Keycode sym, Uint16 /*mod*/, Uint16 /*unicode*/)
     }
 }
 
-void App::HandleInput()
+uint8_t App::SampleKeys() const
 {
-    auto& game = storyBoards[currentStoryBoardIndx];
-    if (upKey)
-    {
-        game->Up();
-    }
-    if (downKey)
-    {
-        game->Down();
-    }
-    if (rightKey)
-    {
-        game->Right();
-    }
-    if (leftKey)
-    {
-        game->Left();
-    }
-    if (heroDown)
+    uint8_t keys = 0;
+    keys |= upKey ? CameraUp : 0;
+    keys |= downKey ? CameraDown : 0;
+    keys |= leftKey ? CameraLeft : 0;
+    keys |= rightKey ? CameraRight : 0;
+    keys |= heroUp ? HeroUp : 0;
+    keys |= heroDown ? HeroDown : 0;
+    keys |= heroLeft ? HeroLeft : 0;
+    keys |= heroRight ? HeroRight : 0;
+    return keys;
+}
+
+void App::HandleInput(unsigned board, bool record)
+{
+    // read once, what is applied is what gets recorded
+    const uint8_t keys = SampleKeys();
+    if (record)
     {
-        game->HeroCrunch();
+        inputLog.Append(keys);
     }
-    if (heroUp)
+    ApplyInput(*storyBoards[board], keys);
+}
+
+void App::PlayNextSound()
+{
+    if (!audio)
     {
-        game->HeroJump();
+        return;
     }
-    if (heroLeft)
+    try
     {
-        game->HeroLeft();
+        SampleBank& bank = ResourceFactory::GetInstance().LoadSampleBank("Anims.j2a");
+        // at most one pass over the sets, which may all be empty
+        for (int step = 0; step <= bank.GetSetCount(); ++step)
+        {
+            if (++soundIndex >= bank.GetSampleCount(soundSet))
+            {
+                soundSet = soundSet + 1 < bank.GetSetCount() ? soundSet + 1 : 0;
+                soundIndex = -1;
+                continue;
+            }
+            audio->GetMixer().Play(bank.Get(soundSet, soundIndex));
+            LOG_INFO << "Sound " << soundIndex << " of set " << soundSet << "\n";
+            return;
+        }
+        LOG_WARNING << "The animation file has no sounds\n";
     }
-    if (heroRight)
+    catch (const std::exception& ex)
     {
-        game->HeroRight();
+        LOG_ERROR << ex.what() << "\n";
     }
 }
 
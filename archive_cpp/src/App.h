@@ -4,38 +4,69 @@
 #include "utils/SdlEventConsumer.h"
 #include "utils/GameConsoleWriter.h"
 #include "game/IStoryBoard.h"
+#include "game/InputLog.h"
 #include "utils/Utils.h"
+#include "gfx/TextRun.h"
+#include "gfx/RenderBackend.h"
+#include "audio/AudioDevice.h"
 
 #include <SDL2/SDL2_framerate.h>
+#include <atomic>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 class App : protected SdlEventConsumer
 {
 public:
-    App();
+    // the game is rendered at 1/scale of the window resolution; with a
+    // recordFile the game runs on virtual time and its input is saved there
+    // when the app quits, for RunReplay
+    explicit App(int scale = 1, RenderBackendType backend = RenderBackendType::Surface,
+                 const std::string& recordFile = "");
     ~App();
     void Run();
 private:
-    bool isRunning = true;
-    unsigned currentStoryBoardIndx = 0;
+    std::atomic<bool> isRunning{true};
+    std::atomic<unsigned> currentStoryBoardIndx{0};
     std::vector<std::unique_ptr<IStoryBoard>>   storyBoards;
     FPSCounter              frameCounter;
     FPSmanager              fpsManager;
+    // formatted and rasterized only when the value changes
+    double                  shownFps = -1.0;
+    TextRun                 fpsText;
+    // steps the story board every updateStateDelay ms while the main
+    // thread polls the events and renders
+    std::thread             simulationThread;
+    void Simulate();
+    // recording: the steps of the game story board, step n runs at
+    // inputLog.startTime + n * inputLog.stepMs
+    std::string             recordFile;
+    InputLog                inputLog;
+    uint64_t                recordedSteps = 0;
     // Events
     virtual void OnExit();
-    bool upKey = false;
-    bool downKey = false;
-    bool leftKey = false;
-    bool rightKey = false;
-    bool heroUp = false;
-    bool heroDown = false;
-    bool heroLeft = false;
-    bool heroRight = false;
+    // keys are pressed on the main thread and read by the simulation
+    std::atomic<bool> upKey{false};
+    std::atomic<bool> downKey{false};
+    std::atomic<bool> leftKey{false};
+    std::atomic<bool> rightKey{false};
+    std::atomic<bool> heroUp{false};
+    std::atomic<bool> heroDown{false};
+    std::atomic<bool> heroLeft{false};
+    std::atomic<bool> heroRight{false};
     virtual void OnKeyDown(SDL_Keycode sym, Uint16 /*mod*/, Uint16 /*unicode*/);
     virtual void OnKeyUp(SDL_Keycode sym, Uint16 /*mod*/, Uint16 /*unicode*/);
-    void HandleInput();
-    long oldTime = 0;
+    // the keys held now, as InputKeys
+    uint8_t SampleKeys() const;
+    void HandleInput(unsigned board, bool record);
+    // nullptr when SDL has no audio output
+    std::unique_ptr<AudioDevice> audio;
+    // F5 plays the samples of the animation file one after another
+    int                 soundSet = 0;
+    int                 soundIndex = -1;
+    void PlayNextSound();
     GameConsoleWriter*   logWriter;
     bool                printLoggerOnScreen = true;
 };
@@ -1,68 +1,34 @@
 #ifndef COLLISIONENGINE_H
 #define COLLISIONENGINE_H
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <vector>
 #include <assert.h>
 #include "utils/Utils.h"
 #include "utils/MicroLogger.h"
+#include "game/CollisionBitmap.h"
 
 namespace CollisionEngine
 {
 
-struct NeighborhoodStats
+// contacts of a box with the terrain around it
+struct Contacts
 {
     bool onTheGround = false;
     bool inFrontOfLeftWall = false;
     bool inFrontOfRightWall = false;
     bool touchCeiling = false;
-    //bool inFrontOfLeftEdge = false;
-    //bool inFrontOfRightEdge = false;
 };
 
-template <class TerrainGetterFn>
-bool OnTheGround(const TerrainGetterFn& terrain, const Point2D& p)
-{
-    //        p
-    //        x
-    return terrain(p.x, p.y + 1);
-}
-
-template <class TerrainGetterFn>
-bool InFrontOfLeftWall(const TerrainGetterFn& terrain, const Point2D& p)
-{
-    //        x
-    //        x
-    //        xp
-    return terrain(p.x - 1, p.y) && terrain(p.x - 1, p.y - 1) && terrain(p.x - 1, p.y - 2);
-}
-
-template <class TerrainGetterFn>
-bool InFrontOfRightWall(const TerrainGetterFn& terrain, const Point2D& p)
-{
-    //         x
-    //         x
-    //        px
-    return terrain(p.x + 1, p.y) && terrain(p.x + 1, p.y - 1) && terrain(p.x + 1, p.y - 2);
-}
-
-template <class TerrainGetterFn>
-bool TouchCeiling(const TerrainGetterFn& terrain, const Point2D& p)
-{
-    //         x
-    //         p
-    return terrain(p.x, p.y - 1);
-}
-
-template <class TerrainGetterFn>
-void GetStatistics(const TerrainGetterFn& terrain, const Point2D& p, NeighborhoodStats& stats)
+struct SweepResult
 {
-    stats.onTheGround = OnTheGround(terrain, p);
-    stats.inFrontOfLeftWall = InFrontOfLeftWall(terrain, p);
-    stats.inFrontOfRightWall = InFrontOfRightWall(terrain, p);
-    stats.touchCeiling = TouchCeiling(terrain, p);
-}
+    Vector2D    moved{0, 0};        // how far the box could move
+    Vector2D    normal{0, 0};       // normal of the blocking surfaces, zero if nothing was hit
+    double      timeOfImpact = 1.0; // fraction of the movement done before the first hit
+    Contacts    contacts;           // contacts at the final position
+};
 
 // returns true if collision with terrain happens
 template <class TerrainGetterFn>
@@ -108,6 +74,99 @@ bool AdjustMovementVector(const TerrainGetterFn& terrain, const Point2D& p, Vect
     return isCollision;
 }
 
+// Same as above, but whole rows and columns of the bitmap are tested
+// 64 pixels at a time instead of pixel by pixel.
+inline bool AdjustMovementVector(const CollisionBitmap& terrain, const Point2D& p, Vector2D& v)
+{
+    bool isCollision = false;
+    int hit = 0;
+    // go through X
+    int non_collidind_x = p.x + v.dx;
+    if (terrain.FirstSolidInRow(p.y, p.x, p.x + v.dx, hit))
+    {
+        isCollision = true;
+        non_collidind_x = (hit == p.x) ? p.x : hit - sign_i(v.dx);
+    }
+    // go through Y
+    int non_colliding_y = p.y + v.dy;
+    if (terrain.FirstSolidInColumn(non_collidind_x, p.y, p.y + v.dy, hit))
+    {
+        isCollision = true;
+        non_colliding_y = (hit == p.y) ? p.y : hit - sign_i(v.dy);
+    }
+    // truncate the v vector
+    v = {non_collidind_x - p.x, non_colliding_y - p.y};
+    return isCollision;
+}
+
+inline Contacts GetContacts(const CollisionBitmap& terrain, const Rectangle2D& box)
+{
+    //     c c c
+    //   w x x x w
+    //   w x x x w
+    //     g g g
+    const int right = box.x + box.w - 1;
+    const int bottom = box.y + box.h - 1;
+    int hit = 0;
+    Contacts c;
+    c.onTheGround = terrain.FirstSolidInRow(bottom + 1, box.x, right, hit);
+    c.touchCeiling = terrain.FirstSolidInRow(box.y - 1, box.x, right, hit);
+    c.inFrontOfLeftWall = terrain.FirstSolidInColumn(box.x - 1, box.y, bottom, hit);
+    c.inFrontOfRightWall = terrain.FirstSolidInColumn(right + 1, box.y, bottom, hit);
+    return c;
+}
+
+// Moves an axis-aligned box along v as far as the terrain allows. The move
+// is split into sub-steps of at most one pixel per axis, so a box blocked
+// on one axis keeps sliding along the other one. Every step tests a whole
+// edge of the box against the bitmap.
+inline SweepResult SweepBox(const CollisionBitmap& terrain, const Rectangle2D& box, const Vector2D& v)
+{
+    SweepResult r;
+    const int steps = std::max(abs_i(v.dx), abs_i(v.dy));
+    const int sx = (v.dx > 0) - (v.dx < 0);
+    const int sy = (v.dy > 0) - (v.dy < 0);
+    bool blockedX = (sx == 0);
+    bool blockedY = (sy == 0);
+    int x = box.x;
+    int y = box.y;
+    int hit = 0;
+    for (int i = 1; i <= steps && !(blockedX && blockedY); ++i)
+    {
+        if (!blockedX && x != box.x + v.dx * i / steps)
+        {
+            int edge = (sx > 0) ? x + box.w : x - 1;
+            if (terrain.FirstSolidInColumn(edge, y, y + box.h - 1, hit))
+            {
+                blockedX = true;
+                r.normal.dx = -sx;
+                r.timeOfImpact = std::min(r.timeOfImpact, double(i - 1) / steps);
+            }
+            else
+            {
+                x += sx;
+            }
+        }
+        if (!blockedY && y != box.y + v.dy * i / steps)
+        {
+            int edge = (sy > 0) ? y + box.h : y - 1;
+            if (terrain.FirstSolidInRow(edge, x, x + box.w - 1, hit))
+            {
+                blockedY = true;
+                r.normal.dy = -sy;
+                r.timeOfImpact = std::min(r.timeOfImpact, double(i - 1) / steps);
+            }
+            else
+            {
+                y += sy;
+            }
+        }
+    }
+    r.moved = {x - box.x, y - box.y};
+    r.contacts = GetContacts(terrain, {x, y, box.w, box.h});
+    return r;
+}
+
 }
 
 #endif // COLLISIONENGINE_H
@@ -0,0 +1,50 @@
+#include "AudioDevice.h"
+
+#include <stdexcept>
+#include <string>
+
+AudioDevice::AudioDevice(int rate, int bufferFrames)
+{
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0)
+    {
+        throw std::runtime_error(std::string("No audio: ") + SDL_GetError());
+    }
+    SDL_AudioSpec desired;
+    SDL_zero(desired);
+    desired.freq = rate;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = Mixer::channelCount;
+    desired.samples = static_cast<Uint16>(bufferFrames);
+    desired.callback = &AudioDevice::Callback;
+    desired.userdata = this;
+    // the format and channels are what Mix writes, only the rate may differ
+    device = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if (device == 0)
+    {
+        const std::string error = SDL_GetError();
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        throw std::runtime_error("Opening the audio output failed: " + error);
+    }
+    // the callback runs once the device is unpaused, with the mixer made
+    mixer.reset(new Mixer(obtained.freq));
+    SDL_PauseAudioDevice(device, 0);
+}
+
+AudioDevice::~AudioDevice()
+{
+    SDL_CloseAudioDevice(device);
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+const char* AudioDevice::GetDriverName() const
+{
+    const char* name = SDL_GetCurrentAudioDriver();
+    return name ? name : "none";
+}
+
+void AudioDevice::Callback(void* userdata, Uint8* stream, int len)
+{
+    AudioDevice* self = static_cast<AudioDevice*>(userdata);
+    self->mixer->Mix(reinterpret_cast<int16_t*>(stream),
+                     len / static_cast<int>(sizeof(int16_t) * Mixer::channelCount));
+}
@@ -0,0 +1,37 @@
+#ifndef AUDIODEVICE_H
+#define AUDIODEVICE_H
+
+#include "audio/Mixer.h"
+
+#include <SDL2/SDL.h>
+#include <memory>
+
+// The SDL audio output, stereo 16 bit, fed by a Mixer from SDL's audio
+// thread. Set SDL_AUDIODRIVER=dummy to run it without a sound card: the
+// callback is then driven on time and the output thrown away.
+class AudioDevice
+{
+public:
+    // about rate frames per second, SDL may pick another rate, and
+    // bufferFrames per callback; throws std::runtime_error when SDL has no
+    // audio output
+    explicit AudioDevice(int rate = 44100, int bufferFrames = 1024);
+    // stops the callback before the mixer goes
+    ~AudioDevice();
+    AudioDevice(const AudioDevice&) = delete;
+    AudioDevice& operator=(const AudioDevice&) = delete;
+
+    // for the one thread that plays sounds
+    Mixer& GetMixer() { return *mixer; }
+    int GetRate() const { return obtained.freq; }
+    int GetBufferFrames() const { return obtained.samples; }
+    const char* GetDriverName() const;
+private:
+    static void Callback(void* userdata, Uint8* stream, int len);
+
+    SDL_AudioSpec           obtained;
+    SDL_AudioDeviceID       device = 0;
+    std::unique_ptr<Mixer>  mixer;
+};
+
+#endif // AUDIODEVICE_H
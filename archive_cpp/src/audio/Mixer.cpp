@@ -0,0 +1,216 @@
+#include "Mixer.h"
+
+#include <algorithm>
+#include <cassert>
+
+constexpr int Mixer::voiceCount;
+constexpr int Mixer::channelCount;
+constexpr int Mixer::blockFrames;
+
+Mixer::Mixer(int outputRate)
+    : outputRate(outputRate)
+{
+    assert(outputRate > 0);
+}
+
+int32_t Mixer::ToGain(float volume)
+{
+    return static_cast<int32_t>(std::min(std::max(volume, 0.0f), 1.0f) * gainOne + 0.5f);
+}
+
+bool Mixer::Send(const Command& c)
+{
+    return commands.Push(c);
+}
+
+Mixer::VoiceId Mixer::Play(SamplePtr sample, float volume, float pan, bool loop)
+{
+    CollectFinished();
+    if (!sample || sample->frames.empty())
+    {
+        return 0;
+    }
+    const int slot = static_cast<int>(std::find(ids, ids + voiceCount, 0u) - ids);
+    if (slot == voiceCount)
+    {
+        return 0;
+    }
+    generation = generation % maxGeneration + 1;
+    Command c;
+    c.type = CommandType::Play;
+    c.loop = loop;
+    c.voice = generation << slotBits | static_cast<uint32_t>(slot);
+    c.frames = sample->frames.data();
+    c.length = static_cast<uint32_t>(sample->frames.size());
+    const int rate = sample->rate > 0 ? sample->rate : outputRate;
+    c.step = static_cast<uint32_t>((static_cast<uint64_t>(rate) << 16) / outputRate);
+    c.gain[0] = ToGain(volume * std::min(1.0f, 1.0f - pan));
+    c.gain[1] = ToGain(volume * std::min(1.0f, 1.0f + pan));
+    if (!Send(c))
+    {
+        return 0;
+    }
+    ids[slot] = c.voice;
+    playing[slot] = std::move(sample);
+    return c.voice;
+}
+
+bool Mixer::SetVolume(VoiceId voice, float volume, float pan)
+{
+    Command c;
+    c.type = CommandType::SetGain;
+    c.voice = voice;
+    c.gain[0] = ToGain(volume * std::min(1.0f, 1.0f - pan));
+    c.gain[1] = ToGain(volume * std::min(1.0f, 1.0f + pan));
+    return Send(c);
+}
+
+bool Mixer::Stop(VoiceId voice)
+{
+    Command c;
+    c.type = CommandType::Stop;
+    c.voice = voice;
+    return Send(c);
+}
+
+bool Mixer::StopAll()
+{
+    Command c;
+    c.type = CommandType::StopAll;
+    return Send(c);
+}
+
+bool Mixer::SetMasterVolume(float volume)
+{
+    Command c;
+    c.type = CommandType::SetMasterGain;
+    c.gain[0] = ToGain(volume);
+    return Send(c);
+}
+
+void Mixer::CollectFinished()
+{
+    VoiceId id;
+    while (finished.Pop(id))
+    {
+        const uint32_t slot = id & slotMask;
+        if (ids[slot] == id)
+        {
+            ids[slot] = 0;
+            playing[slot].reset();
+        }
+    }
+}
+
+int Mixer::GetBusyVoiceCount() const
+{
+    return static_cast<int>(voiceCount - std::count(ids, ids + voiceCount, 0u));
+}
+
+void Mixer::Execute(const Command& c)
+{
+    Voice& v = voices[c.voice & slotMask];
+    switch (c.type)
+    {
+    case CommandType::Play:
+        // the game side reuses a slot only once its voice came back
+        assert(v.id == 0);
+        v.id = c.voice;
+        v.frames = c.frames;
+        v.length = c.length;
+        v.loop = c.loop;
+        v.position = 0;
+        v.step = c.step;
+        std::copy(c.gain, c.gain + channelCount, v.gain);
+        break;
+    case CommandType::SetGain:
+        if (v.id == c.voice)
+        {
+            std::copy(c.gain, c.gain + channelCount, v.gain);
+        }
+        break;
+    case CommandType::Stop:
+        if (v.id == c.voice)
+        {
+            Finish(v);
+        }
+        break;
+    case CommandType::StopAll:
+        for (Voice& voice : voices)
+        {
+            if (voice.id != 0)
+            {
+                Finish(voice);
+            }
+        }
+        break;
+    case CommandType::SetMasterGain:
+        masterGain = c.gain[0];
+        break;
+    }
+}
+
+void Mixer::Finish(Voice& v)
+{
+    // at most one id per slot is out, the queue has room for all of them
+    const bool queued = finished.Push(v.id);
+    assert(queued);
+    (void)queued;
+    v.id = 0;
+}
+
+void Mixer::MixVoice(Voice& v, int32_t* out, int frames)
+{
+    const uint64_t end = static_cast<uint64_t>(v.length) << 16;
+    for (int f = 0; f < frames; ++f)
+    {
+        if (v.position >= end)
+        {
+            if (!v.loop)
+            {
+                Finish(v);
+                return;
+            }
+            v.position %= end;
+        }
+        const uint32_t i = static_cast<uint32_t>(v.position >> 16);
+        const int32_t frac = static_cast<int32_t>(v.position & 0xffff);
+        // past the last frame a loop goes on with the first, a sample
+        // played once holds its last
+        const int32_t s0 = v.frames[i];
+        const int32_t s1 = i + 1 < v.length ? v.frames[i + 1] : v.loop ? v.frames[0] : s0;
+        const int32_t s = s0 + static_cast<int32_t>((static_cast<int64_t>(s1 - s0) * frac) >> 16);
+        out[channelCount * f] += (s * v.gain[0]) >> gainBits;
+        out[channelCount * f + 1] += (s * v.gain[1]) >> gainBits;
+        v.position += v.step;
+    }
+}
+
+void Mixer::Mix(int16_t* out, int frames)
+{
+    Command c;
+    while (commands.Pop(c))
+    {
+        Execute(c);
+    }
+    for (int done = 0; done < frames;)
+    {
+        const int n = std::min(blockFrames, frames - done);
+        std::fill(block, block + n * channelCount, 0);
+        for (Voice& v : voices)
+        {
+            if (v.id != 0)
+            {
+                MixVoice(v, block, n);
+            }
+        }
+        int16_t* o = out + done * channelCount;
+        for (int i = 0; i < n * channelCount; ++i)
+        {
+            const int64_t s = (static_cast<int64_t>(block[i]) * masterGain) >> gainBits;
+            o[i] = static_cast<int16_t>(std::min<int64_t>(std::max<int64_t>(s, -32768), 32767));
+        }
+        done += n;
+    }
+    mixedFrames.fetch_add(static_cast<uint64_t>(frames), std::memory_order_relaxed);
+}
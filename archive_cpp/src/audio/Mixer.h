@@ -0,0 +1,112 @@
+#ifndef MIXER_H
+#define MIXER_H
+
+#include "audio/Sample.h"
+#include "utils/SpscQueue.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Mixes up to voiceCount samples into interleaved stereo 16 bit frames.
+// One game thread starts and stops voices, the audio thread calls Mix;
+// the two only talk through lock-free queues. Commands go one way,
+// finished voices come back the other, and the game side keeps every
+// playing sample alive until its voice is reported finished, so the audio
+// thread never allocates, frees, locks or waits. Samples are resampled to
+// the output rate with linear interpolation.
+class Mixer
+{
+public:
+    static constexpr int voiceCount = 32;
+    static constexpr int channelCount = 2;
+    // 0 is no voice
+    typedef uint32_t VoiceId;
+
+    explicit Mixer(int outputRate);
+
+    // game thread: volume 0..1, pan -1 (left) to 1 (right); 0 when every
+    // voice is busy or the command queue is full
+    VoiceId Play(SamplePtr sample, float volume = 1.0f, float pan = 0.0f, bool loop = false);
+    // game thread: false when the command queue is full; a voice that has
+    // already finished is left alone
+    bool SetVolume(VoiceId voice, float volume, float pan = 0.0f);
+    bool Stop(VoiceId voice);
+    bool StopAll();
+    bool SetMasterVolume(float volume);
+    // game thread: frees the voices the audio thread finished and drops
+    // their samples, Play does it first
+    void CollectFinished();
+    // game thread: voices started and not collected as finished yet
+    int GetBusyVoiceCount() const;
+
+    // audio thread: runs the queued commands and writes frames stereo frames
+    void Mix(int16_t* out, int frames);
+
+    int GetOutputRate() const { return outputRate; }
+    // any thread: frames Mix has written so far
+    uint64_t GetMixedFrames() const { return mixedFrames.load(std::memory_order_relaxed); }
+private:
+    static constexpr int slotBits = 6;
+    static_assert(voiceCount <= (1 << slotBits), "voice slots fit the id");
+    static constexpr uint32_t slotMask = (1u << slotBits) - 1;
+    // ids stay non zero and within 32 bits
+    static constexpr uint32_t maxGeneration = (1u << (32 - slotBits)) - 1;
+    static constexpr int blockFrames = 256;
+    // gains are fixed point, gainOne is 1.0
+    static constexpr int gainBits = 12;
+    static constexpr int32_t gainOne = 1 << gainBits;
+
+    enum class CommandType : uint8_t
+    {
+        Play,
+        SetGain,
+        Stop,
+        StopAll,
+        SetMasterGain
+    };
+
+    struct Command
+    {
+        CommandType     type = CommandType::Stop;
+        bool            loop = false;
+        VoiceId         voice = 0;
+        const int16_t*  frames = nullptr;
+        uint32_t        length = 0;
+        uint32_t        step = 0;
+        int32_t         gain[channelCount] = {0, 0};
+    };
+
+    struct Voice
+    {
+        VoiceId         id = 0;         // 0: free
+        const int16_t*  frames = nullptr;
+        uint32_t        length = 0;
+        bool            loop = false;
+        // in sample frames, 16.16 fixed point
+        uint64_t        position = 0;
+        uint32_t        step = 0;
+        int32_t         gain[channelCount] = {0, 0};
+    };
+
+    static int32_t ToGain(float volume);
+    bool Send(const Command& c);
+    // audio thread
+    void Execute(const Command& c);
+    void Finish(Voice& v);
+    void MixVoice(Voice& v, int32_t* out, int frames);
+
+    const int                           outputRate;
+    SpscQueue<Command, 256>             commands;
+    SpscQueue<VoiceId, voiceCount>      finished;
+    // game side: the id and sample of each slot until it is collected
+    VoiceId                             ids[voiceCount] = {};
+    SamplePtr                           playing[voiceCount];
+    uint32_t                            generation = 0;
+    // audio side
+    Voice                               voices[voiceCount];
+    int32_t                             masterGain = gainOne;
+    int32_t                             block[blockFrames * channelCount];
+    std::atomic<uint64_t>               mixedFrames{0};
+};
+
+#endif // MIXER_H
@@ -0,0 +1,21 @@
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include "utils/MemoryStats.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// A decoded sound: mono 16 bit frames played at rate frames per second.
+// Immutable once made, shared by the bank and the voices playing it.
+struct Sample
+{
+    int                     rate = 22050;
+    std::vector<int16_t>    frames;
+    MemoryCharge            memory;
+};
+
+typedef std::shared_ptr<const Sample> SamplePtr;
+
+#endif // SAMPLE_H
@@ -0,0 +1,42 @@
+#include "SampleBank.h"
+#include "data/Jazz2AnimFormat.h"
+
+#include <algorithm>
+
+SampleBank::SampleBank(const Jazz2AnimFormat& anims)
+    : anims(anims)
+    , sets(anims.GetAnimationSetLength())
+    , decoded(anims.GetAnimationSetLength(), false)
+{
+}
+
+int SampleBank::GetSetCount() const
+{
+    return static_cast<int>(sets.size());
+}
+
+int SampleBank::GetSampleCount(int set) const
+{
+    return set >= 0 && set < GetSetCount() ? static_cast<int>(anims.GetSampleCount(set)) : 0;
+}
+
+SamplePtr SampleBank::Get(int set, int index)
+{
+    if (index < 0 || index >= GetSampleCount(set))
+    {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!decoded[set])
+    {
+        sets[set] = anims.DecodeSamples(set);
+        decoded[set] = true;
+    }
+    return sets[set][index];
+}
+
+int SampleBank::GetDecodedSetCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(std::count(decoded.begin(), decoded.end(), true));
+}
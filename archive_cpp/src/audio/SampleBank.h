@@ -0,0 +1,36 @@
+#ifndef SAMPLEBANK_H
+#define SAMPLEBANK_H
+
+#include "audio/Sample.h"
+
+#include <mutex>
+#include <vector>
+
+class Jazz2AnimFormat;
+
+// The samples of an animation file, decoded on first use. The file keeps
+// each set's sample block compressed; the first Get of a set inflates the
+// block and decodes all of its samples, which then stay in the bank until
+// it goes. Voices hold their own reference, so dropping the bank does not
+// cut off what is playing. Any thread may call Get.
+class SampleBank
+{
+public:
+    // anims outlives the bank
+    explicit SampleBank(const Jazz2AnimFormat& anims);
+
+    int GetSetCount() const;
+    int GetSampleCount(int set) const;
+    // nullptr for an index out of range, throws std::runtime_error when
+    // the set's samples are corrupt
+    SamplePtr Get(int set, int index);
+    // sets decoded so far
+    int GetDecodedSetCount() const;
+private:
+    const Jazz2AnimFormat&              anims;
+    mutable std::mutex                  mutex;
+    std::vector<std::vector<SamplePtr>> sets;
+    std::vector<bool>                   decoded;
+};
+
+#endif // SAMPLEBANK_H
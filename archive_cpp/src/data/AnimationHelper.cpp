@@ -3,24 +3,14 @@
 #include "gfx/GraphicsEngine.h"
 
 AnimationHelper::AnimationHelper(const Jazz2AnimFormat& anim)
-    : AnimationHelper(anim, false)
-{ }
-
-AnimationHelper::AnimationHelper(const Jazz2AnimFormat &anim, bool loadFlippedAlso)
     : animations(anim)
-    , loadFlipped(loadFlippedAlso)
 { }
 
 Animation AnimationHelper::GetAnimation(int animSet, int animId, bool flipped,
                                          LevelPalette pal) const
 {
     Palette& palette =  generatePalette(pal)       ;
-    auto a = animations.GetAnimation(animSet, animId, flipped, palette);
-    if (loadFlipped)
-    {
-        a.SetUpMirroredFrames();
-    }
-    return a;
+    return animations.GetAnimation(animSet, animId, flipped, palette);
 }
 
 Animation AnimationHelper::GetAnimation(int animSet, int animId)
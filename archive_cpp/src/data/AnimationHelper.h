@@ -18,13 +18,11 @@ class AnimationHelper
 {
 public:
     AnimationHelper(const Jazz2AnimFormat& anim);
-    AnimationHelper(const Jazz2AnimFormat &anim, bool loadFlippedAlso);
     Animation GetAnimation(int animSet, int animId);
     Animation GetAnimation(int animSet, int animId, bool flipped,
                                              LevelPalette pal) const;
 private:
     const Jazz2AnimFormat&  animations;
-    const bool              loadFlipped;
     Palette& generatePalette(LevelPalette pal) const;
     void MapPalette(Palette& palette, int factor) const;
 };
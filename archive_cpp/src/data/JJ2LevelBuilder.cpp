@@ -1,13 +1,10 @@
 #include "JJ2LevelBuilder.h"
 
 #include "game/WorldTransformations.h"
-#include "game/events/UnknownEvent.h"
-#include "game/events/StandardEvent.h"
-#include "game/events/BonusItem.h"
-#include "game/events/SpringEvent.h"
 #include "gfx/GraphicsEngine.h"
 
 #include <boost/format.hpp>
+#include <algorithm>
 
 std::vector<EventAnim> JJ2LevelBuilder::JJ2EvAnims =
 {
@@ -96,64 +93,54 @@ JJ2LevelBuilder::JJ2LevelBuilder(const Jazz2LevelFormat& lev, const Jazz2AnimFor
     , animations(anim)
 { }
 
-Layer JJ2LevelBuilder::ConvertFromJJ2Layer(const J2Layer& jj2_layer) const
+TileSetPtr JJ2LevelBuilder::BuildTileSet(const Jazz2TileFormat& tileset) const
 {
-    Layer layer{jj2_layer.width * 32, jj2_layer.height * 32,
-                jj2_layer.tileX, jj2_layer.tileY, jj2_layer.limit,
-                jj2_layer.warp, static_cast<unsigned>(jj2_layer.grid.size())};
-
-    return layer;
+    TileSetPtr ts = std::make_shared<TileSet>(level.AnimOffset);
+    const auto& tiles = tileset.GetTileSet();
+    const auto& flippedTiles = tileset.GetFlippedTileSet();
+    for (unsigned int i = 0; i < tiles.size(); ++i)
+    {
+        ts->AddTile(tiles[i].Image, flippedTiles[i].Image,
+                    &(*tiles[i].collisionMap)[0], &(*flippedTiles[i].collisionMap)[0]);
+        ts->SetIndexedImages(static_cast<TileId>(i), tiles[i].IndexedImage, flippedTiles[i].IndexedImage);
+    }
+    TileId animId = static_cast<TileId>(level.AnimOffset);
+    for (const auto& jj2AnimTile : level.getAnimTiles())
+    {
+        ts->AddAnimatedTile(GetAnimatedTile(jj2AnimTile, tileset));
+        ts->SetAnimatedTileFrames(animId++, GetAnimatedTileFrames(jj2AnimTile, tileset));
+    }
+    return ts;
 }
 
-Tile JJ2LevelBuilder::ConvertFromJJ2Tile(const J2TileId& jj2_tile_id,
-                                          const Jazz2TileFormat& tileset) const
+Layer JJ2LevelBuilder::ConvertFromJJ2Layer(const J2Layer& jj2_layer, const TileSetPtr& tileSet,
+                                           Arena* arena) const
 {
-    Tile rm2tile;
-
-    rm2tile.tc = {jj2_tile_id.x, jj2_tile_id.y};
-    int x = rm2tile.tc.ToUnivCoord().x;
-    int y = rm2tile.tc.ToUnivCoord().y;
-    rm2tile.x = x;
-    rm2tile.y = y;
+    Layer layer{jj2_layer.width, jj2_layer.height,
+                jj2_layer.tileX, jj2_layer.tileY, jj2_layer.limit,
+                jj2_layer.warp, tileSet, arena};
 
-    const J2Tile* tile_res = nullptr;
-    auto maxTiles = tileset.GetTileSet().size();
-    if (jj2_tile_id.flipped)
+    for (const auto& t : jj2_layer.grid)
     {
-        if (jj2_tile_id.id < static_cast<int>(maxTiles))
-        {
-            tile_res = &tileset.GetFlippedTileSet()[jj2_tile_id.id];
-            rm2tile.SetCollisionMap(tile_res->collisionMap);
-            rm2tile.AddSurface(tile_res->Image);
-        }
-        else
+        if (t.id != 0)
         {
-            // TODO: Add collision data in case of anim tiles
-            rm2tile.AddAnimation(GetAnimatedTile(jj2_tile_id.id, tileset));
-        }
-    }
-    else
-    {
-        if (jj2_tile_id.id < static_cast<int>(maxTiles))
-        {
-            tile_res = &tileset.GetTileSet()[jj2_tile_id.id];
-            rm2tile.SetCollisionMap(tile_res->collisionMap);
-            rm2tile.AddSurface(tile_res->Image);
-        }
-        else
-        {
-            // TODO: Add collision data in case of anim tiles
-            rm2tile.AddAnimation(GetAnimatedTile(jj2_tile_id.id, tileset));
+            layer.SetTile(t.x, t.y, static_cast<TileId>(t.id), t.flipped);
         }
     }
 
-    return rm2tile;
+    return layer;
 }
 
-LevelEntities JJ2LevelBuilder::LoadEvents()
+LevelEntities JJ2LevelBuilder::LoadEvents(Arena* arena)
 {
     LevelEntities en;
-    en.events.reserve(level.getEvents().size());
+    en.events = EventStore(arena);
+    const auto& events = level.getEvents();
+    en.events.Reserve(static_cast<int>(std::count_if(events.begin(), events.end(), [](const J2Event& e)
+    {
+        return e.EventId != NoEvent;
+    })));
+    std::map<int, int> animationIds;
     for (auto& j2ev: level.getEvents())
     {
         if (j2ev.EventId == HeroStartPos)
@@ -164,52 +151,69 @@ LevelEntities JJ2LevelBuilder::LoadEvents()
         }
         if (j2ev.EventId != NoEvent)
         {
-            en.events.push_back(ConvertFromJJ2Event(j2ev));
+            ConvertFromJJ2Event(j2ev, en.events, animationIds);
         }
     }
     return en;
 }
 
-EventPtr JJ2LevelBuilder::ConvertFromJJ2Event(const J2Event& jj2_ev) const
+void JJ2LevelBuilder::ConvertFromJJ2Event(const J2Event& jj2_ev, EventStore& store,
+                                          std::map<int, int>& animationIds) const
 {
-    IEvent* ev = nullptr;
+    const int id = jj2_ev.EventId;
     bool isFlipped = false;
+    TileCoordinates tc{jj2_ev.x, jj2_ev.y};
+    Point2D pos = tc.ToUnivCoord();
+
+    // all events with the same id share one animation
+    auto animationFor = [&](auto load)
+    {
+        auto it = animationIds.find(id);
+        if (it == animationIds.end())
+        {
+            Animation a = load();
+            int animId = a.FrameCount() > 0 ? store.AddAnimation(a) : EventStore::none;
+            it = animationIds.emplace(id, animId).first;
+        }
+        return it->second;
+    };
 
-    if ((jj2_ev.EventId < 33)
-        || ((jj2_ev.EventId >= 206) && (jj2_ev.EventId <= 208))
-        || (jj2_ev.EventId == 230)
-        || (jj2_ev.EventId == 240)
-        || (jj2_ev.EventId == 245))
+    if ((id < 33)
+        || ((id >= 206) && (id <= 208))
+        || (id == 230)
+        || (id == 240)
+        || (id == 245))
     {
-        auto* ev_ = new UnknownEvent;
-        ev_->SetDisplayMessage((boost::format("id%1%") % (int)jj2_ev.EventId).str());
-        ev = ev_;
+        int e = store.Add(EventType::Unknown, id, pos);
+        store.SetMessage(e, (boost::format("id%1%") % id).str());
     }    
-    else if (jj2_ev.EventId <= 40 && jj2_ev.EventId >= 33)
+    else if (id <= 40 && id >= 33)
     {
         // Ammo
-        auto* ev_ = new StandardEvent;
-        ev_->AddAnimation(animations.GetAnimation(0, ammoAnims[jj2_ev.EventId - 33], isFlipped,
-                        SelectPaletteForEvent(jj2_ev.EventId)));
-        ev = ev_;
+        int e = store.Add(EventType::Standard, id, pos);
+        store.SetAnimation(e, animationFor([&]()
+        {
+            return animations.GetAnimation(0, ammoAnims[id - 33], isFlipped,
+                                           SelectPaletteForEvent(id));
+        }));
     }
-    else if (isBonusEvent(jj2_ev.EventId))
+    else if (isBonusEvent(id))
     {
-        auto* ev_ = new BonusItem;
-        ev_->AddAnimation(GetAnimationFromMap(jj2_ev.EventId,
-                                             isFlipped,
-                                             SelectPaletteForEvent(jj2_ev.EventId))
-                         );
-        ev = ev_;
+        int e = store.Add(EventType::Bonus, id, pos);
+        store.SetAnimation(e, animationFor([&]()
+        {
+            return GetAnimationFromMap(id, isFlipped, SelectPaletteForEvent(id));
+        }));
     }
-    else if (jj2_ev.EventId == RedSpring || jj2_ev.EventId == GreenSpring || jj2_ev.EventId == BlueSpring)
+    else if (id == RedSpring || id == GreenSpring || id == BlueSpring)
     {
-        auto* ev_ = new SpringEvent(GetAnimationFromMap(jj2_ev.EventId,
-                                                        isFlipped,
-                                                        SelectPaletteForEvent(jj2_ev.EventId)));
-        ev = ev_;
+        int e = store.Add(EventType::Spring, id, pos);
+        store.SetAnimation(e, animationFor([&]()
+        {
+            return GetAnimationFromMap(id, isFlipped, SelectPaletteForEvent(id));
+        }));
     }
-    else if (jj2_ev.EventId == Generator)
+    else if (id == Generator)
     {
         unsigned char b1 = jj2_ev.Params[0];
         unsigned char b2 = jj2_ev.Params[1];
@@ -218,33 +222,27 @@ EventPtr JJ2LevelBuilder::ConvertFromJJ2Event(const J2Event& jj2_ev) const
         ev_id |=                  (b2 & 0xf) << 4;
         int delay =               (b2 & 0xf0) >> 4;
         delay |=                  (b3 & 0x1) << 4;
-        auto* ev_ = new UnknownEvent;
-        ev_->SetDisplayMessage((boost::format("G %1% %2%") % ev_id % delay).str() );
-        ev = ev_;
+        int e = store.Add(EventType::Unknown, id, pos);
+        store.SetMessage(e, (boost::format("G %1% %2%") % ev_id % delay).str());
     }
     else
     {
-        auto a = GetAnimationFromMap(jj2_ev.EventId, isFlipped);
-        if (a.FrameCount() > 0)
+        int animId = animationFor([&]()
+        {
+            return GetAnimationFromMap(id, isFlipped);
+        });
+        if (animId != EventStore::none)
         {
-            auto* ev_ = new StandardEvent;
-            ev_->AddAnimation(GetAnimationFromMap(jj2_ev.EventId, isFlipped));
-            ev_->SetDisplayMessage((boost::format("S %1%") % (int)jj2_ev.EventId).str());
-            ev = ev_;
+            int e = store.Add(EventType::Standard, id, pos);
+            store.SetAnimation(e, animId);
+            store.SetMessage(e, (boost::format("S %1%") % id).str());
         }
         else
         {
-            auto* ev_ = new UnknownEvent;
-            ev_->SetDisplayMessage((boost::format("U %1%") % (int)jj2_ev.EventId).str());
-            ev = ev_;
+            int e = store.Add(EventType::Unknown, id, pos);
+            store.SetMessage(e, (boost::format("U %1%") % id).str());
         }
     }
-
-    TileCoordinates tc{jj2_ev.x, jj2_ev.y};
-    ev->SetPosition(tc.ToUnivCoord(), tc);
-    ev->SetId(jj2_ev.EventId);
-
-    return EventPtr{ev};
 }
 
 bool JJ2LevelBuilder::isBonusEvent(int jje_ev_id) const
@@ -317,29 +315,17 @@ LevelPalette JJ2LevelBuilder::SelectPaletteForEvent(int eventId) const
     return LevelPalette::global;
 }
 
-Animation JJ2LevelBuilder::GetAnimatedTile(int tileId, const Jazz2TileFormat& tileset) const
+Animation JJ2LevelBuilder::GetAnimatedTile(const Animated_Tile& jj2AnimTile,
+                                           const Jazz2TileFormat& tileset) const
 {
-    //unsigned int tileCount = level.getTiles().tiles.size();
-    auto& animationSet = level.getAnimTiles();
-    //int animId = tileId % tileCount % animationSet.size();
-    int animId = tileId - level.AnimOffset;
-    assert(animId < (int)animationSet.size());
-    auto& jj2AnimTile = animationSet[animId];
-
     const auto& tiles = tileset.GetTileSet();
+    const auto& flippedTiles = tileset.GetFlippedTileSet();
 
     Animation anim(jj2AnimTile.Speed);
 
-    for (int f = 0; f < jj2AnimTile.FrameCount; ++f)
+    for (const auto& f : GetAnimatedTileFrames(jj2AnimTile, tileset))
     {
-        if (jj2AnimTile.Frame[f] != 0)
-        {
-            anim.PushFrame(tiles[jj2AnimTile.Frame[f]].Image);
-        }
-        else
-        {
-            anim.PushFrame(SurfaceSharedPtr());
-        }
+        anim.PushFrame(f.second ? flippedTiles[f.first].Image : tiles[f.first].Image);
     }
 
     assert(anim.FrameCount() > 0);
@@ -356,7 +342,7 @@ Animation JJ2LevelBuilder::GetAnimatedTile(int tileId, const Jazz2TileFormat& ti
         anim.SetStrategy(AnimationStrategy::Normal);
     }
 
-    return std::move(anim);
+    return anim;
 }
 
 Animation JJ2LevelBuilder::GetAnimationFromMap(int eventId, bool isFlipped,
@@ -382,3 +368,23 @@ Animation JJ2LevelBuilder::GetAnimationFromMap(int eventId, bool isFlipped,
     }
     return {};
 }
+
+std::vector<std::pair<TileId, bool>> JJ2LevelBuilder::GetAnimatedTileFrames(const Animated_Tile& jj2AnimTile,
+                                                                            const Jazz2TileFormat& tileset) const
+{
+    const int flipBit = level.isTSF() ? 0x1000 : 0x400;
+    std::vector<std::pair<TileId, bool>> frames;
+    for (int f = 0; f < jj2AnimTile.FrameCount; ++f)
+    {
+        int frame = static_cast<unsigned short>(jj2AnimTile.Frame[f]);
+        bool flipped = frame & flipBit;
+        unsigned int id = frame & (flipBit - 1);
+        if (id >= tileset.GetTileSet().size())
+        {
+            // TODO: frames referring to other animated tiles, tile 0 is always empty
+            id = 0;
+        }
+        frames.emplace_back(static_cast<TileId>(id), flipped);
+    }
+    return frames;
+}
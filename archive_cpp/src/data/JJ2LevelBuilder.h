@@ -6,6 +6,8 @@
 #include "data/AnimationHelper.h"
 #include "data/Jazz2LevelFormat.h"
 
+#include <map>
+
 /// Look-up table for ammo animations (in animSet 0)
 const unsigned ammoAnims[] = {
     29, // Ice
@@ -139,7 +141,7 @@ enum Generators
 
 struct LevelEntities
 {
-    std::vector<EventPtr>   events;
+    EventStore              events;
     Point2D                 heroStartPosition;
 };
 
@@ -147,19 +149,24 @@ struct JJ2LevelBuilder
 {
 public:
     JJ2LevelBuilder(const Jazz2LevelFormat& lev, const Jazz2AnimFormat& anim);
-    Layer ConvertFromJJ2Layer(const J2Layer& jj2_layer) const;
-    Tile ConvertFromJJ2Tile(const J2TileId& jj2_tile_id,
-                            const Jazz2TileFormat& tileset) const;            
-    LevelEntities LoadEvents();    
+    TileSetPtr BuildTileSet(const Jazz2TileFormat& tileset) const;
+    // the grids and the event arrays are allocated in arena
+    Layer ConvertFromJJ2Layer(const J2Layer& jj2_layer, const TileSetPtr& tileSet, Arena* arena) const;
+    LevelEntities LoadEvents(Arena* arena);
 private:
     static std::vector<EventAnim>   JJ2EvAnims;
     const Jazz2LevelFormat&         level;
     AnimationHelper                 animations;
 
-    EventPtr ConvertFromJJ2Event(const J2Event& jj2_ev) const;
+    // animationIds caches the animation of every event id already loaded
+    void ConvertFromJJ2Event(const J2Event& jj2_ev, EventStore& store,
+                             std::map<int, int>& animationIds) const;
     bool isBonusEvent(int jje_ev_id) const;
     LevelPalette SelectPaletteForEvent(int eventId) const;
-    Animation GetAnimatedTile(int tileId, const Jazz2TileFormat& tileset) const;
+    Animation GetAnimatedTile(const Animated_Tile& jj2AnimTile, const Jazz2TileFormat& tileset) const;
+    // static tile (id, flipped) of every frame
+    std::vector<std::pair<TileId, bool>> GetAnimatedTileFrames(const Animated_Tile& jj2AnimTile,
+                                                               const Jazz2TileFormat& tileset) const;
     Animation GetAnimationFromMap(int eventId, bool isFlipped,
                                   LevelPalette pal = LevelPalette::global) const;
 
@@ -1,10 +1,17 @@
 #include "Jazz2AnimFormat.h"
 #include "utils/BinaryReader.h"
+#include "utils/BinaryView.h"
+#include "utils/BinaryWriter.h"
+#include "utils/JobSystem.h"
+#include "utils/MemoryStats.h"
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 #include <assert.h>
 #include <cstdint>
+#include <cstring>
 
 // helper structs
 
@@ -41,6 +48,23 @@ struct ALIB_Header
         }
         return s;
     }
+
+    void write(std::vector<char>& out) const
+    {
+        using BinaryWriter::write;
+        write(out, Magic);
+        write(out, Unknown1);
+        write(out, HeaderSize);
+        write(out, Version);
+        write(out, Unknown2);
+        write(out, FileSize);
+        write(out, CRC32);
+        write(out, SetCount);
+        for (int32_t sa : SetAddress)
+        {
+            write(out, sa);
+        }
+    }
 };
 
 struct ANIM_Header
@@ -78,6 +102,24 @@ struct ANIM_Header
         read(s, UData4);
         return s;
     }
+
+    void write(std::vector<char>& out) const
+    {
+        using BinaryWriter::write;
+        write(out, Magic);
+        write(out, AnimationCount);
+        write(out, SampleCount);
+        write(out, FrameCount);
+        write(out, SampleUnknown);
+        write(out, CData1);
+        write(out, UData1);
+        write(out, CData2);
+        write(out, UData2);
+        write(out, CData3);
+        write(out, UData3);
+        write(out, CData4);
+        write(out, UData4);
+    }
 };
 
 struct AnimInfo
@@ -94,6 +136,14 @@ struct AnimInfo
         s = read(s, Reserved);
         return s;
     }
+
+    void write(std::vector<char>& out) const
+    {
+        using BinaryWriter::write;
+        write(out, FrameCount);
+        write(out, FPS);
+        write(out, Reserved);
+    }
 };
 
 struct FrameInfo
@@ -124,6 +174,21 @@ struct FrameInfo
         s = read(s, MaskAddress);
         return s;
     }
+
+    void write(std::vector<char>& out) const
+    {
+        using BinaryWriter::write;
+        write(out, Width);
+        write(out, Height);
+        write(out, ColdspotX);
+        write(out, ColdspotY);
+        write(out, HotspotX);
+        write(out, HotspotY);
+        write(out, GunspotX);
+        write(out, GunspotY);
+        write(out, ImageAddress);
+        write(out, MaskAddress);
+    }
 };
 
 struct J2Image
@@ -134,6 +199,7 @@ struct J2Image
     std::unique_ptr<int[]> pixels;
 
     int32_t imageAddress;
+    MemoryCharge memory;
 
     J2Image() : width(0), height(0), imageAddress(0) { }
     J2Image(int width_, int height_)
@@ -147,12 +213,14 @@ struct J2Image
         , height(img.height)
         , pixels(std::move(img.pixels))
         , imageAddress(img.imageAddress)
+        , memory(std::move(img.memory))
     { }
 
     const char* read(const char* s)
     {
         using BinaryReader::read;
         pixels.reset(new int[width*height]);
+        memory.Set(MemoryCategory::AnimSet, width * height * sizeof(int));
 
         int pixel_index = 0;
         while (pixel_index < width*height)
@@ -219,6 +287,8 @@ struct J2Frame
 
 struct J2Animation
 {
+    enum { font_frame_count = 224 };
+
     AnimInfo info;
     std::vector<J2Frame> frames;
 
@@ -229,6 +299,112 @@ struct J2Animation
     { }
 };
 
+// Data4 holds the samples of a set one after another, each a RIFF chunk:
+// the header, 12 zero bytes in the ASFF format of 1.20 only, the format
+// fields, the data and a 4 byte trailer
+#define SAMPLE_HEADER_FIELDS(X) \
+    X(TotalSize, int32_t) /* of the whole sample, up to the next one */ \
+    X(RiffMagic, char[4]) /* "RIFF" */ \
+    X(ChunkSize, int32_t) /* from Format on */ \
+    X(Format, char[4]) /* "AS  " in 1.24, "ASFF" in 1.20 */ \
+    X(SampMagic, char[4]) /* "SAMP" */ \
+    X(SampChunkSize, int32_t) \
+    X(Reserved1, char[40])
+
+#define SAMPLE_FORMAT_FIELDS(X) \
+    X(Flags, uint16_t) /* 0x4: 16 bit signed, else 8 bit unsigned */ \
+    X(Reserved2, uint16_t) \
+    X(PayloadSize, int32_t) \
+    X(Reserved3, char[8]) \
+    X(Rate, int32_t) /* frames per second */
+
+class SampleHeaderView
+{
+    BINARY_VIEW_BODY(SampleHeaderView, SAMPLE_HEADER_FIELDS)
+};
+
+struct SampleHeader
+{
+    BINARY_STRUCT_BODY(SAMPLE_HEADER_FIELDS)
+};
+
+class SampleFormatView
+{
+    BINARY_VIEW_BODY(SampleFormatView, SAMPLE_FORMAT_FIELDS)
+};
+
+struct SampleFormat
+{
+    BINARY_STRUCT_BODY(SAMPLE_FORMAT_FIELDS)
+};
+
+static constexpr size_t asffPadding = 12;
+static constexpr size_t sampleTrailer = 4;
+static constexpr uint16_t sixteenBitSample = 0x4;
+// what ChunkSize counts beside the data, in the 1.24 layout
+static constexpr size_t sampleChunkOverhead = SampleHeaderView::Size() -
+    SampleHeaderView::Offset(SampleHeaderView::FormatField) + SampleFormatView::Size() + sampleTrailer;
+static_assert(SampleHeaderView::Size() + SampleFormatView::Size() == 84, "sample header layout");
+static_assert(sampleChunkOverhead == 76, "sample chunk layout");
+
+// the sample block of a set, as it is in the file
+struct J2SampleSet
+{
+    int                     count;
+    unsigned long           compressedSize;
+    unsigned long           size;
+    std::unique_ptr<char[]> compressed;
+    MemoryCharge            memory;
+
+    J2SampleSet(const ANIM_Header& header, std::unique_ptr<char[]> data)
+        : count(header.SampleCount)
+        , compressedSize(header.CData4)
+        , size(header.UData4)
+        , compressed(std::move(data))
+        , memory(MemoryCategory::Audio, header.CData4)
+    { }
+};
+
+// builds the animations of one set from its decompressed data blocks
+static void DecodeSet(const ANIM_Header& anim_header, const char* d1, const char* d2, const char* d3,
+                      std::vector<std::unique_ptr<J2Animation>>& animVec)
+{
+    MemoryScope scope(MemoryCategory::AnimSet);
+    animVec.reserve(anim_header.AnimationCount);
+
+    for (int anim = 0; anim < anim_header.AnimationCount; ++anim)
+    {
+        J2Animation animation;
+        d1 = animation.info.read(d1);
+
+        const bool font = animation.info.FrameCount == J2Animation::font_frame_count;
+        for (int i = 0; i < animation.info.FrameCount; ++i)
+        {
+            J2Frame frame;
+            d2 = frame.info.read(d2);
+            assert(frame.info.Width >= 0);
+            assert(frame.info.Height >= 0);
+            if (frame.info.Width == 0 || frame.info.Height == 0)
+            {
+                // fonts keep the empty glyphs, frame index == character - 32
+                if (font)
+                {
+                    frame.info.Width = 0;
+                    frame.info.Height = 0;
+                    animation.frames.push_back(std::move(frame));
+                }
+                continue;
+            }
+
+            frame.image.width = frame.info.Width;
+            frame.image.height = frame.info.Height;
+            frame.image.read(d3 + frame.info.ImageAddress);
+            animation.frames.push_back(std::move(frame));
+        }
+        animVec.push_back(std::unique_ptr<J2Animation>{new J2Animation(std::move(animation))});
+    }
+}
+
 Jazz2AnimFormat::Jazz2AnimFormat(const std::string& filename)
 {
     std::ifstream file(filename.c_str(), std::ios_base::in | std::ios_base::binary);
@@ -240,94 +416,259 @@ Jazz2AnimFormat::Jazz2AnimFormat(const std::string& filename)
     ALIB_Header header;
     header.read(file);
 
-    _j2Animations.reserve(header.SetCount);
-
+    // the file is read in order, the sets are then decoded in parallel
+    struct SetData
+    {
+        ANIM_Header header;
+        std::unique_ptr<char[]> data1;
+        std::unique_ptr<char[]> data2;
+        std::unique_ptr<char[]> data3;
+    };
+    std::vector<SetData> sets(header.SetCount);
+    _j2Samples.reserve(header.SetCount);
     for (int set_counter = 0; set_counter < header.SetCount; ++set_counter)
     {
+        SetData& set = sets[set_counter];
         file.seekg(header.SetAddress[set_counter]);
-        ANIM_Header anim_header;
-        anim_header.read(file);
+        set.header.read(file);
         // Data1 (Animation Info)
-        auto data1 = BinaryReader::ReadAndDecompress(file, anim_header.CData1, anim_header.UData1);
+        set.data1 = BinaryReader::ReadAndDecompress(file, set.header.CData1, set.header.UData1);
         // Data2 (Frame Info)
-        auto data2 = BinaryReader::ReadAndDecompress(file, anim_header.CData2, anim_header.UData2);
+        set.data2 = BinaryReader::ReadAndDecompress(file, set.header.CData2, set.header.UData2);
         // Data3 (Image Data)
-        auto data3 = BinaryReader::ReadAndDecompress(file, anim_header.CData3, anim_header.UData3);
-        // Data4 (Sample Data)
-        auto data4 = BinaryReader::ReadAndDecompress(file, anim_header.CData4, anim_header.UData4);
+        set.data3 = BinaryReader::ReadAndDecompress(file, set.header.CData3, set.header.UData3);
+        // Data4 (Sample Data), inflated when a sample of the set is first used
+        _j2Samples.push_back(std::unique_ptr<J2SampleSet>{
+            new J2SampleSet(set.header, BinaryReader::ReadBlock(file, set.header.CData4))});
+    }
 
-        const char* d1 = &data1[0];
-        const char* d2 = &data2[0];
-        const char* d3 = &data3[0];
+    _j2Animations.resize(header.SetCount);
+    JobSystem::Instance().ParallelFor(0, header.SetCount, 1, [&](int first, int last)
+    {
+        for (int set_counter = first; set_counter < last; ++set_counter)
+        {
+            const SetData& set = sets[set_counter];
+            DecodeSet(set.header, &set.data1[0], &set.data2[0], &set.data3[0], _j2Animations[set_counter]);
+        }
+    });
+}
 
-        _j2Animations.push_back({});
-        auto& animVec = _j2Animations[set_counter];
-        animVec.reserve(anim_header.AnimationCount);
+Jazz2AnimFormat::~Jazz2AnimFormat() { }
 
-        for (int anim = 0; anim < anim_header.AnimationCount; ++anim)
+// the codes J2Image::read decodes: runs of skipped pixels (< 0x80), runs of
+// pixels (0x80 + count), 0x80 skips the rest of the row
+static void EncodeImage(const J2FrameContent& f, std::vector<char>& out)
+{
+    using BinaryWriter::write;
+    for (int y = 0; y < f.height; ++y)
+    {
+        const uint8_t* row = &f.pixels[static_cast<size_t>(y) * f.width];
+        int x = 0;
+        while (x < f.width)
         {
-            J2Animation animation;
-            d1 = animation.info.read(d1);
-
-            if (animation.info.FrameCount ==  224)
+            int run = 0;
+            const bool skip = row[x] == 0;
+            while (x + run < f.width && (row[x + run] == 0) == skip && run < 127)
             {
-                // Fonts are loaded separately
-                animation.info.FrameCount = 1;
-            }                        
+                ++run;
+            }
+            // the row end code only skips within a row that has begun
+            if (skip && x + run == f.width && x > 0)
+            {
+                break;
+            }
+            write(out, static_cast<uint8_t>(skip ? run : 0x80 + run));
+            if (!skip)
+            {
+                out.insert(out.end(), row + x, row + x + run);
+            }
+            x += run;
+        }
+        write(out, static_cast<uint8_t>(0x80));
+    }
+}
+
+// a sample in the 1.24 layout
+static void EncodeSample(const J2SampleContent& sample, std::vector<char>& out)
+{
+    using BinaryWriter::write;
+    const size_t dataSize = sample.frames.size() * (sample.sixteenBit ? 2 : 1);
+    SampleHeader header = {};
+    header.TotalSize = static_cast<int32_t>(SampleHeaderView::Size() + SampleFormatView::Size() + dataSize +
+                                            sampleTrailer);
+    memcpy(header.RiffMagic, "RIFF", sizeof(header.RiffMagic));
+    header.ChunkSize = static_cast<int32_t>(sampleChunkOverhead + dataSize);
+    memcpy(header.Format, "AS  ", sizeof(header.Format));
+    memcpy(header.SampMagic, "SAMP", sizeof(header.SampMagic));
+    header.SampChunkSize = static_cast<int32_t>(SampleFormatView::Size() + dataSize);
+    header.write(out);
+    SampleFormat format = {};
+    format.Flags = sample.sixteenBit ? sixteenBitSample : 0;
+    format.PayloadSize = static_cast<int32_t>(dataSize);
+    format.Rate = sample.rate;
+    format.write(out);
+    for (int16_t frame : sample.frames)
+    {
+        if (sample.sixteenBit)
+        {
+            write(out, frame);
+        }
+        else
+        {
+            write(out, static_cast<uint8_t>((frame >> 8) + 128));
+        }
+    }
+    out.insert(out.end(), sampleTrailer, 0);
+}
 
-            for (int i = 0; i < animation.info.FrameCount; ++i)
+void Jazz2AnimFormat::Write(const std::string& filename, const J2AnimSetsContent& sets,
+                            const J2SampleSetsContent& samples)
+{
+    using BinaryWriter::Compress;
+    if (samples.size() > sets.size())
+    {
+        throw std::runtime_error("Animation file " + filename + ": samples for sets it does not have.");
+    }
+    const std::vector<J2SampleContent> noSamples;
+    std::vector<std::vector<char>> setData;
+    setData.reserve(sets.size());
+    for (const auto& animations : sets)
+    {
+        const auto& setSamples = setData.size() < samples.size() ? samples[setData.size()] : noSamples;
+        if (animations.size() > 255 || setSamples.size() > 255)
+        {
+            throw std::runtime_error("Animation file " + filename +
+                                     ": more than 255 animations or samples in a set.");
+        }
+        std::vector<char> data1;
+        std::vector<char> data2;
+        std::vector<char> data3;
+        int frameCount = 0;
+        for (const auto& a : animations)
+        {
+            AnimInfo info;
+            info.FrameCount = static_cast<short>(a.frames.size());
+            info.FPS = a.fps;
+            info.Reserved = 0;
+            info.write(data1);
+            for (const auto& f : a.frames)
             {
-                J2Frame frame;
-                d2 = frame.info.read(d2);
-                assert(frame.info.Width >= 0);
-                assert(frame.info.Height >= 0);
-                if (frame.info.Width == 0 || frame.info.Height == 0)
+                if (f.pixels.size() != static_cast<size_t>(f.width) * f.height)
                 {
-                    continue;
+                    throw std::runtime_error("Animation file " + filename + ": frame size and pixels differ.");
                 }
-
-                frame.image.width = frame.info.Width;
-                frame.image.height = frame.info.Height;
-                frame.image.read(d3 + frame.info.ImageAddress);
-                animation.frames.push_back(std::move(frame));
+                FrameInfo fi;
+                fi.Width = f.width;
+                fi.Height = f.height;
+                fi.ColdspotX = f.coldspotX;
+                fi.ColdspotY = f.coldspotY;
+                fi.HotspotX = f.hotspotX;
+                fi.HotspotY = f.hotspotY;
+                fi.GunspotX = f.gunspotX;
+                fi.GunspotY = f.gunspotY;
+                fi.ImageAddress = static_cast<int32_t>(data3.size());
+                fi.MaskAddress = 0;
+                fi.write(data2);
+                EncodeImage(f, data3);
+                ++frameCount;
             }
-            animVec.push_back(std::unique_ptr<J2Animation>{new J2Animation(std::move(animation))});
         }
+        std::vector<char> data4;
+        for (const auto& sample : setSamples)
+        {
+            EncodeSample(sample, data4);
+        }
+        const std::vector<char> blocks[4] = {Compress(data1), Compress(data2), Compress(data3), Compress(data4)};
+        ANIM_Header header;
+        memcpy(header.Magic, "ANIM", sizeof(header.Magic));
+        header.AnimationCount = static_cast<unsigned char>(animations.size());
+        header.SampleCount = static_cast<unsigned char>(setSamples.size());
+        header.FrameCount = static_cast<short>(frameCount);
+        header.SampleUnknown = 0;
+        header.CData1 = blocks[0].size();
+        header.UData1 = data1.size();
+        header.CData2 = blocks[1].size();
+        header.UData2 = data2.size();
+        header.CData3 = blocks[2].size();
+        header.UData3 = data3.size();
+        header.CData4 = blocks[3].size();
+        header.UData4 = data4.size();
+        setData.push_back({});
+        header.write(setData.back());
+        for (const auto& b : blocks)
+        {
+            setData.back().insert(setData.back().end(), b.begin(), b.end());
+        }
+    }
 
+    ALIB_Header header;
+    memcpy(header.Magic, "ALIB", sizeof(header.Magic));
+    header.SetCount = static_cast<int32_t>(sets.size());
+    header.HeaderSize = 28 + 4 * header.SetCount;
+    int32_t address = header.HeaderSize;
+    uLong crc = ::crc32(0, Z_NULL, 0);
+    for (const auto& s : setData)
+    {
+        header.SetAddress.push_back(address);
+        address += static_cast<int32_t>(s.size());
+        crc = ::crc32(crc, reinterpret_cast<const Bytef*>(s.data()), s.size());
     }
+    header.FileSize = address;
+    header.CRC32 = static_cast<int32_t>(crc);
+
+    std::vector<char> out;
+    out.reserve(address);
+    header.write(out);
+    assert(static_cast<int32_t>(out.size()) == header.HeaderSize);
+    for (const auto& s : setData)
+    {
+        out.insert(out.end(), s.begin(), s.end());
+    }
+    BinaryWriter::WriteFile(filename, out);
 }
 
-Jazz2AnimFormat::~Jazz2AnimFormat() { }
+static SurfaceSharedPtr ConvertFrame(const J2Frame& frame, bool flipped, const Palette& palette)
+{
+    SurfaceSharedPtr s(new Surface(frame.info.Width, frame.info.Height));
+    for (int y = 0; y < frame.info.Height; ++y)
+    {
+        for (int x = 0; x < frame.info.Width; ++x)
+        {
+            int* p = &frame.image.pixels[0];
+            int paletteIndex = p[x + y*frame.info.Width];
+            assert(paletteIndex >= 0);
+            assert(paletteIndex < 257);
+            if (paletteIndex > 255 || paletteIndex < 0)
+            {
+                paletteIndex = 0;
+            }
+            int X = x;
+            if (flipped)
+            {
+                X = frame.info.Height - x - 1;
+            }
+            s->PutPixel(X, y, palette.colors[paletteIndex]);
+        }
+    }
+    return s;
+}
 
 Animation Jazz2AnimFormat::GetAnimation(int animset, int index, bool flipped, const Palette& palette) const
 {
     assert(animset < (int)_j2Animations.size());
     assert(index < (int)_j2Animations[animset].size());
     auto& animation = _j2Animations[animset][index];
+    // frames belong to the animation files unless the caller says otherwise
+    MemoryScope scope(MemoryStats::CurrentCategoryOr(MemoryCategory::AnimSet));
     Animation anim(animation->info.FPS);
     for (auto& frame: animation->frames)
     {
-        SurfaceSharedPtr s(new Surface(frame.info.Width, frame.info.Height));
-        for (int y = 0; y < frame.info.Height; ++y)
+        if (frame.info.Width == 0)
         {
-            for (int x = 0; x < frame.info.Width; ++x)
-            {
-                int* p = &frame.image.pixels[0];
-                int paletteIndex = p[x + y*frame.info.Width];
-                assert(paletteIndex >= 0);
-                assert(paletteIndex < 257);
-                if (paletteIndex > 255 || paletteIndex < 0)
-                {
-                    paletteIndex = 0;
-                }
-                int X = x;
-                if (flipped)
-                {
-                    X = frame.info.Height - x - 1;
-                }
-                s->PutPixel(X, y, palette.colors[paletteIndex]);
-            }
+            // empty glyph of a font
+            continue;
         }
+        SurfaceSharedPtr s = ConvertFrame(frame, flipped, palette);
         AnimFrameInfo fi;
         fi.Enabled = true;
         fi.ColdspotX = frame.info.ColdspotX;
@@ -342,6 +683,51 @@ Animation Jazz2AnimFormat::GetAnimation(int animset, int index, bool flipped, co
     return anim;
 }
 
+bool Jazz2AnimFormat::IsFont(int animset, int index) const
+{
+    return _j2Animations[animset][index]->info.FrameCount == J2Animation::font_frame_count;
+}
+
+std::vector<SurfaceSharedPtr> Jazz2AnimFormat::GetFontGlyphs(int animset, int index, const Palette& palette) const
+{
+    assert(IsFont(animset, index));
+    std::vector<SurfaceSharedPtr> glyphs;
+    for (auto& frame: _j2Animations[animset][index]->frames)
+    {
+        glyphs.push_back(frame.info.Width == 0 ? nullptr : ConvertFrame(frame, false, palette));
+    }
+    return glyphs;
+}
+
+static SpanSpritePtr ConvertFrameToSpans(const J2Frame& frame)
+{
+    // skipped pixels and palette index 0 are both transparent
+    IndexedSurface s(frame.info.Width, frame.info.Height);
+    const int* p = &frame.image.pixels[0];
+    for (int y = 0; y < frame.info.Height; ++y)
+    {
+        uint8_t* row = s.Row(y);
+        for (int x = 0; x < frame.info.Width; ++x)
+        {
+            const int paletteIndex = p[x + y*frame.info.Width];
+            row[x] = paletteIndex > 255 ? IndexedSurface::transparent : static_cast<uint8_t>(paletteIndex);
+        }
+    }
+    return std::make_shared<SpanSprite>(s);
+}
+
+std::vector<SpanSpritePtr> Jazz2AnimFormat::GetSpanSprites(int animset, int index) const
+{
+    assert(animset < (int)_j2Animations.size());
+    assert(index < (int)_j2Animations[animset].size());
+    std::vector<SpanSpritePtr> sprites;
+    for (auto& frame: _j2Animations[animset][index]->frames)
+    {
+        sprites.push_back(frame.info.Width == 0 ? nullptr : ConvertFrameToSpans(frame));
+    }
+    return sprites;
+}
+
 unsigned int Jazz2AnimFormat::GetAnimationSetLength() const
 {
     return _j2Animations.size();
@@ -351,3 +737,61 @@ unsigned int Jazz2AnimFormat::GetAnimationLength(int animSet) const
 {
     return _j2Animations[animSet].size();
 }
+
+unsigned int Jazz2AnimFormat::GetSampleCount(int animSet) const
+{
+    return _j2Samples[animSet]->count;
+}
+
+std::vector<SamplePtr> Jazz2AnimFormat::DecodeSamples(int animSet) const
+{
+    const J2SampleSet& set = *_j2Samples[animSet];
+    std::vector<SamplePtr> samples;
+    if (set.count == 0)
+    {
+        return samples;
+    }
+    samples.reserve(set.count);
+    const std::unique_ptr<char[]> block = BinaryReader::Decompress(&set.compressed[0], set.compressedSize,
+                                                                   set.size);
+    size_t offset = 0;
+    for (int i = 0; i < set.count; ++i)
+    {
+        const char* s = &block[offset];
+        const size_t left = set.size - offset;
+        const SampleHeaderView header(s, left);
+        const bool asff = memcmp(header.Format().data(), "ASFF", 4) == 0;
+        const size_t padding = asff ? asffPadding : 0;
+        const size_t formatOffset = SampleHeaderView::Size() + padding;
+        const SampleFormatView format(s + formatOffset, left - std::min(left, formatOffset));
+        const size_t dataOffset = formatOffset + SampleFormatView::Size();
+        const int64_t dataSize = static_cast<int64_t>(header.ChunkSize()) - sampleChunkOverhead - padding;
+        if (header.TotalSize() < 0 || static_cast<size_t>(header.TotalSize()) > left || dataSize < 0 ||
+            dataOffset + dataSize + sampleTrailer > static_cast<size_t>(header.TotalSize()))
+        {
+            throw std::runtime_error("Sample " + std::to_string(i) + " of set " + std::to_string(animSet) +
+                                     " is corrupt.");
+        }
+
+        std::shared_ptr<Sample> sample = std::make_shared<Sample>();
+        sample->rate = format.Rate();
+        const char* data = s + dataOffset;
+        if (format.Flags() & sixteenBitSample)
+        {
+            sample->frames.resize(dataSize / 2);
+            memcpy(sample->frames.data(), data, sample->frames.size() * sizeof(int16_t));
+        }
+        else
+        {
+            sample->frames.resize(dataSize);
+            for (size_t f = 0; f < sample->frames.size(); ++f)
+            {
+                sample->frames[f] = static_cast<int16_t>((static_cast<uint8_t>(data[f]) - 128) * 256);
+            }
+        }
+        sample->memory.Set(MemoryCategory::Audio, HeapBytes(sample->frames));
+        samples.push_back(std::move(sample));
+        offset += header.TotalSize();
+    }
+    return samples;
+}
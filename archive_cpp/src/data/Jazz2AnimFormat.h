@@ -1,26 +1,82 @@
 #ifndef JAZZ2ANIMFORMAT_H
 #define JAZZ2ANIMFORMAT_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
+#include "audio/Sample.h"
 #include "gfx/Animation.h"
 #include "gfx/Color32.h"
+#include "gfx/SpanSprite.h"
 
 // documentation: http://www.jazz2online.com/wiki/J2A+File+Format
 
 struct J2Animation;
+struct J2SampleSet;
+
+// Content of an animation file for Jazz2AnimFormat::Write: sets of
+// animations of frames. Frame pixels are palette indices, 0 is transparent
+// and is stored as skipped pixels.
+struct J2FrameContent
+{
+    short                   width = 0;
+    short                   height = 0;
+    short                   hotspotX = 0;
+    short                   hotspotY = 0;
+    short                   coldspotX = 0;
+    short                   coldspotY = 0;
+    short                   gunspotX = 0;
+    short                   gunspotY = 0;
+    std::vector<uint8_t>    pixels;
+};
+
+struct J2AnimationContent
+{
+    short                       fps = 10;
+    std::vector<J2FrameContent> frames;
+};
+
+typedef std::vector<std::vector<J2AnimationContent>> J2AnimSetsContent;
+
+// A sound sample for Jazz2AnimFormat::Write, mono. 8 bit samples keep the
+// high byte of each frame.
+struct J2SampleContent
+{
+    int32_t                 rate = 22050;
+    bool                    sixteenBit = true;
+    std::vector<int16_t>    frames;
+};
+
+// the samples of each animation set, may have fewer sets than the animations
+typedef std::vector<std::vector<J2SampleContent>> J2SampleSetsContent;
 
 class Jazz2AnimFormat
 {
 public:
     Jazz2AnimFormat(const std::string& filename);
+    // writes a file this class reads back, throws std::runtime_error
+    static void Write(const std::string& filename, const J2AnimSetsContent& sets,
+                      const J2SampleSetsContent& samples = J2SampleSetsContent());
     ~Jazz2AnimFormat(); // in order to use J2Image as incompete type
     Animation GetAnimation(int animset, int index, bool flipped, const Palette& palette) const;
+    // font sets have one frame per character 32..255
+    bool IsFont(int animset, int index) const;
+    // one image per character, nullptr for the characters the font has no image for
+    std::vector<SurfaceSharedPtr> GetFontGlyphs(int animset, int index, const Palette& palette) const;
+    // the frames as span sprites, made on each call; nullptr for the
+    // characters a font has no image for
+    std::vector<SpanSpritePtr> GetSpanSprites(int animset, int index) const;
     unsigned int GetAnimationSetLength() const;
     unsigned int GetAnimationLength(int animSet) const;
+    // sample blocks are kept compressed when the file is read, see SampleBank
+    unsigned int GetSampleCount(int animSet) const;
+    // inflates the sample block of a set and decodes all its samples, throws
+    // std::runtime_error when the block is corrupt
+    std::vector<SamplePtr> DecodeSamples(int animSet) const;
 private:
     std::vector<std::vector<std::unique_ptr<J2Animation>>>   _j2Animations;
+    std::vector<std::unique_ptr<J2SampleSet>>                _j2Samples;
 };
 
 #endif // JAZZ2ANIMFORMAT_H
@@ -1,8 +1,10 @@
 #include "Jazz2LevelFormat.h"
 
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include "data/ResourceFactory.h"
 
 enum LevelVersion
@@ -52,15 +54,34 @@ struct LevelHeader
         read(s, UData4);
         return s;
     }
+
+    void write(std::vector<char>& out) const
+    {
+        using BinaryWriter::write;
+        write(out, Copyright);
+        write(out, Magic);
+        write(out, PasswordHash);
+        write(out, HideLevel);
+        write(out, LevelName);
+        write(out, Version);
+        write(out, FileSize);
+        write(out, CRC32);
+        write(out, CData1);
+        write(out, UData1);
+        write(out, CData2);
+        write(out, UData2);
+        write(out, CData3);
+        write(out, UData3);
+        write(out, CData4);
+        write(out, UData4);
+    }
 };
 
 template <int Version>
 struct VersionSpecificParms
 {
     typedef NULL_type SoundEffectPointerType;
-    enum { DONT_READ_SND_EFF = 1 };
     typedef NULL_type UnknownAGAType;
-    enum { DONT_READ_UNN_AGA = 1 };
     enum { Animated_Tile_Size = 128 };    
     enum { MAX_TILES = MAX_TILES_123 };
 };
@@ -69,9 +90,7 @@ template <>
 struct VersionSpecificParms<v_TSF>
 {
     typedef NULL_type SoundEffectPointerType;
-    enum { DONT_READ_SND_EFF = 1 };
     typedef NULL_type UnknownAGAType;
-    enum { DONT_READ_UNN_AGA = 1 };
     enum { Animated_Tile_Size = 256 };
     enum { MAX_TILES = MAX_TILES_123 };
 };
@@ -80,117 +99,75 @@ template <>
 struct VersionSpecificParms<v_AGA>
 {
     typedef char SoundEffectPointerType;
-    enum { DONT_READ_SND_EFF = 0 };
     typedef char UnknownAGAType;
-    enum { DONT_READ_UNN_AGA = 0 };
     enum { Animated_Tile_Size = 128 };
     enum { MAX_TILES = MAX_TILES_124 };
 };
 
+// Data1 fields in file order, for J2L_Data1View and J2L_Data1. Levels saved
+// with JCS end with 512 bytes of zeros, which are not read.
+#define J2L_DATA1_FIELDS(X) \
+    X(JCSHorizontalOffset, short) /* In pixels */ \
+    X(Security1, short) /* 0xBA00 if passworded, 0x0000 otherwise */ \
+    X(JCSVerticalOffset, short) /* In pixels */ \
+    X(Security2, short) /* 0xBE00 if passworded, 0x0000 otherwise */ \
+    X(SecAndLayer, char) /* Upper 4 bits are set if passworded, zero otherwise. Lower 4 bits represent the layer number as last saved in JCS. */ \
+    X(MinLight, char) /* Multiply by 1.5625 to get value seen in JCS */ \
+    X(StartLight, char) /* Multiply by 1.5625 to get value seen in JCS */ \
+    X(AnimCount, short) \
+    X(VerticalSplitscreen, bool) \
+    X(IsLevelMultiplayer, bool) \
+    X(BufferSize, int32_t) \
+    X(LevelName, char[32]) \
+    X(Tileset, char[32]) \
+    X(BonusLevel, char[32]) \
+    X(NextLevel, char[32]) \
+    X(SecretLevel, char[32]) \
+    X(MusicFile, char[32]) \
+    X(HelpString, char[16][512]) \
+    X(SoundEffectPointer, typename VParms::SoundEffectPointerType[48][64]) /* only in version 256 (AGA) */ \
+    X(LayerMiscProperties, int32_t[8]) /* Each property is a bit in the following order: Tile Width, Tile Height, Limit Visible Region, Texture Mode, Parallax Stars. This leaves 27 (32-5) unused bits for each layer? */ \
+    X(Type, char[8]) /* name from Michiel; function unknown */ \
+    X(DoesLayerHaveAnyTiles, bool[8]) /* must always be set to true for layer 4, or JJ2 will crash */ \
+    X(LayerWidth, int32_t[8]) \
+    X(LayerRealWidth, int32_t[8]) /* for when "Tile Width" is checked. The lowest common multiple of LayerWidth and 4. */ \
+    X(LayerHeight, int32_t[8]) \
+    X(LayerZAxis, int32_t[8]) /* -300, -200, -100, 0, 100, 200, 300, 400; nothing happens when you change these */ \
+    X(DetailLevel, char[8]) /* is set to 02 for layer 5 in Battle1 and Battle3, but is 00 the rest of the time, at least for JJ2 levels. No clear effect of altering. Name from Michiel. */ \
+    X(WaveX, int[8]) /* name from Michiel; function unknown */ \
+    X(WaveY, int[8]) /* name from Michiel; function unknown */ \
+    X(LayerXSpeed, int32_t[8]) /* Divide by 65536 to get value seen in JCS */ \
+    X(LayerYSpeed, int32_t[8]) /* Divide by 65536 to get value seen in JCSvalue */ \
+    X(LayerAutoXSpeed, int32_t[8]) /* Divide by 65536 to get value seen in JCS */ \
+    X(LayerAutoYSpeed, int32_t[8]) /* Divide by 65536 to get value seen in JCS */ \
+    X(LayerTextureMode, char[8]) \
+    X(LayerTextureParams, char[8][3]) /* Red, Green, Blue */ \
+    X(AnimOffset, short) /* MAX_TILES minus AnimCount, also called StaticTiles */ \
+    X(TilesetEvents, int32_t[VParms::MAX_TILES]) /* same format as in Data2, for tiles */ \
+    X(IsEachTileFlipped, bool[VParms::MAX_TILES]) /* set to 1 if a tile appears flipped anywhere in the level */ \
+    X(TileTypes, char[VParms::MAX_TILES]) /* translucent=1 or caption=4, basically. Doesn't work on animated tiles. */ \
+    X(XMask, char[VParms::MAX_TILES]) /* tested to equal all zeroes in almost 4000 different levels, and editing it has no appreciable effect. Name from Michiel, who claims it is totally unused. */ \
+    X(UnknownAGA, typename VParms::UnknownAGAType[32768]) /* only in version 256 (AGA) */ \
+    X(Anim, Animated_Tile[VParms::Animated_Tile_Size]) /* or [256] in TSF. only the first [AnimCount] are needed; JCS will save all 128/256, but JJ2 will run your level either way. */
+
+// Data1 read in place from the decompressed block
 template <typename VParms>
-struct J2L_Data1
+class J2L_Data1View
 {
-    static const int MAX_TILES = VParms::MAX_TILES;
-
-    short JCSHorizontalOffset; // In pixels
-    short Security1; // 0xBA00 if passworded, 0x0000 otherwise
-    short JCSVerticalOffset; // In pixels
-    short Security2; // 0xBE00 if passworded, 0x0000 otherwise
-    char SecAndLayer; // Upper 4 bits are set if passworded, zero otherwise. Lower 4 bits represent the layer number as last saved in JCS.
-    char MinLight; // Multiply by 1.5625 to get value seen in JCS
-    char StartLight; // Multiply by 1.5625 to get value seen in JCS
-    short AnimCount;
-    bool VerticalSplitscreen;
-    bool IsLevelMultiplayer;
-    int32_t BufferSize;
-    char LevelName[32];
-    char Tileset[32];
-    char BonusLevel[32];
-    char NextLevel[32];
-    char SecretLevel[32];
-    char MusicFile[32];
-    char HelpString[16][512];
-    typename VParms::SoundEffectPointerType SoundEffectPointer[48][64]; // only in version 256 (AGA)
-    int32_t LayerMiscProperties[8]; // Each property is a bit in the following order: Tile Width, Tile Height, Limit Visible Region, Texture Mode, Parallax Stars. This leaves 27 (32-5) unused bits for each layer?
-    char Type[8]; // name from Michiel; function unknown
-    bool DoesLayerHaveAnyTiles[8]; // must always be set to true for layer 4, or JJ2 will crash
-    int32_t LayerWidth[8];
-    int32_t LayerRealWidth[8]; // for when "Tile Width" is checked. The lowest common multiple of LayerWidth and 4.
-    int32_t LayerHeight[8];
-    int32_t LayerZAxis[8] = {-300, -200, -100, 0, 100, 200, 300, 400}; // nothing happens when you change these
-    char DetailLevel[8]; // is set to 02 for layer 5 in Battle1 and Battle3, but is 00 the rest of the time, at least for JJ2 levels. No clear effect of altering. Name from Michiel.
-    int WaveX[8]; // name from Michiel; function unknown
-    int WaveY[8]; // name from Michiel; function unknown
-    int32_t LayerXSpeed[8]; // Divide by 65536 to get value seen in JCS
-    int32_t LayerYSpeed[8]; // Divide by 65536 to get value seen in JCSvalue
-    int32_t LayerAutoXSpeed[8]; // Divide by 65536 to get value seen in JCS
-    int32_t LayerAutoYSpeed[8]; // Divide by 65536 to get value seen in JCS
-    char LayerTextureMode[8];
-    char LayerTextureParams[8][3]; // Red, Green, Blue
-    short AnimOffset; // MAX_TILES minus AnimCount, also called StaticTiles
-    int32_t TilesetEvents[MAX_TILES]; // same format as in Data2, for tiles
-    bool IsEachTileFlipped[MAX_TILES]; // set to 1 if a tile appears flipped anywhere in the level
-    char TileTypes[MAX_TILES]; // translucent=1 or caption=4, basically. Doesn't work on animated tiles.
-    char XMask[MAX_TILES]; // tested to equal all zeroes in almost 4000 different levels, and editing it has no appreciable effect.  // Name from Michiel, who claims it is totally unused.
-    typename VParms::UnknownAGAType UnknownAGA[32768]; // only in version 256 (AGA)
-    Animated_Tile Anim[VParms::Animated_Tile_Size]; // or [256] in TSF.
-                             // only the first [AnimCount] are needed; JCS will save all 128/256, but JJ2 will run your level either way.
-    char Padding[512]; //all zeroes; only in levels saved with JCS
+    BINARY_VIEW_BODY(J2L_Data1View, J2L_DATA1_FIELDS)
+};
 
-    const char* read(const char* s)
-    {
-        using BinaryReader::read;
-        s = read(s, JCSHorizontalOffset);
-        s = read(s, Security1);
-        s = read(s, JCSVerticalOffset);
-        s = read(s, Security2);
-        s = read(s, SecAndLayer);
-        s = read(s, MinLight);
-        s = read(s, StartLight);
-        s = read(s, AnimCount);
-        s = read(s, VerticalSplitscreen);
-        s = read(s, IsLevelMultiplayer);
-        s = read(s, BufferSize);
-        s = read(s, LevelName);
-        s = read(s, Tileset);
-        s = read(s, BonusLevel);
-        s = read(s, NextLevel);
-        s = read(s, SecretLevel);
-        s = read(s, MusicFile);
-        s = read(s, HelpString);
-        if (VParms::DONT_READ_SND_EFF == 0)
-            s = read(s, SoundEffectPointer);
-        s = read(s, LayerMiscProperties);
-        s = read(s, Type);
-        s = read(s, DoesLayerHaveAnyTiles);
-        s = read(s, LayerWidth);
-        s = read(s, LayerRealWidth);
-        s = read(s, LayerHeight);
-        s = read(s, LayerZAxis);
-        s = read(s, DetailLevel);
-        s = read(s, WaveX);
-        s = read(s, WaveY);
-        s = read(s, LayerXSpeed);
-        s = read(s, LayerYSpeed);
-        s = read(s, LayerAutoXSpeed);
-        s = read(s, LayerAutoYSpeed);
-        s = read(s, LayerTextureMode);
-        s = read(s, LayerTextureParams);
-        s = read(s, AnimOffset);
-        s = read(s, TilesetEvents);
-        s = read(s, IsEachTileFlipped);
-        s = read(s, TileTypes);
-        s = read(s, XMask);
-        if (VParms::DONT_READ_UNN_AGA == 0)
-            s = read(s, UnknownAGA);
-        for (unsigned int i = 0; i < sizeof(Anim) / sizeof(Animated_Tile); ++i)
-        {
-            s = Anim[i].read(s);
-        }
-        return s;
-    }
+// Data1 as the writer fills it
+template <typename VParms>
+struct J2L_Data1
+{
+    BINARY_STRUCT_BODY(J2L_DATA1_FIELDS)
 };
 
+// the sizes JCS writes, less the padding
+static_assert(J2L_Data1View<VersionSpecificParms<v_123>>::Size() == 33517, "1.23 Data1 layout");
+static_assert(J2L_Data1View<VersionSpecificParms<v_TSF>>::Size() == 51053, "TSF Data1 layout");
+
 const char* J2Event::read(const char* s)
 {
     using BinaryReader::read;
@@ -199,6 +176,13 @@ const char* J2Event::read(const char* s)
     return s;
 }
 
+void J2Event::write(std::vector<char>& out) const
+{
+    using BinaryWriter::write;
+    write(out, EventId);
+    write(out, Params);
+}
+
 struct J2EventHeader_AGA
 {
     int16_t NumberOfDistinctEvents;
@@ -278,8 +262,14 @@ struct AGAEvent
     }
 };
 
-void Jazz2LevelFormat::ReadEvents(const char* data2, int width, int height)
+void Jazz2LevelFormat::ReadEvents(const char* data2, size_t size, int width, int height)
 {
+    if (width < 0 || height < 0)
+    {
+        throw std::runtime_error("Level layer 4 has a negative size.");
+    }
+    BinaryView::Require(data2, size, static_cast<size_t>(width) * height * sizeof(uint32_t), "Data2");
+    events.reserve(static_cast<size_t>(width) * height);
     for (int y = 0; y < height; ++y)
     {
         for (int x = 0; x < width; ++x)
@@ -293,44 +283,49 @@ void Jazz2LevelFormat::ReadEvents(const char* data2, int width, int height)
     }
 }
 
-template<typename Header>
-void Jazz2LevelFormat::ReadTiles(const Header& header, const char* data3, const char* data4, bool TSF)
+template<typename Data1>
+void Jazz2LevelFormat::ReadTiles(const Data1& data1, const BinaryView::Array<uint16_t>& data3,
+                                 const BinaryView::Array<int16_t>& data4, bool TSF)
 {
-    using BinaryReader::read;
-    int16_t* quadRefs = (int16_t*) data4;
+    // Data3 holds groups of four tile words, Data4 per row of a layer which
+    // group covers each four tiles; both indices come from the file
+    size_t quadRefs = 0;
     for (int count = 0; count < 8; ++count)
     {
-        int32_t flags = header.LayerMiscProperties[count];
-        int32_t width = header.LayerWidth[count];
-        int32_t pitch = header.LayerRealWidth[count];
-        int32_t height = header.LayerHeight[count];
+        int32_t flags = data1.LayerMiscProperties()[count];
+        int32_t width = data1.LayerWidth()[count];
+        int32_t pitch = data1.LayerRealWidth()[count];
+        int32_t height = data1.LayerHeight()[count];
 
         if (pitch & 3)
             pitch += 4;
 
         J2Layer layer;
-        if (header.DoesLayerHaveAnyTiles[count])
+        if (data1.DoesLayerHaveAnyTiles()[count])
         {
+            if (width < 0 || height < 0 || pitch < width)
+            {
+                throw std::runtime_error("Level layer " + std::to_string(count + 1) + " has an invalid size.");
+            }
             layer.width = width;
             layer.height = height;
             layer.tileX = flags & 1;
             layer.tileY = flags & 2;
             layer.limit = flags & 4;
             layer.warp = flags & 8;
+            layer.grid.reserve(static_cast<size_t>(width) * height);
 
-            unsigned char tileQuad[8];            
-
+            size_t quad = 0;
             for (int y = 0; y < height; ++y)
             {
                 for (int x = 0; x < width; ++x)
                 {
                     if ((x & 3) == 0)
                     {
-                        memcpy(tileQuad, data3 + (quadRefs[x >> 2] << 3), 8);
+                        quad = 4 * static_cast<size_t>(data4.at(quadRefs + (x >> 2)));
+                        data3.at(quad + 3);
                     }
-                    uint16_t tileId = 0;
-                    read((char*)tileQuad + ((x & 3) << 1), tileId);
-                    layer.setTile(x, y, tileId, TSF);
+                    layer.setTile(x, y, data3[quad + (x & 3)], TSF);
                 }
                 quadRefs += pitch >> 2;
             }
@@ -338,18 +333,174 @@ void Jazz2LevelFormat::ReadTiles(const Header& header, const char* data3, const
         layers.push_back(layer);
     }
 
-    tileSetName = header.Tileset;    
+    tileSetName = BinaryView::ToString(data1.Tileset());
+}
+
+template<typename Data1>
+void Jazz2LevelFormat::CopyAnimTiles(const Data1& data1)
+{
+    const auto anims = data1.Anim();
+    const short count = data1.AnimCount();
+    if (count < 0 || static_cast<size_t>(count) > anims.size())
+    {
+        throw std::runtime_error("Level has " + std::to_string(count) + " animated tiles, at most " +
+                                 std::to_string(anims.size()) + " fit.");
+    }
+    animTiles.reserve(count);
+    AnimOffset = data1.AnimOffset();
+    for (int i = 0; i < count; ++i)
+    {
+        animTiles.push_back(anims[i]);
+    }
+}
+
+// Data1 of a level, the layers are described, their tiles are in Data3/4
+template <typename VParms>
+std::vector<char> WriteData1(const J2LevelContent& c)
+{
+    typedef J2L_Data1<VParms> Data1;
+    if (c.animTiles.size() > VParms::Animated_Tile_Size)
+    {
+        throw std::runtime_error("Level " + c.name + ": too many animated tiles.");
+    }
+    std::unique_ptr<Data1> d(new Data1());
+    strncpy(d->LevelName, c.name.c_str(), sizeof(d->LevelName) - 1);
+    strncpy(d->Tileset, c.tileSet.c_str(), sizeof(d->Tileset) - 1);
+    d->AnimCount = static_cast<short>(c.animTiles.size());
+    d->AnimOffset = c.animOffset;
+    for (int l = 0; l < 8; ++l)
+    {
+        d->LayerZAxis[l] = (l - 3) * 100;
+    }
+    for (size_t l = 0; l < c.layers.size(); ++l)
+    {
+        const J2Layer& layer = c.layers[l];
+        d->DoesLayerHaveAnyTiles[l] = layer.width > 0 && layer.height > 0;
+        d->LayerMiscProperties[l] = (layer.tileX ? 1 : 0) | (layer.tileY ? 2 : 0)
+                                    | (layer.limit ? 4 : 0) | (layer.warp ? 8 : 0);
+        d->LayerWidth[l] = layer.width;
+        d->LayerRealWidth[l] = (layer.width + 3) & ~3;
+        d->LayerHeight[l] = layer.height;
+        d->LayerXSpeed[l] = 65536;
+        d->LayerYSpeed[l] = 65536;
+    }
+    for (size_t i = 0; i < c.animTiles.size(); ++i)
+    {
+        d->Anim[i] = c.animTiles[i];
+    }
+    std::vector<char> out;
+    d->write(out);
+    return out;
 }
 
-template<typename Header>
-void Jazz2LevelFormat::CopyAnimTiles(const Header& h)
+void Jazz2LevelFormat::Write(const std::string& filename, const J2LevelContent& content)
 {
-    animTiles.reserve(h.AnimCount);
-    AnimOffset = h.AnimOffset;
-    for (int i = 0; i < h.AnimCount; ++i)
+    using BinaryWriter::write;
+    if (content.layers.size() > 8)
     {
-        animTiles.push_back(h.Anim[i]);
+        throw std::runtime_error("Level " + filename + ": more than 8 layers.");
     }
+    const uint16_t flipBit = content.tsf ? 0x1000 : 0x400;
+    const uint16_t idMask = flipBit - 1;
+
+    // Data2, four bytes per tile of layer 4
+    std::vector<char> data2;
+    if (content.layers.size() > 3)
+    {
+        const J2Layer& l4 = content.layers[3];
+        std::vector<J2Event> map(static_cast<size_t>(l4.width) * l4.height, J2Event{0, {0, 0, 0}, 0, 0});
+        for (const auto& ev : content.events)
+        {
+            if (ev.x >= 0 && ev.x < l4.width && ev.y >= 0 && ev.y < l4.height)
+            {
+                map[static_cast<size_t>(ev.y) * l4.width + ev.x] = ev;
+            }
+        }
+        data2.reserve(map.size() * 4);
+        for (const auto& ev : map)
+        {
+            ev.write(data2);
+        }
+    }
+
+    // Data3 holds distinct groups of four tile words, Data4 per layer row
+    // which group covers each four tiles; the reader indexes Data3 with a
+    // signed 16 bit value
+    std::vector<char> data3;
+    std::vector<char> data4;
+    std::unordered_map<uint64_t, int16_t> quads;
+    auto quadIndex = [&](uint64_t quad)
+    {
+        auto it = quads.find(quad);
+        if (it == quads.end())
+        {
+            if (quads.size() > 0x7fff)
+            {
+                throw std::runtime_error("Level " + filename + ": more than 32768 distinct groups of 4 tiles.");
+            }
+            it = quads.emplace(quad, static_cast<int16_t>(quads.size())).first;
+            write(data3, quad);
+        }
+        return it->second;
+    };
+    quadIndex(0);
+    for (const auto& layer : content.layers)
+    {
+        if (layer.width <= 0 || layer.height <= 0)
+        {
+            continue;
+        }
+        const int pitch = (layer.width + 3) & ~3;
+        std::vector<uint16_t> words(static_cast<size_t>(pitch) * layer.height, 0);
+        for (const auto& t : layer.grid)
+        {
+            if (t.x >= 0 && t.x < layer.width && t.y >= 0 && t.y < layer.height)
+            {
+                words[static_cast<size_t>(t.y) * pitch + t.x] = (t.id & idMask) | (t.flipped ? flipBit : 0);
+            }
+        }
+        for (size_t w = 0; w < words.size(); w += 4)
+        {
+            uint64_t quad = 0;
+            memcpy(&quad, &words[w], sizeof(quad));
+            write(data4, quadIndex(quad));
+        }
+    }
+
+    std::vector<char> data1 = content.tsf ? WriteData1<VersionSpecificParms<v_TSF>>(content)
+                                          : WriteData1<VersionSpecificParms<v_123>>(content);
+    const std::vector<char>* raw[4] = {&data1, &data2, &data3, &data4};
+    std::vector<char> blocks[4];
+    LevelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Magic, "LEVL", sizeof(header.Magic));
+    header.PasswordHash[1] = char(0xba);
+    header.PasswordHash[2] = char(0xbe);
+    strncpy(header.LevelName, content.name.c_str(), sizeof(header.LevelName) - 1);
+    header.Version = content.tsf ? v_TSF : v_123;
+    int32_t* sizes[8] = {&header.CData1, &header.UData1, &header.CData2, &header.UData2,
+                         &header.CData3, &header.UData3, &header.CData4, &header.UData4};
+    uLong crc = ::crc32(0, Z_NULL, 0);
+    for (int b = 0; b < 4; ++b)
+    {
+        blocks[b] = BinaryWriter::Compress(*raw[b]);
+        *sizes[2 * b] = blocks[b].size();
+        *sizes[2 * b + 1] = raw[b]->size();
+        crc = ::crc32(crc, reinterpret_cast<const Bytef*>(blocks[b].data()), blocks[b].size());
+        header.FileSize += blocks[b].size();
+    }
+    header.CRC32 = static_cast<int32_t>(crc);
+
+    std::vector<char> out;
+    header.write(out);
+    header.FileSize += out.size();
+    out.clear();
+    header.write(out);
+    for (const auto& b : blocks)
+    {
+        out.insert(out.end(), b.begin(), b.end());
+    }
+    BinaryWriter::WriteFile(filename, out);
 }
 
 Jazz2LevelFormat::Jazz2LevelFormat(const std::string& filename)
@@ -362,6 +513,10 @@ Jazz2LevelFormat::Jazz2LevelFormat(const std::string& filename)
 
     LevelHeader header;
     header.read(file);
+    if (!file)
+    {
+        throw std::runtime_error("Level file " + filename + " is truncated.");
+    }
 
     // Data1 (General Level Data)
     auto data1 = BinaryReader::ReadAndDecompress(file, header.CData1, header.UData1);
@@ -373,38 +528,38 @@ Jazz2LevelFormat::Jazz2LevelFormat(const std::string& filename)
     // Data4
     auto data4 = BinaryReader::ReadAndDecompress(file, header.CData4, header.UData4);
 
+    const BinaryView::Array<uint16_t> dictionary(&data3[0], header.UData3 / sizeof(uint16_t));
+    const BinaryView::Array<int16_t> quadRefs(&data4[0], header.UData4 / sizeof(int16_t));
+
     if (header.Version == LevelVersion::v_123)
     {
-        J2L_Data1<VersionSpecificParms<v_123>> data1_123;
-        data1_123.read(&data1[0]);
+        J2L_Data1View<VersionSpecificParms<v_123>> data1_123(&data1[0], header.UData1);
         // read events, amount = (Layer4Width * Layer4Height * 4)
-        ReadEvents(&data2[0], data1_123.LayerWidth[3], data1_123.LayerHeight[3]);
+        ReadEvents(&data2[0], header.UData2, data1_123.LayerWidth()[3], data1_123.LayerHeight()[3]);
         // read tiles
-        ReadTiles(data1_123, &data3[0], &data4[0], TSF);
+        ReadTiles(data1_123, dictionary, quadRefs, TSF);
         CopyAnimTiles(data1_123);
     }
     else if (header.Version == LevelVersion::v_TSF)
     {
         TSF = true;
-        J2L_Data1<VersionSpecificParms<v_TSF>> data1_tfs;
-        data1_tfs.read(&data1[0]);
+        J2L_Data1View<VersionSpecificParms<v_TSF>> data1_tfs(&data1[0], header.UData1);
         // read events, amount = (Layer4Width * Layer4Height * 4)
-        ReadEvents(&data2[0], data1_tfs.LayerWidth[3], data1_tfs.LayerHeight[3]);
+        ReadEvents(&data2[0], header.UData2, data1_tfs.LayerWidth()[3], data1_tfs.LayerHeight()[3]);
         // read tiles
-        ReadTiles(data1_tfs, &data3[0], &data4[0], TSF);
+        ReadTiles(data1_tfs, dictionary, quadRefs, TSF);
         CopyAnimTiles(data1_tfs);
     }
     else if (header.Version == LevelVersion::v_AGA)
     {
-        J2L_Data1<VersionSpecificParms<v_AGA>> data1_aga;
-        data1_aga.read(&data1[0]);
+        J2L_Data1View<VersionSpecificParms<v_AGA>> data1_aga(&data1[0], header.UData1);
         J2EventHeader_AGA ev_header;
         const char* buff = ev_header.read(&data2[0]);
         AGAEvent ev;
         ev.read(buff, header.UData2 - (buff - &data2[0]));
         // finished?
         // read tiles
-        ReadTiles(data1_aga, &data3[0], &data4[0], TSF);
+        ReadTiles(data1_aga, dictionary, quadRefs, TSF);
         CopyAnimTiles(data1_aga);
         assert(false);
     }
@@ -412,6 +567,13 @@ Jazz2LevelFormat::Jazz2LevelFormat(const std::string& filename)
     {
         throw std::runtime_error("Unsupported level file.");
     }
+
+    size_t bytes = HeapBytes(events) + HeapBytes(animTiles);
+    for (const auto& l : layers)
+    {
+        bytes += HeapBytes(l.grid);
+    }
+    memory.Set(MemoryCategory::LevelFile, bytes);
 }
 
 std::string Jazz2LevelFormat::getTilesFile() const
@@ -8,6 +8,9 @@
 #include "data/Jazz2TileFormat.h"
 #include "data/Jazz2AnimFormat.h"
 #include "utils/BinaryReader.h"
+#include "utils/BinaryView.h"
+#include "utils/BinaryWriter.h"
+#include "utils/MemoryStats.h"
 #include "gfx/Color32.h"
 
 // doc: http://www.jazz2online.com/wiki/LEV+File+Format
@@ -35,8 +38,44 @@ struct Animated_Tile
         s = read(s, Frame);
         return s;
     }
+
+    void write(std::vector<char>& out) const
+    {
+        using BinaryWriter::write;
+        write(out, FrameWait);
+        write(out, RandomWait);
+        write(out, PingPongWait);
+        write(out, PingPong);
+        write(out, Speed);
+        write(out, FrameCount);
+        write(out, Frame);
+    }
+};
+
+namespace BinaryView
+{
+
+template <>
+struct Codec<Animated_Tile>
+{
+    static constexpr size_t size = 3 * sizeof(short) + sizeof(bool) + 2 * sizeof(char) + sizeof(Animated_Tile::Frame);
+    typedef Animated_Tile type;
+
+    static Animated_Tile Read(const char* s)
+    {
+        Animated_Tile t;
+        t.read(s);
+        return t;
+    }
+
+    static void Write(std::vector<char>& out, const Animated_Tile& t)
+    {
+        t.write(out);
+    }
 };
 
+}
+
 struct J2TileId
 {
     int id;
@@ -94,12 +133,30 @@ struct J2Event
     int y;
 
     const char* read(const char* s);
+    void write(std::vector<char>& out) const;
+};
+
+// Content of a level file for Jazz2LevelFormat::Write: up to eight layers
+// (tiles at their x, y, everything else empty), the events of layer 4 at
+// their x, y and the animated tiles, whose ids start at animOffset. TSF
+// levels refer to up to 4096 tiles, the others to 1024.
+struct J2LevelContent
+{
+    std::string                 name;
+    std::string                 tileSet;
+    bool                        tsf = false;
+    std::vector<J2Layer>        layers;
+    std::vector<J2Event>        events;
+    std::vector<Animated_Tile>  animTiles;
+    short                       animOffset = 0;
 };
 
 class Jazz2LevelFormat
 {
 public:
     Jazz2LevelFormat(const std::string& filename);
+    // writes a 1.23 or TSF file this class reads back, throws std::runtime_error
+    static void Write(const std::string& filename, const J2LevelContent& content);
 
     const std::vector<J2Layer>&  getLayers() const { return layers; }
     const std::vector<J2Event>& getEvents() const { return events; }
@@ -118,14 +175,19 @@ private:
     std::vector<J2Event> events;
     std::string tileSetName;
     std::vector<Animated_Tile> animTiles;
+    // kept as long as ResourceFactory caches the level
+    MemoryCharge memory;
 
     Palette levelPalette;
 
-    void ReadEvents(const char* data2, int width, int height);
-    template<typename Header>
-    void ReadTiles(const Header& header, const char* data3, const char* data4, bool TSF);
-    template<typename Header>
-    void CopyAnimTiles(const Header& h);
+    // throw std::runtime_error when the data blocks are too short for the
+    // sizes and indices in Data1
+    void ReadEvents(const char* data2, size_t size, int width, int height);
+    template<typename Data1>
+    void ReadTiles(const Data1& data1, const BinaryView::Array<uint16_t>& data3,
+                   const BinaryView::Array<int16_t>& data4, bool TSF);
+    template<typename Data1>
+    void CopyAnimTiles(const Data1& data1);
 };
 
 #endif // JAZZ2LEVELFORMAT_H
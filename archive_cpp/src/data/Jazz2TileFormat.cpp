@@ -3,14 +3,18 @@
 #include <vector>
 #include <cstring>
 #include <assert.h>
+#include <algorithm>
 
 #include "Jazz2TileFormat.h"
 #include "utils/BinaryReader.h"
+#include "utils/BinaryWriter.h"
 #include "gfx/Color32.h"
 #include "gfx/GraphicsEngine.h"
+#include "utils/JobSystem.h"
+#include "utils/MemoryStats.h"
 
-J2Tile::J2Tile(int32_t *palette, char *image, char* transparencyMask,
-               char* collisionMask, char* flippedCollisionMask, bool flip)
+J2Tile::J2Tile(const int32_t *palette, const char *image, const char* transparencyMask,
+               const char* collisionMask, const char* flippedCollisionMask, bool flip)
 {
     // check if we need to use alpha mode (it is much slower when displayed)
     bool useAlpha = false;
@@ -31,6 +35,7 @@ J2Tile::J2Tile(int32_t *palette, char *image, char* transparencyMask,
     }
 
     Image.reset(new Surface(tileSize, tileSize, useAlpha));
+    IndexedImage.reset(new IndexedSurface(tileSize, tileSize));
 
     for (int y = 0; y < tileSize; ++y)
     {
@@ -60,6 +65,7 @@ J2Tile::J2Tile(int32_t *palette, char *image, char* transparencyMask,
             else
             {
                 d.SetColor(c.GetA(), c.GetB(), c.GetG(), 255);
+                IndexedImage->PutPixel(X, y, static_cast<uint8_t>(image[index]));
             }
             using BinaryReader::IsBitSetAt;
 
@@ -125,72 +131,148 @@ struct TILE_Header
         read(s, UData4);
         return s;
     }
+
+    void write(std::vector<char>& out) const
+    {
+        using BinaryWriter::write;
+        write(out, Copyright);
+        write(out, Magic);
+        write(out, Signature);
+        write(out, Title);
+        write(out, Version);
+        write(out, FileSize);
+        write(out, CRC32);
+        write(out, CData1);
+        write(out, UData1);
+        write(out, CData2);
+        write(out, UData2);
+        write(out, CData3);
+        write(out, UData3);
+        write(out, CData4);
+        write(out, UData4);
+    }
 };
 
-struct TileSetInfo_123
+// Data1 fields in file order, for TileSetInfoView and TileSetInfo; MAX_TILES
+// is MAX_TILES_123 in version 0x200, MAX_TILES_124 in 0x201
+#define TILE_SET_INFO_FIELDS(X) \
+    X(PaletteColor, int32_t[256]) /* arranged RGBA */ \
+    X(TileCount, int32_t) /* number of tiles, always a multiple of 10 */ \
+    X(FullyOpaque, char[MAX_TILES]) /* 1 if no transparency at all, otherwise 0 */ \
+    X(Unknown1, char[MAX_TILES]) /* appears to be all zeros */ \
+    X(ImageAddress, int32_t[MAX_TILES]) \
+    X(Unknown2, int32_t[MAX_TILES]) /* appears to be all zeros */ \
+    X(TMaskAddress, int32_t[MAX_TILES]) /* Transparency masking, for bitblt */ \
+    X(Unknown3, int32_t[MAX_TILES]) /* appears to be all zeros */ \
+    X(MaskAddress, int32_t[MAX_TILES]) /* Clipping or tile mask */ \
+    X(FMaskAddress, int32_t[MAX_TILES]) /* flipped version of the above */
+
+// Data1 read in place from the decompressed block
+template <int MAX_TILES>
+class TileSetInfoView
 {
-    int32_t PaletteColor[256];        //arranged RGBA
-    int32_t TileCount;                 //number of tiles, always a multiple of 10
-    char FullyOpaque[MAX_TILES_123];    //1 if no transparency at all, otherwise 0
-    char Unknown1[MAX_TILES_123];       //appears to be all zeros
-    int32_t ImageAddress[MAX_TILES_123];
-    int32_t Unknown2[MAX_TILES_123];       //appears to be all zeros
-    int32_t TMaskAddress[MAX_TILES_123];   //Transparency masking, for bitblt
-    int32_t Unknown3[MAX_TILES_123];       //appears to be all zeros
-    int32_t MaskAddress[MAX_TILES_123];    //Clipping or tile mask
-    int32_t FMaskAddress[MAX_TILES_123];   //flipped version of the above
+    BINARY_VIEW_BODY(TileSetInfoView, TILE_SET_INFO_FIELDS)
 };
 
-struct TileSetInfo_124
+// Data1 as the writer fills it
+template <int MAX_TILES>
+struct TileSetInfo
 {
-    int32_t PaletteColor[256];        //arranged RGBA
-    int32_t TileCount;                 //number of tiles, always a multiple of 10
-    char FullyOpaque[MAX_TILES_124];    //1 if no transparency at all, otherwise 0
-    char Unknown1[MAX_TILES_124];       //appears to be all zeros
-    int32_t ImageAddress[MAX_TILES_124];
-    int32_t Unknown2[MAX_TILES_124];       //appears to be all zeros
-    int32_t TMaskAddress[MAX_TILES_124];   //Transparency masking, for bitblt
-    int32_t Unknown3[MAX_TILES_124];       //appears to be all zeros
-    int32_t MaskAddress[MAX_TILES_124];    //Clipping or tile mask
-    int32_t FMaskAddress[MAX_TILES_124];   //flipped version of the above
+    BINARY_STRUCT_BODY(TILE_SET_INFO_FIELDS)
 };
 
-template <typename TileSet>
-const char* readTile(const char* s, TileSet& t)
-{
-    using BinaryReader::read;
-    s = read(s, t.PaletteColor);
-    s = read(s, t.TileCount);
-    s = read(s, t.FullyOpaque);
-    s = read(s, t.Unknown1);
-    s = read(s, t.ImageAddress);
-    s = read(s, t.Unknown2);
-    s = read(s, t.TMaskAddress);
-    s = read(s, t.Unknown3);
-    s = read(s, t.MaskAddress);
-    s = read(s, t.FMaskAddress);
-    return s;
-}
+static_assert(TileSetInfoView<MAX_TILES_123>::Size() == 27652, "1.23 Data1 layout");
+static_assert(TileSetInfoView<MAX_TILES_124>::Size() == 107524, "1.24 Data1 layout");
 
-struct TileSetInfo
+// Data1 of a tile set whose tiles are stored one after another: images in
+// Data2, transparency masks in Data3, each mask followed by its flipped
+// version in Data4
+template <int MAX_TILES>
+std::vector<char> WriteTileSetInfo(const J2TileSetContent& c)
 {
-    int32_t PaletteColor[256];        //arranged RGBA
-    int32_t TileCount;                 //number of tiles, always a multiple of 10
-    std::vector<char> FullyOpaque;    //1 if no transparency at all, otherwise 0
-    std::vector<char> Unknown1;       //appears to be all zeros
-    std::vector<int32_t> ImageAddress;
-    std::vector<int32_t> Unknown2;       //appears to be all zeros
-    std::vector<int32_t> TMaskAddress;   //Transparency masking, for bitblt
-    std::vector<int32_t> Unknown3;       //appears to be all zeros
-    std::vector<int32_t> MaskAddress;    //Clipping or tile mask
-    std::vector<int32_t> FMaskAddress;   //flipped version of the above
-};
+    std::unique_ptr<TileSetInfo<MAX_TILES>> info(new TileSetInfo<MAX_TILES>());
+    memcpy(info->PaletteColor, c.palette, sizeof(info->PaletteColor));
+    info->TileCount = c.TileCount();
+    for (int i = 0; i < info->TileCount; ++i)
+    {
+        const char* tmask = &c.transparencyMasks[i * 128];
+        info->FullyOpaque[i] = std::all_of(tmask, tmask + 128, [](char b) { return b == char(0xff); });
+        info->ImageAddress[i] = i * 1024;
+        info->TMaskAddress[i] = i * 128;
+        info->MaskAddress[i] = 2 * i * 128;
+        info->FMaskAddress[i] = (2 * i + 1) * 128;
+    }
+    std::vector<char> out;
+    info->write(out);
+    return out;
+}
 
 Jazz2TileFormat::Jazz2TileFormat(const std::string &filename)
 {
     ReadFromFile(filename);
 }
 
+void Jazz2TileFormat::Write(const std::string& filename, const J2TileSetContent& content)
+{
+    using BinaryWriter::Compress;
+    const int tileCount = content.TileCount();
+    const size_t maskSize = static_cast<size_t>(tileCount) * 128;
+    if (tileCount > MAX_TILES_124 || content.images.size() != static_cast<size_t>(tileCount) * 1024
+        || content.transparencyMasks.size() != maskSize || content.collisionMasks.size() != maskSize
+        || content.flippedCollisionMasks.size() != maskSize)
+    {
+        throw std::runtime_error("Tile set " + filename + ": inconsistent content.");
+    }
+
+    const bool v124 = tileCount > MAX_TILES_123;
+    std::vector<char> data1 = v124 ? WriteTileSetInfo<MAX_TILES_124>(content)
+                                   : WriteTileSetInfo<MAX_TILES_123>(content);
+    std::vector<char> data4;
+    data4.reserve(2 * maskSize);
+    for (int i = 0; i < tileCount; ++i)
+    {
+        data4.insert(data4.end(), &content.collisionMasks[i * 128], &content.collisionMasks[i * 128] + 128);
+        data4.insert(data4.end(), &content.flippedCollisionMasks[i * 128],
+                     &content.flippedCollisionMasks[i * 128] + 128);
+    }
+    const std::vector<char> blocks[4] = {Compress(data1), Compress(content.images),
+                                         Compress(content.transparencyMasks), Compress(data4)};
+
+    TILE_Header header;
+    memset(header.Copyright, 0, sizeof(header.Copyright));
+    memcpy(header.Magic, "TILE", sizeof(header.Magic));
+    memset(header.Title, 0, sizeof(header.Title));
+    strncpy(header.Title, content.title.c_str(), sizeof(header.Title) - 1);
+    header.Version = v124 ? 0x201 : 0x200;
+    header.CData1 = blocks[0].size();
+    header.UData1 = data1.size();
+    header.CData2 = blocks[1].size();
+    header.UData2 = content.images.size();
+    header.CData3 = blocks[2].size();
+    header.UData3 = content.transparencyMasks.size();
+    header.CData4 = blocks[3].size();
+    header.UData4 = data4.size();
+    uLong crc = ::crc32(0, Z_NULL, 0);
+    header.FileSize = 0;
+    for (const auto& b : blocks)
+    {
+        crc = ::crc32(crc, reinterpret_cast<const Bytef*>(b.data()), b.size());
+        header.FileSize += b.size();
+    }
+    header.CRC32 = static_cast<int32_t>(crc);
+
+    std::vector<char> out;
+    header.write(out);
+    header.FileSize += out.size();
+    out.clear();
+    header.write(out);
+    for (const auto& b : blocks)
+    {
+        out.insert(out.end(), b.begin(), b.end());
+    }
+    BinaryWriter::WriteFile(filename, out);
+}
+
 void Jazz2TileFormat::ReadFromFile(const std::string &filename)
 {
     using BinaryReader::ReadAndDecompress;
@@ -203,58 +285,99 @@ void Jazz2TileFormat::ReadFromFile(const std::string &filename)
     static_assert(sizeof(int32_t) == 4, "int32_t == 4 bytes");
     TILE_Header header;
     header.read(file);
-
-    unsigned long size = 0;
-
-    std::unique_ptr<char[]> u_data1(new char[header.UData1]);
-
+    if (!file)
+    {
+        throw std::runtime_error("Jazz2Tile file " + filename + " is truncated.");
+    }
+    if (header.Version != 0x200 && header.Version != 0x201)
     {
-        std::unique_ptr<char[]> c_data1(new char[header.CData1]);
-        file.read(&c_data1[0], header.CData1);
-        size = header.UData1;
-        ::uncompress((unsigned char*)&u_data1[0], &size, (const unsigned char*)&c_data1[0], header.CData1);
+        throw std::runtime_error("Unsupported Jazz2Tile file " + filename);
     }
 
-    TileSetInfo tileSetInfo;
-    assert(header.Version == 0x200 || header.Version == 0x201);
+    auto data1 = ReadAndDecompress(file, header.CData1, header.UData1); // tile set info
+    auto data2 = ReadAndDecompress(file, header.CData2, header.UData2); // image
+    auto data3 = ReadAndDecompress(file, header.CData3, header.UData3); // transparency mask
+    auto data4 = ReadAndDecompress(file, header.CData4, header.UData4); // clipping mask
+    const BinaryView::Array<char> images(&data2[0], header.UData2);
+    const BinaryView::Array<char> transparencyMasks(&data3[0], header.UData3);
+    const BinaryView::Array<char> collisionMasks(&data4[0], header.UData4);
+
     if (header.Version == 0x200)
     {
-        using BinaryReader::read;
-        TileSetInfo_123 info;
-        readTile(&u_data1[0], info);
-        tileSetInfo = ReadTileSetStruct<TileSetInfo_123, TileSetInfo>(info);
+        ReadTiles(TileSetInfoView<MAX_TILES_123>(&data1[0], header.UData1),
+                  images, transparencyMasks, collisionMasks);
     }
-    else if (header.Version == 0x201)
+    else
     {
-        using BinaryReader::read;
-        TileSetInfo_124 info;
-        readTile(&u_data1[0], info);
-        tileSetInfo = ReadTileSetStruct<TileSetInfo_124, TileSetInfo>(info);
+        ReadTiles(TileSetInfoView<MAX_TILES_124>(&data1[0], header.UData1),
+                  images, transparencyMasks, collisionMasks);
     }
+}
 
-    auto data2 = ReadAndDecompress(file, header.CData2, header.UData2); // image
-    auto data3 = ReadAndDecompress(file, header.CData3, header.UData3); // transparency mask
-    auto data4 = ReadAndDecompress(file, header.CData4, header.UData4); // clipping mask
+template<typename TileSetInfo>
+void Jazz2TileFormat::ReadTiles(const TileSetInfo& info, const BinaryView::Array<char>& images,
+                                const BinaryView::Array<char>& transparencyMasks,
+                                const BinaryView::Array<char>& collisionMasks)
+{
+    int32_t paletteColor[256];
+    memcpy(paletteColor, info.PaletteColor().data(), sizeof(paletteColor));
 
-    assert(tiles.empty() == true);
-    tiles.reserve(tileSetInfo.TileCount);
-    for (int i = 0; i < tileSetInfo.TileCount; ++i)
+    const int tileCount = info.TileCount();
+    if (tileCount < 0 || static_cast<size_t>(tileCount) > info.ImageAddress().size())
+    {
+        throw std::runtime_error("Tile set has " + std::to_string(tileCount) + " tiles, at most " +
+                                 std::to_string(info.ImageAddress().size()) + " fit.");
+    }
+    // every image and mask lies inside its block
+    auto check = [](const BinaryView::Array<char>& block, int32_t address, size_t size)
     {
-        tiles.push_back({tileSetInfo.PaletteColor,
-                        &data2[0] + tileSetInfo.ImageAddress[i],
-                        &data3[0] + tileSetInfo.TMaskAddress[i],
-                        &data4[0] + tileSetInfo.MaskAddress[i],
-                        &data4[0] + tileSetInfo.FMaskAddress[i]
-        });
+        if (address < 0 || static_cast<size_t>(address) + size > block.size())
+        {
+            throw std::runtime_error("Tile data at " + std::to_string(address) + " lies outside its block.");
+        }
+        return block.data() + address;
+    };
+    struct TileData
+    {
+        const char* image;
+        const char* transparencyMask;
+        const char* collisionMask;
+        const char* flippedCollisionMask;
+    };
+    std::vector<TileData> tileData(tileCount);
+    for (int i = 0; i < tileCount; ++i)
+    {
+        tileData[i].image = check(images, info.ImageAddress()[i], J2Tile::tileSize * J2Tile::tileSize);
+        tileData[i].transparencyMask = check(transparencyMasks, info.TMaskAddress()[i], J2Tile::collisionMapSize);
+        tileData[i].collisionMask = check(collisionMasks, info.MaskAddress()[i], J2Tile::collisionMapSize);
+        tileData[i].flippedCollisionMask = check(collisionMasks, info.FMaskAddress()[i],
+                                                 J2Tile::collisionMapSize);
+    }
 
-        flippedTiles.push_back({tileSetInfo.PaletteColor,
-                        &data2[0] + tileSetInfo.ImageAddress[i],
-                        &data3[0] + tileSetInfo.TMaskAddress[i],
-                        &data4[0] + tileSetInfo.MaskAddress[i],
-                        &data4[0] + tileSetInfo.FMaskAddress[i],
-                        true
-        });
+    assert(tiles.empty() == true);
+    // tiles convert independently, each into its own slot
+    std::vector<std::unique_ptr<J2Tile>> converted(2 * tileCount);
+    JobSystem::Instance().ParallelFor(0, tileCount, 64, [&](int first, int last)
+    {
+        MemoryScope scope(MemoryCategory::TileSet);
+        for (int i = first; i < last; ++i)
+        {
+            const TileData& t = tileData[i];
+            converted[2 * i].reset(new J2Tile(paletteColor, t.image, t.transparencyMask,
+                                              t.collisionMask, t.flippedCollisionMask));
+            converted[2 * i + 1].reset(new J2Tile(paletteColor, t.image, t.transparencyMask,
+                                                  t.collisionMask, t.flippedCollisionMask, true));
+        }
+    });
+    tiles.reserve(tileCount);
+    flippedTiles.reserve(tileCount);
+    for (int i = 0; i < tileCount; ++i)
+    {
+        tiles.push_back(std::move(*converted[2 * i]));
+        flippedTiles.push_back(std::move(*converted[2 * i + 1]));
     }
+    // the surfaces are charged as they are made
+    collisionMemory.Set(MemoryCategory::TileSet, 2 * static_cast<size_t>(tileCount) * J2Tile::collisionMapSize);
 
     // convert palette
     for (int i = 0; i < 256; ++i)
@@ -265,38 +388,9 @@ void Jazz2TileFormat::ReadFromFile(const std::string &filename)
             alpha = 0;
         }
         Color32 c;
-        c.SetColorRGBA(tileSetInfo.PaletteColor[i]);
+        c.SetColorRGBA(paletteColor[i]);
         palette.colors[i].SetColor(c.GetA(), c.GetB(), c.GetG(), alpha);
     }
     memcpy(&GraphicsEngine::getInstance().GetGlobalPalette(),
            &palette, sizeof(palette));
 }
-
-template<typename TileSetStruct, typename GenericTileSetStruct>
-GenericTileSetStruct Jazz2TileFormat::ReadTileSetStruct(const TileSetStruct& s)
-{
-    GenericTileSetStruct g;
-    memcpy(g.PaletteColor, s.PaletteColor, sizeof(s.PaletteColor));
-    g.TileCount = s.TileCount;
-    g.FullyOpaque.reserve(s.TileCount);
-    g.Unknown1.reserve(s.TileCount);
-    g.ImageAddress.reserve(s.TileCount);
-    g.Unknown2.reserve(s.TileCount);
-    g.TMaskAddress.reserve(s.TileCount);
-    g.Unknown3.reserve(s.TileCount);
-    g.MaskAddress.reserve(s.TileCount);
-    g.FMaskAddress.reserve(s.TileCount);
-    for (int32_t i = 0; i < s.TileCount; ++i)
-    {
-        g.FullyOpaque.push_back(s.FullyOpaque[i]);
-        g.Unknown1.push_back(s.Unknown1[i]);
-        g.ImageAddress.push_back(s.ImageAddress[i]);
-        g.Unknown2.push_back(s.Unknown2[i]);
-        g.TMaskAddress.push_back(s.TMaskAddress[i]);
-        g.Unknown3.push_back(s.Unknown3[i]);
-        g.MaskAddress.push_back(s.MaskAddress[i]);
-        g.FMaskAddress.push_back(s.FMaskAddress[i]);
-    }
-
-    return std::move(g);
-}
@@ -3,6 +3,9 @@
 
 #include "gfx/Surface.h"
 #include "gfx/Color32.h"
+#include "gfx/IndexedSurface.h"
+#include "utils/BinaryView.h"
+#include "utils/MemoryStats.h"
 
 #include <string>
 #include <vector>
@@ -21,33 +24,57 @@ constexpr int MAX_TILES_124 = 4096;
 class J2Tile
 {
 public:
-    J2Tile(int32_t* palette, char* image, char* transparencyMask,
-           char* collisionMask, char* flippedCollisionMask, bool flip = false);
+    J2Tile(const int32_t* palette, const char* image, const char* transparencyMask,
+           const char* collisionMask, const char* flippedCollisionMask, bool flip = false);
     J2Tile(J2Tile&&) = default;
     J2Tile& operator=(J2Tile&&) = default;
     static constexpr int tileSize = 32;
     SurfaceSharedPtr Image; // always 32x32
+    // palette indices of Image, transparent pixels are 0
+    std::shared_ptr<IndexedSurface> IndexedImage;
     static constexpr unsigned int collisionMapSize = 128;
     std::shared_ptr<std::vector<char>> collisionMap;
 };
 
+// Content of a tile set file for Jazz2TileFormat::Write. Per tile there
+// are 1024 palette indices (32x32) in images and 128 bytes of bits in each
+// of the masks (a set transparency bit is an opaque pixel). More than 1024
+// tiles make a 1.24 (TSF) file.
+struct J2TileSetContent
+{
+    std::string         title;
+    int32_t             palette[256] = {};
+    std::vector<char>   images;
+    std::vector<char>   transparencyMasks;
+    std::vector<char>   collisionMasks;
+    std::vector<char>   flippedCollisionMasks;
+
+    int TileCount() const { return static_cast<int>(images.size() / 1024); }
+};
+
 class Jazz2TileFormat
 {
 public:
     Jazz2TileFormat(const std::string& filename);
+    // writes a file this class reads back, throws std::runtime_error
+    static void Write(const std::string& filename, const J2TileSetContent& content);
 
     const Palette& getPalette() const { return palette; }
     const std::vector<J2Tile>& GetTileSet() const { return tiles; }
     const std::vector<J2Tile>& GetFlippedTileSet() const { return flippedTiles; }
 private:
     void ReadFromFile(const std::string& filename);
-    template<typename TileSetStruct, typename GenericTileSetStruct>
-    GenericTileSetStruct ReadTileSetStruct(const TileSetStruct& s);  
+    // throws std::runtime_error when an address or the tile count in Data1
+    // points outside the data blocks
+    template<typename TileSetInfo>
+    void ReadTiles(const TileSetInfo& info, const BinaryView::Array<char>& images,
+                   const BinaryView::Array<char>& transparencyMasks, const BinaryView::Array<char>& collisionMasks);
 
     Palette palette;
 
     std::vector<J2Tile> tiles;
     std::vector<J2Tile> flippedTiles;
+    MemoryCharge        collisionMemory;
 
 };
 
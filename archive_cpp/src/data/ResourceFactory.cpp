@@ -6,8 +6,12 @@
 #include "data/JJ2LevelBuilder.h"
 #include "data/JJ2HeroAnimMap.h"
 #include "utils/MicroLogger.h"
+#include "gfx/GraphicsEngine.h"
+#include "utils/JobSystem.h"
+#include "utils/MemoryStats.h"
 
 #include <map>
+#include <memory>
 
 // ResourceFactoryImpl implementation
 
@@ -21,6 +25,8 @@ public:
     LevelPtr LoadLevel(const std::string& levelFilename);
     ResourceDbg* LoadDeveloperPreview(const std::string& filename);
     Hero BuildHero();
+    FontPtr LoadFont(const std::string& animFilename);
+    SampleBank& LoadSampleBank(const std::string& animFilename);
 private:
     const Jazz2TileFormat& LoadTileSet(const std::string& tileName);
     const Jazz2AnimFormat& LoadAnimSet(const std::string& animName);
@@ -38,6 +44,10 @@ private:
     typedef std::map<std::string, std::unique_ptr<Jazz2AnimFormat>> Anims;
     Anims           _anims;
 
+    // after _anims, the banks refer to them
+    typedef std::map<std::string, std::unique_ptr<SampleBank>> SampleBanks;
+    SampleBanks     _sampleBanks;
+
     typedef std::map<std::string, std::unique_ptr<Jazz2LevelFormat>> Levels;
     Levels          _levels;
 
@@ -71,9 +81,27 @@ LevelPtr ResourceFactoryImpl::LoadLevel(const std::string& levelFilename)
     const auto& tiles = LoadTileSet(jj2lev.getTilesFile());
 
     JJ2LevelBuilder converter(jj2lev, anim);
+    // grids, events and the level's own tables share one arena, the level owns it
+    std::unique_ptr<Arena> arena{new Arena()};
 
     const auto layer_count = jj2lev.getLayers().size();
 
+    TileSetPtr tileSet;
+    {
+        MemoryScope scope(MemoryCategory::TileSet);
+        tileSet = converter.BuildTileSet(tiles);
+    }
+
+    // layers convert independently, each into its own slot
+    std::vector<std::unique_ptr<Layer>> converted(layer_count);
+    JobSystem::Instance().ParallelFor(0, static_cast<int>(layer_count), 1, [&](int first, int last)
+    {
+        for (int l = first; l < last; ++l)
+        {
+            converted[l].reset(new Layer(converter.ConvertFromJJ2Layer(jj2lev.getLayers()[l], tileSet, arena.get())));
+        }
+    });
+
     std::vector<Layer> layers;
     layers.reserve(layer_count);
 
@@ -82,29 +110,22 @@ LevelPtr ResourceFactoryImpl::LoadLevel(const std::string& levelFilename)
 
     for (unsigned int l = 0; l < layer_count; ++l)
     {
-        auto* jj2_layer = &jj2lev.getLayers()[l];
-        layers.push_back(converter.ConvertFromJJ2Layer(*jj2_layer));
+        layers.push_back(std::move(*converted[l]));
 
         if (l == action_layer_id)
         {
             world_width = layers[l].GetWidth();
             world_height = layers[l].GetHeight();
         }
-
-        for (uint32_t i = 0; i < jj2_layer->grid.size(); ++i)
-        {
-            auto* tileOnMap = &jj2_layer->grid[i];
-            if (tileOnMap->id != 0)
-            {
-                TilePtr t(new Tile{converter.ConvertFromJJ2Tile(*tileOnMap, tiles)});
-                layers[l].Add(t);
-            }
-        }
     }
 
-    auto entities = converter.LoadEvents();
+    LevelEntities entities;
+    {
+        MemoryScope scope(MemoryCategory::Events);
+        entities = converter.LoadEvents(arena.get());
+    }
 
-    auto l =  LevelPtr{new Level(world_width, world_height, std::move(layers),
+    auto l =  LevelPtr{new Level(std::move(arena), world_width, world_height, std::move(tileSet), std::move(layers),
                                 action_layer_id, std::move(entities.events),
                                 entities.heroStartPosition)};
 
@@ -143,7 +164,7 @@ ResourceDbg* ResourceFactoryImpl::LoadDeveloperPreview(const std::string& filena
 Hero ResourceFactoryImpl::BuildHero()
 {
     const auto& anim = LoadAnimSet("Anims.j2a");
-    AnimationHelper animHelper(anim, true);
+    AnimationHelper animHelper(anim);
     /*
      *AnimationState(int uid, Animation a, bool restartAnim = true,
                    SelfInterruptMode intMode = SelfInterruptMode::NoSelfInterruption,
@@ -171,6 +192,41 @@ Hero ResourceFactoryImpl::BuildHero()
     return h;
 }
 
+FontPtr ResourceFactoryImpl::LoadFont(const std::string& animFilename)
+{
+    const auto& anim = LoadAnimSet(animFilename);
+    MemoryScope scope(MemoryCategory::Text);
+    FontPtr font;
+    for (unsigned i = 0; i < anim.GetAnimationSetLength(); ++i)
+    {
+        for (unsigned j = 0; j < anim.GetAnimationLength(i); ++j)
+        {
+            if (!anim.IsFont(i, j))
+            {
+                continue;
+            }
+            FontPtr f = std::make_shared<Font>(
+                        anim.GetFontGlyphs(i, j, GraphicsEngine::getInstance().GetGlobalPalette()));
+            if (!font || f->GetLineHeight() < font->GetLineHeight())
+            {
+                font = f;
+            }
+        }
+    }
+    return font;
+}
+
+SampleBank& ResourceFactoryImpl::LoadSampleBank(const std::string& animFilename)
+{
+    auto it = _sampleBanks.find(animFilename);
+    if (it == _sampleBanks.end())
+    {
+        std::unique_ptr<SampleBank> bank(new SampleBank(LoadAnimSet(animFilename)));
+        it = _sampleBanks.insert(SampleBanks::value_type{animFilename, std::move(bank)}).first;
+    }
+    return *it->second;
+}
+
 const Jazz2TileFormat& ResourceFactoryImpl::LoadTileSet(const std::string &tileName)
 {
     return LoadResource<Tiles>(_tiles, tileName);
@@ -225,31 +281,49 @@ ResourceFactory &ResourceFactory::GetInstance()
     return builder;
 }
 
+void ResourceFactory::SetResourcePath(const std::string& path)
+{
+    LOG_INFO << "Loading resources from " << path << "\n";
+    pimpl.reset(new ResourceFactoryImpl(path));
+}
+
 const SurfaceSharedPtr ResourceFactory::LoadSurface(const std::string &resourceName)
 {
-    LOG << "Loading surface (with transparency)"  << resourceName << "\n";
+    LOG_DEBUG << "Loading surface (with transparency) "  << resourceName << "\n";
     return pimpl->LoadSurface(resourceName);
 }
 
 const SurfaceSharedPtr ResourceFactory::LoadSurface(const std::string& resourceName,
                                                     int transparency_r, int transparency_g, int transparency_b)
 {
-    LOG << "Loading surface "  << resourceName << "\n";
+    LOG_DEBUG << "Loading surface " << resourceName << "\n";
     return pimpl->LoadSurface(resourceName, transparency_r, transparency_g, transparency_b);
 }
 
 LevelPtr ResourceFactory::LoadLevel(const std::string& levelFilename)
 {
-    LOG << "Loading level " << levelFilename << "\n";
+    LOG_INFO << "Loading level " << levelFilename << "\n";
     return pimpl->LoadLevel(levelFilename);
 }
 
 Hero ResourceFactory::BuildHero()
 {
-    LOG << "Building a hero \n";
+    LOG_DEBUG << "Building a hero\n";
     return pimpl->BuildHero();
 }
 
+FontPtr ResourceFactory::LoadFont(const std::string& animFilename)
+{
+    LOG_DEBUG << "Loading font from " << animFilename << "\n";
+    return pimpl->LoadFont(animFilename);
+}
+
+SampleBank& ResourceFactory::LoadSampleBank(const std::string& animFilename)
+{
+    LOG_DEBUG << "Loading samples of " << animFilename << "\n";
+    return pimpl->LoadSampleBank(animFilename);
+}
+
 ResourceDbg* ResourceFactory::LoadDeveloperPreview(const std::string& filename)
 {
     return pimpl->LoadDeveloperPreview(filename);
@@ -7,6 +7,8 @@
 #include "game/Level.h"
 #include "game/Hero.h"
 #include "gfx/Surface.h"
+#include "gfx/Font.h"
+#include "audio/SampleBank.h"
 // for debug only
 #include "game/ResourceDbg.h"
 
@@ -16,11 +18,19 @@ class ResourceFactory
 {
 public:
     static ResourceFactory& GetInstance();
+    // resources are loaded from path ("media/" by default, ends with a
+    // slash) from now on, everything cached so far is dropped
+    void SetResourcePath(const std::string& path);
     const SurfaceSharedPtr LoadSurface(const std::string& resourceName);
     const SurfaceSharedPtr LoadSurface(const std::string& resourceName,
                                        int transparency_r, int transparency_g, int transparency_b);
     LevelPtr LoadLevel(const std::string& levelFilename);
     Hero BuildHero();
+    // the smallest font of the animation file, nullptr if it has none
+    FontPtr LoadFont(const std::string& animFilename);
+    // the samples of the animation file, decoded a set at a time when first
+    // asked for; valid until SetResourcePath
+    SampleBank& LoadSampleBank(const std::string& animFilename);
 
     // only for debug purpose
     ResourceDbg* LoadDeveloperPreview(const std::string& filename);
@@ -0,0 +1,25 @@
+#include "ActivityScheduler.h"
+
+#include <assert.h>
+
+ActivityScheduler::ActivityScheduler(int entity_count, Arena* arena)
+    : lastTick(entity_count, 0, ArenaAllocator<uint32_t>(arena))
+    , wakeTimes(entity_count, time_point::max(), ArenaAllocator<time_point>(arena))
+{ }
+
+void ActivityScheduler::Resize(int entity_count)
+{
+    lastTick.resize(entity_count, 0);
+    wakeTimes.resize(entity_count, time_point::max());
+}
+
+void ActivityScheduler::WakeAt(int entity, const time_point& t)
+{
+    assert(entity >= 0 && entity < static_cast<int>(lastTick.size()));
+    if (t == wakeTimes[entity])
+    {
+        return;
+    }
+    wakeTimes[entity] = t;
+    timers.push({t, entity});
+}
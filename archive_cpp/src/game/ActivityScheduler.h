@@ -0,0 +1,80 @@
+#ifndef ACTIVITYSCHEDULER_H
+#define ACTIVITYSCHEDULER_H
+
+#include "BroadPhaseGrid.h"
+#include "utils/Arena.h"
+#include "utils/Time.h"
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+// Decides which entities get their logic updated in a tick. Entities are
+// found through a broad phase grid (user data = entity index): only those
+// within the activity areas (e.g. around the camera and the players) are
+// ticked, so sleeping entities cost nothing. A sleeping entity can also be
+// woken up once at a given time, an entity has at most one wake-up.
+class ActivityScheduler
+{
+public:
+    explicit ActivityScheduler(int entity_count = 0, Arena* arena = nullptr);
+    void Resize(int entity_count);
+    // replaces the entity's pending wake-up, if any
+    void WakeAt(int entity, const time_point& t);
+    // calls update(int entity) once for every entity inside one of the
+    // areas or with an expired wake-up time
+    template <class Fn>
+    void Tick(const time_point& now, const BroadPhaseGrid& grid,
+              const Rectangle2D* areas, int area_count, Fn&& update);
+    int GetActiveCount() const { return activeCount; }
+private:
+    struct Timer
+    {
+        time_point  time;
+        int         entity;
+        bool operator<(const Timer& t) const { return time > t.time; }
+    };
+
+    ArenaVector<uint32_t>       lastTick; // avoids updating an entity twice per tick
+    ArenaVector<time_point>     wakeTimes; // pending wake-up, time_point::max() for none
+    std::priority_queue<Timer>  timers;
+    uint32_t                    tick = 0;
+    int                         activeCount = 0;
+};
+
+template <class Fn>
+void ActivityScheduler::Tick(const time_point& now, const BroadPhaseGrid& grid,
+                             const Rectangle2D* areas, int area_count, Fn&& update)
+{
+    ++tick;
+    activeCount = 0;
+    auto visit = [&](int entity)
+    {
+        if (lastTick[entity] != tick)
+        {
+            lastTick[entity] = tick;
+            ++activeCount;
+            update(entity);
+        }
+    };
+    for (int a = 0; a < area_count; ++a)
+    {
+        grid.QueryRect(areas[a], [&](BroadPhaseGrid::ProxyId id)
+        {
+            visit(static_cast<int>(grid.GetUserData(id)));
+        });
+    }
+    while (!timers.empty() && timers.top().time <= now)
+    {
+        const Timer timer = timers.top();
+        timers.pop();
+        // timers replaced by a later WakeAt are skipped
+        if (timer.time == wakeTimes[timer.entity])
+        {
+            wakeTimes[timer.entity] = time_point::max();
+            visit(timer.entity);
+        }
+    }
+}
+
+#endif // ACTIVITYSCHEDULER_H
@@ -0,0 +1,143 @@
+#include "BroadPhaseGrid.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace {
+
+inline int FloorDiv(int a, int b)
+{
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+}
+
+BroadPhaseGrid::BroadPhaseGrid(int world_width, int world_height, int cell_size, Arena* arena)
+    : cellSize(cell_size)
+    , columns(std::max(1, (world_width + cell_size - 1) / cell_size))
+    , rows(std::max(1, (world_height + cell_size - 1) / cell_size))
+    , cellHeads(columns * rows, -1, ArenaAllocator<int>(arena))
+    , proxies(ArenaAllocator<Proxy>(arena))
+    , entries(ArenaAllocator<Entry>(arena))
+{
+    assert(cell_size > 0);
+}
+
+BroadPhaseGrid::ProxyId BroadPhaseGrid::Insert(const Rectangle2D& box, uint32_t user_data)
+{
+    ProxyId id;
+    if (!freeProxies.empty())
+    {
+        id = freeProxies.back();
+        freeProxies.pop_back();
+    }
+    else
+    {
+        id = static_cast<ProxyId>(proxies.size());
+        proxies.emplace_back();
+    }
+    Proxy& p = proxies[id];
+    p.box = box;
+    p.cells = GetCellRange(box);
+    p.userData = user_data;
+    p.queryStamp = 0;
+    Link(id);
+    ++proxyCount;
+    return id;
+}
+
+void BroadPhaseGrid::Move(ProxyId id, const Rectangle2D& box)
+{
+    Proxy& p = proxies[id];
+    CellRange c = GetCellRange(box);
+    p.box = box;
+    if (c.x0 == p.cells.x0 && c.y0 == p.cells.y0 && c.x1 == p.cells.x1 && c.y1 == p.cells.y1)
+    {
+        return;
+    }
+    Unlink(id);
+    p.cells = c;
+    Link(id);
+}
+
+void BroadPhaseGrid::Remove(ProxyId id)
+{
+    assert(proxies[id].firstEntry != -1);
+    Unlink(id);
+    freeProxies.push_back(id);
+    --proxyCount;
+}
+
+BroadPhaseGrid::CellRange BroadPhaseGrid::GetCellRange(const Rectangle2D& box) const
+{
+    // boxes outside of the world are kept in the border cells
+    CellRange c;
+    c.x0 = std::min(std::max(FloorDiv(box.x, cellSize), 0), columns - 1);
+    c.y0 = std::min(std::max(FloorDiv(box.y, cellSize), 0), rows - 1);
+    c.x1 = std::min(std::max(FloorDiv(box.x + std::max(box.w, 1) - 1, cellSize), 0), columns - 1);
+    c.y1 = std::min(std::max(FloorDiv(box.y + std::max(box.h, 1) - 1, cellSize), 0), rows - 1);
+    return c;
+}
+
+void BroadPhaseGrid::Link(ProxyId id)
+{
+    Proxy& p = proxies[id];
+    assert(p.firstEntry == -1);
+    for (int cy = p.cells.y0; cy <= p.cells.y1; ++cy)
+    {
+        for (int cx = p.cells.x0; cx <= p.cells.x1; ++cx)
+        {
+            int e;
+            if (freeEntries != -1)
+            {
+                e = freeEntries;
+                freeEntries = entries[e].next;
+            }
+            else
+            {
+                e = static_cast<int>(entries.size());
+                entries.emplace_back();
+            }
+            const int cell = cy * columns + cx;
+            Entry& en = entries[e];
+            en.proxy = id;
+            en.cell = cell;
+            en.prev = -1;
+            en.next = cellHeads[cell];
+            en.nextOfProxy = p.firstEntry;
+            if (en.next != -1)
+            {
+                entries[en.next].prev = e;
+            }
+            cellHeads[cell] = e;
+            p.firstEntry = e;
+        }
+    }
+}
+
+void BroadPhaseGrid::Unlink(ProxyId id)
+{
+    Proxy& p = proxies[id];
+    int e = p.firstEntry;
+    while (e != -1)
+    {
+        Entry& en = entries[e];
+        if (en.prev != -1)
+        {
+            entries[en.prev].next = en.next;
+        }
+        else
+        {
+            cellHeads[en.cell] = en.next;
+        }
+        if (en.next != -1)
+        {
+            entries[en.next].prev = en.prev;
+        }
+        int next = en.nextOfProxy;
+        en.next = freeEntries;
+        freeEntries = e;
+        e = next;
+    }
+    p.firstEntry = -1;
+}
@@ -0,0 +1,136 @@
+#ifndef BROADPHASEGRID_H
+#define BROADPHASEGRID_H
+
+#include "utils/Arena.h"
+#include "utils/Utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Uniform grid broad phase for dynamic entities. An entity (proxy) is
+// linked into every cell its box touches, so boxes larger than a cell are
+// fine. Insert, move and remove cost O(number of touched cells), and a move
+// that stays within the same cells only updates the box.
+class BroadPhaseGrid
+{
+public:
+    typedef int ProxyId;
+    static constexpr ProxyId invalidProxy = -1;
+
+    // cells, proxies and links are allocated in arena, on the heap without one
+    BroadPhaseGrid(int world_width, int world_height, int cell_size, Arena* arena = nullptr);
+
+    ProxyId Insert(const Rectangle2D& box, uint32_t user_data);
+    void Move(ProxyId id, const Rectangle2D& box);
+    void Remove(ProxyId id);
+    const Rectangle2D& GetBox(ProxyId id) const { return proxies[id].box; }
+    uint32_t GetUserData(ProxyId id) const { return proxies[id].userData; }
+    int GetProxyCount() const { return proxyCount; }
+
+    // calls fn(ProxyId) once for every proxy overlapping r
+    template <class Fn>
+    void QueryRect(const Rectangle2D& r, Fn&& fn) const;
+    // calls fn(ProxyId, ProxyId) once for every pair of overlapping proxies
+    template <class Fn>
+    void QueryPairs(Fn&& fn) const;
+
+    static bool Overlap(const Rectangle2D& a, const Rectangle2D& b)
+    {
+        return a.x < b.x + b.w && b.x < a.x + a.w
+            && a.y < b.y + b.h && b.y < a.y + a.h;
+    }
+private:
+    struct CellRange
+    {
+        int x0, y0, x1, y1;
+    };
+
+    struct Proxy
+    {
+        Rectangle2D     box;
+        CellRange       cells;
+        int             firstEntry = -1;    // entries of this proxy, one per cell
+        uint32_t        userData = 0;
+        mutable uint32_t queryStamp = 0;
+    };
+
+    // membership of a proxy in a cell, cell lists are doubly linked
+    struct Entry
+    {
+        ProxyId proxy;
+        int     cell;
+        int     prev;
+        int     next;
+        int     nextOfProxy;
+    };
+
+    const int cellSize;
+    const int columns;
+    const int rows;
+    ArenaVector<int>        cellHeads;
+    ArenaVector<Proxy>      proxies;
+    std::vector<ProxyId>    freeProxies;
+    ArenaVector<Entry>      entries;
+    int                     freeEntries = -1;
+    int                     proxyCount = 0;
+    mutable uint32_t        queryStamp = 0;
+
+    CellRange GetCellRange(const Rectangle2D& box) const;
+    void Link(ProxyId id);
+    void Unlink(ProxyId id);
+};
+
+template <class Fn>
+void BroadPhaseGrid::QueryRect(const Rectangle2D& r, Fn&& fn) const
+{
+    // a proxy spanning several cells is met more than once, the stamp
+    // makes sure it is reported only the first time
+    ++queryStamp;
+    CellRange c = GetCellRange(r);
+    for (int cy = c.y0; cy <= c.y1; ++cy)
+    {
+        for (int cx = c.x0; cx <= c.x1; ++cx)
+        {
+            for (int e = cellHeads[cy * columns + cx]; e != -1; e = entries[e].next)
+            {
+                const Proxy& p = proxies[entries[e].proxy];
+                if (p.queryStamp != queryStamp && Overlap(p.box, r))
+                {
+                    p.queryStamp = queryStamp;
+                    fn(entries[e].proxy);
+                }
+            }
+        }
+    }
+}
+
+template <class Fn>
+void BroadPhaseGrid::QueryPairs(Fn&& fn) const
+{
+    for (int cell = 0; cell < static_cast<int>(cellHeads.size()); ++cell)
+    {
+        const int cx = cell % columns;
+        const int cy = cell / columns;
+        for (int a = cellHeads[cell]; a != -1; a = entries[a].next)
+        {
+            const Proxy& pa = proxies[entries[a].proxy];
+            for (int b = entries[a].next; b != -1; b = entries[b].next)
+            {
+                const Proxy& pb = proxies[entries[b].proxy];
+                // two proxies can share many cells, the pair belongs to the
+                // first cell of the overlap of their cell ranges
+                if (cx != std::max(pa.cells.x0, pb.cells.x0) || cy != std::max(pa.cells.y0, pb.cells.y0))
+                {
+                    continue;
+                }
+                if (Overlap(pa.box, pb.box))
+                {
+                    fn(entries[a].proxy, entries[b].proxy);
+                }
+            }
+        }
+    }
+}
+
+#endif // BROADPHASEGRID_H
@@ -0,0 +1,178 @@
+#include "CollisionBitmap.h"
+#include "Layer.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+inline int CountTrailingZeros(uint64_t w)
+{
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, w);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(w);
+#endif
+}
+
+inline int CountLeadingZeros(uint64_t w)
+{
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanReverse64(&i, w);
+    return 63 - static_cast<int>(i);
+#else
+    return __builtin_clzll(w);
+#endif
+}
+
+// first set bit of a bit line between from and to (inclusive), scanning
+// whole words at a time
+bool FirstSetBit(const uint64_t* line, int length, int from, int to, int& hit)
+{
+    const uint64_t all = ~uint64_t(0);
+    if (from <= to)
+    {
+        if (to < 0 || from >= length)
+        {
+            return false;
+        }
+        from = std::max(from, 0);
+        to = std::min(to, length - 1);
+        int w = from >> 6;
+        const int last = to >> 6;
+        uint64_t word = line[w] & (all << (from & 63));
+        for (;;)
+        {
+            if (w == last)
+            {
+                word &= all >> (63 - (to & 63));
+            }
+            if (word != 0)
+            {
+                hit = w * 64 + CountTrailingZeros(word);
+                return true;
+            }
+            if (w == last)
+            {
+                return false;
+            }
+            word = line[++w];
+        }
+    }
+    else
+    {
+        if (from < 0 || to >= length)
+        {
+            return false;
+        }
+        from = std::min(from, length - 1);
+        to = std::max(to, 0);
+        int w = from >> 6;
+        const int last = to >> 6;
+        uint64_t word = line[w] & (all >> (63 - (from & 63)));
+        for (;;)
+        {
+            if (w == last)
+            {
+                word &= all << (to & 63);
+            }
+            if (word != 0)
+            {
+                hit = w * 64 + 63 - CountLeadingZeros(word);
+                return true;
+            }
+            if (w == last)
+            {
+                return false;
+            }
+            word = line[--w];
+        }
+    }
+}
+
+}
+
+CollisionBitmap::CollisionBitmap(int width_, int height_, Arena* arena)
+    : width(width_)
+    , height(height_)
+    , wordsPerRow((width_ + 63) / 64)
+    , wordsPerColumn((height_ + 63) / 64)
+    , rows(wordsPerRow * height_, 0, ArenaAllocator<uint64_t>(arena))
+    , columns(wordsPerColumn * width_, 0, ArenaAllocator<uint64_t>(arena))
+    , memory(MemoryCategory::Collision, HeapBytes(rows) + HeapBytes(columns))
+{ }
+
+CollisionBitmap::CollisionBitmap(const Layer& layer, Arena* arena)
+    : CollisionBitmap(layer.GetWidth(), layer.GetHeight(), arena)
+{
+    static_assert(TileSet::tileSize == 32, "tile rows are copied as 32-bit words");
+    const TileSet& ts = layer.GetTileSet();
+    for (int ty = 0; ty < layer.GetHeightInTiles(); ++ty)
+    {
+        for (int tx = 0; tx < layer.GetWidthInTiles(); ++tx)
+        {
+            TileId id = layer.GetTileId(tx, ty);
+            if (id == 0)
+            {
+                continue;
+            }
+            const auto* mask = reinterpret_cast<const unsigned char*>(
+                        ts.GetCollisionMask(id, layer.IsFlipped(tx, ty)));
+            if (mask == nullptr)
+            {
+                continue;
+            }
+            const int x = tx * TileSet::tileSize;
+            for (int dy = 0; dy < TileSet::tileSize; ++dy, mask += 4)
+            {
+                // mask bits are stored LSB first, bit dx of the row is pixel dx
+                uint64_t bits = uint64_t(mask[0]) | uint64_t(mask[1]) << 8
+                              | uint64_t(mask[2]) << 16 | uint64_t(mask[3]) << 24;
+                if (bits == 0)
+                {
+                    continue;
+                }
+                const int y = ty * TileSet::tileSize + dy;
+                rows[y * wordsPerRow + (x >> 6)] |= bits << (x & 63);
+                while (bits != 0)
+                {
+                    int dx = CountTrailingZeros(bits);
+                    bits &= bits - 1;
+                    columns[(x + dx) * wordsPerColumn + (y >> 6)] |= uint64_t(1) << (y & 63);
+                }
+            }
+        }
+    }
+}
+
+void CollisionBitmap::SetSolid(int x, int y)
+{
+    assert(x >= 0 && y >= 0 && x < width && y < height);
+    rows[y * wordsPerRow + (x >> 6)] |= uint64_t(1) << (x & 63);
+    columns[x * wordsPerColumn + (y >> 6)] |= uint64_t(1) << (y & 63);
+}
+
+bool CollisionBitmap::FirstSolidInRow(int y, int x_from, int x_to, int& hit) const
+{
+    if (y < 0 || y >= height)
+    {
+        return false;
+    }
+    return FirstSetBit(&rows[y * wordsPerRow], width, x_from, x_to, hit);
+}
+
+bool CollisionBitmap::FirstSolidInColumn(int x, int y_from, int y_to, int& hit) const
+{
+    if (x < 0 || x >= width)
+    {
+        return false;
+    }
+    return FirstSetBit(&columns[x * wordsPerColumn], height, y_from, y_to, hit);
+}
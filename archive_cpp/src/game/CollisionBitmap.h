@@ -0,0 +1,54 @@
+#ifndef COLLISIONBITMAP_H
+#define COLLISIONBITMAP_H
+
+#include "utils/Arena.h"
+#include "utils/MemoryStats.h"
+
+#include <cstdint>
+#include <vector>
+
+class Layer;
+
+// Level-wide terrain mask, one bit per pixel. Rows are stored as 64-bit
+// words and a transposed copy keeps columns contiguous as well, so sweeps
+// along both axes test 64 pixels at once. Pixels outside of the bitmap
+// are never solid.
+class CollisionBitmap
+{
+public:
+    CollisionBitmap() = default;
+    // the words are allocated in arena, on the heap without one
+    CollisionBitmap(int width, int height, Arena* arena = nullptr);
+    // built from the collision masks of all tiles of the layer
+    explicit CollisionBitmap(const Layer& layer, Arena* arena = nullptr);
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    void SetSolid(int x, int y);
+    bool IsSolid(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= width || y >= height)
+        {
+            return false;
+        }
+        return (rows[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+    // makes the bitmap usable as a terrain getter in CollisionEngine
+    bool operator()(int x, int y) const { return IsSolid(x, y); }
+
+    // Scans row y from x_from to x_to (both inclusive, in either direction)
+    // and stores the first solid x in hit. Returns false if there is none.
+    bool FirstSolidInRow(int y, int x_from, int x_to, int& hit) const;
+    // Same as above for column x, from y_from to y_to.
+    bool FirstSolidInColumn(int x, int y_from, int y_to, int& hit) const;
+private:
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+    int wordsPerColumn = 0;
+    ArenaVector<uint64_t> rows;     // [y * wordsPerRow + x / 64], bit x % 64
+    ArenaVector<uint64_t> columns;  // [x * wordsPerColumn + y / 64], bit y % 64
+    MemoryCharge memory;
+};
+
+#endif // COLLISIONBITMAP_H
@@ -0,0 +1,70 @@
+#include "CollisionWorld.h"
+#include "utils/JobSystem.h"
+
+int BodyBatch::Add(const Rectangle2D& box, const Vector2D& v)
+{
+    x.push_back(box.x);
+    y.push_back(box.y);
+    dx.push_back(v.dx);
+    dy.push_back(v.dy);
+    w.push_back(box.w);
+    h.push_back(box.h);
+    contacts.push_back(0);
+    return Size() - 1;
+}
+
+void BodyBatch::Clear()
+{
+    x.clear();
+    y.clear();
+    dx.clear();
+    dy.clear();
+    w.clear();
+    h.clear();
+    contacts.clear();
+}
+
+constexpr int CollisionWorld::chunkSize;
+
+CollisionWorld::CollisionWorld(Execution execution)
+    : execution(execution)
+{
+}
+
+void CollisionWorld::Resolve(const CollisionBitmap& terrain, BodyBatch& bodies) const
+{
+    const int count = bodies.Size();
+    // a job per chunk only pays from two full chunks on
+    if (execution == Execution::Inline || count < 2 * chunkSize)
+    {
+        ResolveRange(terrain, bodies, 0, count);
+        return;
+    }
+    JobSystem::Instance().ParallelFor(0, count, chunkSize, [&terrain, &bodies](int first, int last)
+    {
+        ResolveRange(terrain, bodies, first, last);
+    });
+}
+
+void CollisionWorld::ResolveRange(const CollisionBitmap& terrain, BodyBatch& bodies, int from, int to)
+{
+    for (int i = from; i < to; ++i)
+    {
+        auto r = CollisionEngine::SweepBox(terrain, {bodies.x[i], bodies.y[i], bodies.w[i], bodies.h[i]},
+                                           {bodies.dx[i], bodies.dy[i]});
+        bodies.x[i] += r.moved.dx;
+        bodies.y[i] += r.moved.dy;
+        if (r.normal.dx != 0)
+        {
+            bodies.dx[i] = 0;
+        }
+        if (r.normal.dy != 0)
+        {
+            bodies.dy[i] = 0;
+        }
+        bodies.contacts[i] = (r.contacts.onTheGround ? BodyBatch::OnTheGround : 0)
+                | (r.contacts.inFrontOfLeftWall ? BodyBatch::InFrontOfLeftWall : 0)
+                | (r.contacts.inFrontOfRightWall ? BodyBatch::InFrontOfRightWall : 0)
+                | (r.contacts.touchCeiling ? BodyBatch::TouchCeiling : 0);
+    }
+}
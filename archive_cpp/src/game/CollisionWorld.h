@@ -0,0 +1,64 @@
+#ifndef COLLISIONWORLD_H
+#define COLLISIONWORLD_H
+
+#include "CollisionEngine.h"
+#include "game/CollisionBitmap.h"
+
+#include <cstdint>
+#include <vector>
+
+// Moving bodies (enemies, projectiles, ...) stored as structure of arrays,
+// all fields are indexed by the body number.
+struct BodyBatch
+{
+    enum ContactFlags : uint8_t
+    {
+        OnTheGround         = 1,
+        InFrontOfLeftWall   = 2,
+        InFrontOfRightWall  = 4,
+        TouchCeiling        = 8
+    };
+
+    // top left corner, updated by CollisionWorld::Resolve
+    std::vector<int32_t>    x;
+    std::vector<int32_t>    y;
+    // movement per tick, the blocked components are cleared by Resolve
+    std::vector<int32_t>    dx;
+    std::vector<int32_t>    dy;
+    std::vector<int32_t>    w;
+    std::vector<int32_t>    h;
+    // results of the last Resolve
+    std::vector<uint8_t>    contacts;
+
+    int Add(const Rectangle2D& box, const Vector2D& v);
+    void Clear();
+    int Size() const { return static_cast<int>(x.size()); }
+};
+
+// Resolves batches of bodies against the terrain, on the calling thread or
+// on the JobSystem. There bodies are split into chunks of at least
+// chunkSize resolved as jobs, smaller batches are still resolved inline.
+// Every body is resolved independently against the read-only terrain, so
+// the results do not depend on where they are resolved or how the bodies
+// are split.
+class CollisionWorld
+{
+public:
+    static constexpr int chunkSize = 256;
+
+    enum class Execution
+    {
+        Inline,
+        JobSystem
+    };
+
+    explicit CollisionWorld(Execution execution = Execution::JobSystem);
+    Execution GetExecution() const { return execution; }
+    void Resolve(const CollisionBitmap& terrain, BodyBatch& bodies) const;
+private:
+    Execution execution;
+
+    static void ResolveRange(const CollisionBitmap& terrain, BodyBatch& bodies, int from, int to);
+};
+
+#endif // COLLISIONWORLD_H
@@ -1,7 +1,5 @@
 #include "Event.h"
 
-IEvent::~IEvent() { }
-
 Point2D NormalizeToDisplay(const Surface& eventSurface, const Rectangle2D& positionOnSurface)
 {
     int x = positionOnSurface.x;
@@ -0,0 +1,276 @@
+#include "EventStore.h"
+
+#include <algorithm>
+#include <numeric>
+#include <assert.h>
+
+namespace {
+
+const miliseconds springBlockTime{900};
+
+// in place, a new array would be a dead copy in the arena
+template <class T>
+void Permute(ArenaVector<T>& v, const std::vector<int>& order)
+{
+    std::vector<T> sorted;
+    sorted.reserve(v.size());
+    for (int i : order)
+    {
+        sorted.push_back(std::move(v[i]));
+    }
+    std::move(sorted.begin(), sorted.end(), v.begin());
+}
+
+}
+
+constexpr int EventStore::none;
+
+EventStore::EventStore(Arena* arena)
+    : positions(ArenaAllocator<Point2D>(arena))
+    , types(ArenaAllocator<EventType>(arena))
+    , flags(ArenaAllocator<uint8_t>(arena))
+    , jj2Ids(ArenaAllocator<uint16_t>(arena))
+    , animationIds(ArenaAllocator<int32_t>(arena))
+    , playback(ArenaAllocator<AnimationPlayback>(arena))
+    , messageIds(ArenaAllocator<int32_t>(arena))
+    , lastTrigger(ArenaAllocator<time_point>(arena))
+{ }
+
+void EventStore::Reserve(int count)
+{
+    positions.reserve(count);
+    types.reserve(count);
+    flags.reserve(count);
+    jj2Ids.reserve(count);
+    animationIds.reserve(count);
+    playback.reserve(count);
+    messageIds.reserve(count);
+    lastTrigger.reserve(count);
+}
+
+int EventStore::Add(EventType type, int jj2_id, const Point2D& position)
+{
+    positions.push_back(position);
+    types.push_back(type);
+    flags.push_back(Active);
+    jj2Ids.push_back(static_cast<uint16_t>(jj2_id));
+    animationIds.push_back(none);
+    playback.emplace_back();
+    messageIds.push_back(none);
+    lastTrigger.emplace_back();
+    return Size() - 1;
+}
+
+int EventStore::AddAnimation(const Animation& a)
+{
+    animations.push_back(a);
+    return static_cast<int>(animations.size()) - 1;
+}
+
+void EventStore::SetAnimation(int e, int animation_id)
+{
+    if (animation_id == none || animations[animation_id].FrameCount() == 0)
+    {
+        return;
+    }
+    const Animation& a = animations[animation_id];
+    animationIds[e] = animation_id;
+    flags[e] |= Animated;
+    if (types[e] == EventType::Spring)
+    {
+        playback[e] = AnimationPlayback(AnimationStrategy::OnlyFirtsFrame, a.GetFps(), a.FrameCount());
+    }
+    else
+    {
+        playback[e] = a.GetPlayback();
+    }
+}
+
+void EventStore::SetMessage(int e, const std::string& msg)
+{
+    auto it = messageIndex.find(msg);
+    if (it == messageIndex.end())
+    {
+        messages.emplace_back();
+        messages.back().Set(msg, {255, 255, 255, 160});
+        it = messageIndex.emplace(msg, static_cast<int>(messages.size()) - 1).first;
+    }
+    messageIds[e] = it->second;
+}
+
+void EventStore::SortByType()
+{
+    std::vector<int> order(types.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+    {
+        return types[a] < types[b];
+    });
+    Permute(positions, order);
+    Permute(types, order);
+    Permute(flags, order);
+    Permute(jj2Ids, order);
+    Permute(animationIds, order);
+    Permute(playback, order);
+    Permute(messageIds, order);
+    Permute(lastTrigger, order);
+    memory.Set(MemoryCategory::Events, HeapBytes(positions) + HeapBytes(types) + HeapBytes(flags) +
+               HeapBytes(jj2Ids) + HeapBytes(animationIds) + HeapBytes(playback) + HeapBytes(messageIds) +
+               HeapBytes(lastTrigger) + HeapBytes(animations) + HeapBytes(messages));
+}
+
+void EventStore::Update(const time_point& now, const std::vector<int>& events)
+{
+    Iter first = events.begin();
+    Iter last = TypeEnd(first, events.end(), EventType::Unknown);
+    // unknown events have no logic
+    first = last;
+    last = TypeEnd(first, events.end(), EventType::Standard);
+    UpdateAnimations(first, last, now);
+    first = last;
+    last = TypeEnd(first, events.end(), EventType::Bonus);
+    UpdateAnimations(first, last, now);
+    first = last;
+    last = TypeEnd(first, events.end(), EventType::Spring);
+    UpdateSprings(first, last, now);
+}
+
+void EventStore::Capture(RenderSnapshot& snapshot, const std::vector<int>& events, uint8_t depth) const
+{
+    Iter first = events.begin();
+    Iter last = TypeEnd(first, events.end(), EventType::Unknown);
+    CaptureMessages(snapshot, first, last, depth);
+    first = last;
+    last = TypeEnd(first, events.end(), EventType::Standard);
+    CaptureSprites(snapshot, first, last, depth);
+    CaptureMessages(snapshot, first, last, depth);
+    first = last;
+    last = TypeEnd(first, events.end(), EventType::Bonus);
+    CaptureSprites(snapshot, first, last, depth);
+    first = last;
+    last = TypeEnd(first, events.end(), EventType::Spring);
+    CaptureSprites(snapshot, first, last, depth);
+}
+
+EventCommand EventStore::CollisionWithHero(int e, const time_point& now)
+{
+    EventCommand c;
+    if (!(flags[e] & Active))
+    {
+        return c;
+    }
+    switch (types[e])
+    {
+    case EventType::Bonus:
+        flags[e] &= ~Active;
+        break;
+    case EventType::Spring:
+        if (!(flags[e] & Jumping) && (now - lastTrigger[e]) >= springBlockTime)
+        {
+            lastTrigger[e] = now;
+            if (animationIds[e] != none)
+            {
+                const Animation& a = animations[animationIds[e]];
+                playback[e] = AnimationPlayback(AnimationStrategy::AnimateTillLastFrame,
+                                                a.GetFps(), a.FrameCount());
+                playback[e].Restart(now);
+                wakeUps.push_back({e, playback[e].GetLastFrameTime()});
+            }
+            else
+            {
+                wakeUps.push_back({e, now});
+            }
+            flags[e] |= Jumping;
+            c.type = EventCommandType::Spring;
+        }
+        break;
+    default:
+        break;
+    }
+    return c;
+}
+
+void EventStore::HashState(StateHash& h) const
+{
+    for (int e = 0; e < Size(); ++e)
+    {
+        h.Add(positions[e].x).Add(positions[e].y).Add(flags[e]);
+        h.Add(playback[e].GetCurrentFrame()).Add(lastTrigger[e].time_since_epoch().count());
+    }
+}
+
+EventStore::Iter EventStore::TypeEnd(Iter first, Iter last, EventType t) const
+{
+    return std::partition_point(first, last, [&](int e)
+    {
+        return types[e] <= t;
+    });
+}
+
+void EventStore::UpdateAnimations(Iter first, Iter last, const time_point& now)
+{
+    for (; first != last; ++first)
+    {
+        int e = *first;
+        if ((flags[e] & (Active | Animated)) == (Active | Animated))
+        {
+            playback[e].Update(now);
+        }
+    }
+}
+
+void EventStore::UpdateSprings(Iter first, Iter last, const time_point& now)
+{
+    for (; first != last; ++first)
+    {
+        int e = *first;
+        if (!(flags[e] & Animated))
+        {
+            flags[e] &= ~Jumping;
+            continue;
+        }
+        const int frame = playback[e].GetCurrentFrame();
+        playback[e].Update(now);
+        if (playback[e].IsFinished())
+        {
+            const Animation& a = animations[animationIds[e]];
+            playback[e] = AnimationPlayback(AnimationStrategy::OnlyFirtsFrame, a.GetFps(), a.FrameCount());
+            flags[e] &= ~Jumping;
+        }
+        else if ((flags[e] & Jumping) && playback[e].GetCurrentFrame() != frame)
+        {
+            // a late frame moves the end of the jump, the wake-up asked
+            // for so far would come too early
+            wakeUps.push_back({e, playback[e].GetLastFrameTime()});
+        }
+    }
+}
+
+void EventStore::CaptureSprites(RenderSnapshot& snapshot, Iter first, Iter last, uint8_t depth) const
+{
+    for (; first != last; ++first)
+    {
+        int e = *first;
+        if ((flags[e] & (Active | Animated)) != (Active | Animated))
+        {
+            continue;
+        }
+        const Surface& s = animations[animationIds[e]].GetFrame(playback[e].GetCurrentFrame());
+        const Point2D& p = positions[e];
+        snapshot.AddSprite(depth, s, NormalizeToDisplay(s, {p.x, p.y, TileCoordinates::tileWidth,
+                                                            TileCoordinates::tileHeight}));
+    }
+}
+
+void EventStore::CaptureMessages(RenderSnapshot& snapshot, Iter first, Iter last, uint8_t depth) const
+{
+    for (; first != last; ++first)
+    {
+        int e = *first;
+        if (messageIds[e] == none)
+        {
+            continue;
+        }
+        snapshot.AddText(depth + 1, messages[messageIds[e]], positions[e]);
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef EVENTSTORE_H
+#define EVENTSTORE_H
+
+#include "Event.h"
+#include "gfx/Animation.h"
+#include "game/RenderSnapshot.h"
+#include "utils/Arena.h"
+#include "utils/MemoryStats.h"
+#include "utils/StateHash.h"
+#include "utils/Time.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+enum class EventType : uint8_t
+{
+    Unknown,    // only shows a debug message
+    Standard,   // decoration, optionally animated
+    Bonus,      // pickup, disappears when collected
+    Spring,
+    Count
+};
+
+// All events of a level kept as structure of arrays. After SortByType()
+// the events of one type occupy a contiguous range, and every type has its
+// own update/render system walking that range, so there are no per-event
+// heap objects and no virtual calls. Animation frames and debug messages
+// (each distinct text rasterized once) live in shared tables, each event
+// keeps only its playback state.
+class EventStore
+{
+public:
+    enum Flags : uint8_t
+    {
+        Active      = 1,    // drawn and collidable
+        Animated    = 2,
+        Jumping     = 4     // springs only
+    };
+    static constexpr int none = -1;
+
+    // the per event arrays are allocated in arena, on the heap without one
+    explicit EventStore(Arena* arena = nullptr);
+    // room for count events, so adding them does not grow the arrays
+    void Reserve(int count);
+    int Add(EventType type, int jj2_id, const Point2D& position);
+    // returns an id to be used with SetAnimation
+    int AddAnimation(const Animation& a);
+    void SetAnimation(int e, int animation_id);
+    void SetMessage(int e, const std::string& msg);
+    // groups the events by type, indices returned by Add are not valid afterwards
+    void SortByType();
+
+    int Size() const { return static_cast<int>(types.size()); }
+    const Point2D& GetPosition(int e) const { return positions[e]; }
+    EventType GetType(int e) const { return types[e]; }
+    int GetJJ2Id(int e) const { return jj2Ids[e]; }
+    bool IsActive(int e) const { return flags[e] & Active; }
+
+    // systems, events are given as ascending indices, the debug messages
+    // are drawn at depth + 1
+    void Update(const time_point& now, const std::vector<int>& events);
+    void Capture(RenderSnapshot& snapshot, const std::vector<int>& events, uint8_t depth) const;
+    EventCommand CollisionWithHero(int e, const time_point& now);
+    // events that have to be updated at a given time even when no activity
+    // area covers them (a spring finishing its jump); filled by the systems,
+    // the caller hands them to its scheduler and clears them
+    struct WakeUp
+    {
+        int         event;
+        time_point  time;
+    };
+    std::vector<WakeUp>& GetWakeUps() { return wakeUps; }
+    // positions, flags, animation frames and spring triggers
+    void HashState(StateHash& h) const;
+private:
+    ArenaVector<Point2D>            positions;
+    ArenaVector<EventType>          types;
+    ArenaVector<uint8_t>            flags;
+    ArenaVector<uint16_t>           jj2Ids;
+    ArenaVector<int32_t>            animationIds;
+    ArenaVector<AnimationPlayback>  playback;
+    ArenaVector<int32_t>            messageIds;
+    ArenaVector<time_point>         lastTrigger;
+    // shared tables
+    std::vector<Animation>          animations;
+    std::vector<TextRun>            messages;
+    std::map<std::string, int>      messageIndex; // identical messages share a run
+    std::vector<WakeUp>             wakeUps;
+    // the arrays, charged once sorted; frames and messages are surfaces
+    MemoryCharge                    memory;
+
+    typedef std::vector<int>::const_iterator Iter;
+    // splits the sorted indices into per type ranges
+    Iter TypeEnd(Iter first, Iter last, EventType t) const;
+
+    void UpdateAnimations(Iter first, Iter last, const time_point& now);
+    void UpdateSprings(Iter first, Iter last, const time_point& now);
+    void CaptureSprites(RenderSnapshot& snapshot, Iter first, Iter last, uint8_t depth) const;
+    void CaptureMessages(RenderSnapshot& snapshot, Iter first, Iter last, uint8_t depth) const;
+};
+
+#endif // EVENTSTORE_H
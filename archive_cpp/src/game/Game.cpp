@@ -3,31 +3,11 @@
 #include "gfx/GraphicsEngine.h"
 #include "data/ResourceFactory.h"
 #include "CollisionEngine.h"
+#include "utils/MemoryStats.h"
 #include "utils/Utils.h"
 
 #include <assert.h>
 
-struct TerrainFunctor
-{
-    TerrainFunctor(const Level& l)
-        : lev(l)
-    { }
-    TerrainFunctor(const TerrainFunctor& fn)
-        : lev(fn.lev)
-    { }
-    bool operator()(int x, int y) const
-    {
-        Tile* t = lev.TileAt(x, y);
-        if (t == nullptr)
-        {
-            return false;
-        }
-        return t->IsCollidableAt(x - t->x, y - t->y);
-    }
-private:
-    const Level& lev;
-};
-
 Game::Game(const std::string& firstLev)
     : camera(GraphicsEngine::getInstance().Width(), GraphicsEngine::getInstance().Height())
     , currentLevel(ResourceFactory::GetInstance().LoadLevel(firstLev))
@@ -35,58 +15,121 @@ Game::Game(const std::string& firstLev)
     hero.reset(new Hero(ResourceFactory::GetInstance().BuildHero()));
     hero->SetPosition(currentLevel->GetHeroStartPosition());
     transformer.SetUniverseSize(currentLevel->GetUniverseSize().w, currentLevel->GetUniverseSize().h);
-    transformer.SetScreenSize(GraphicsEngine::getInstance().Screen().getWidth(),
-                              GraphicsEngine::getInstance().Screen().getHeight());
+    transformer.SetScreenSize(GraphicsEngine::getInstance().Width(),
+                              GraphicsEngine::getInstance().Height());
     transformer.SetCameraPositionInUniverse(currentLevel->GetHeroStartPosition(), PositionAnchor::Centered);
+    renderTransformer = transformer;
+    PublishSnapshot();
 }
 
 void Game::UpdateState(long)
 {
     // calculate hero position
-    Point2D heroPos{ hero->GetPosition().x, hero->GetPosition().y };
-    Vector2D heroVec = hero->GetMovementVector();
-
-    CollisionEngine::NeighborhoodStats stat, stat_tmp;
-    for (const auto& p : hero->GetConvexHull())
-    {
-        // check collisions
-        CollisionEngine::AdjustMovementVector(TerrainFunctor(*currentLevel), p, heroVec);
-        CollisionEngine::GetStatistics(TerrainFunctor(*currentLevel), p, stat_tmp);
-        // update stats
-        stat.onTheGround |= stat_tmp.onTheGround;
-        stat.inFrontOfLeftWall |= stat_tmp.inFrontOfLeftWall;
-        stat.inFrontOfRightWall |= stat_tmp.inFrontOfRightWall;
-        stat.touchCeiling |= stat_tmp.touchCeiling;
-    }
-    hero->SetMovementVector({0, 0}, stat);
-    hero->SetPosition({heroPos.x + heroVec.dx, heroPos.y + heroVec.dy});
+    Rectangle2D heroBox = hero->GetBoundingBox();
+    auto sweep = CollisionEngine::SweepBox(currentLevel->GetCollisionBitmap(),
+                                           heroBox, hero->GetMovementVector());
+    hero->SetMovementVector({0, 0}, sweep.contacts);
+    hero->SetPosition({heroBox.x + sweep.moved.dx, heroBox.y + sweep.moved.dy});
     // check collisions against events
-    for (const auto& p : hero->GetConvexHull())
+    Rectangle2D heroArea = hero->GetBoundingBox();
+    auto now = GameClock::now();
+    currentLevel->ForEachEventIn(heroArea, [&](int ev)
     {
-        auto* ev = currentLevel->EventAt(p.x, p.y);
-        if (ev != nullptr)
-        {
-            auto cmd = ev->CollisionWihtHero(p);
+        auto cmd = currentLevel->CollisionWithHero(ev, now);
 
-            if (cmd.type == EventCommandType::Spring)
-            {
-                hero->BigJump();
-            }
+        if (cmd.type == EventCommandType::Spring)
+        {
+            hero->BigJump();
         }
-    }
+    });
     // update hero logic
-    hero->UpdateState(GameClock::now());
+    hero->UpdateState(now);
+    // update events around the camera and the hero, the rest of the level sleeps
+    const int margin = activityMargin * TileCoordinates::tileWidth;
+    Point2D view = transformer.GetCameraPositionInUniverse(PositionAnchor::LeftTop);
+    activeAreas.clear();
+    activeAreas.push_back({view.x - margin, view.y - margin,
+                           GraphicsEngine::getInstance().Width() + 2 * margin,
+                           GraphicsEngine::getInstance().Height() + 2 * margin});
+    activeAreas.push_back({heroArea.x - margin, heroArea.y - margin,
+                           heroArea.w + 2 * margin, heroArea.h + 2 * margin});
+    currentLevel->Update(now, activeAreas);
+    PublishSnapshot();
+}
+
+void Game::PublishSnapshot()
+{
+    RenderSnapshot& snapshot = snapshots.Back();
+    snapshot.Clear();
+    snapshot.camera = transformer.GetCameraPositionInUniverse(PositionAnchor::LeftTop);
+    currentLevel->CaptureEvents(snapshot, {snapshot.camera.x, snapshot.camera.y,
+                                           GraphicsEngine::getInstance().Width(),
+                                           GraphicsEngine::getInstance().Height()});
+    hero->Capture(snapshot, currentLevel->GetHeroDepth());
+    snapshots.Publish();
 }
 
 void Game::Render(long /*currentTime*/)
 {
+    // the newest simulation step, the simulation may be on the next one already
+    const RenderSnapshot& snapshot = snapshots.Acquire();
+    renderTransformer.SetCameraPositionInUniverse(snapshot.camera, PositionAnchor::LeftTop);
+    IRenderBackend& backend = GraphicsEngine::getInstance().Backend();
+    const int width = backend.Width();
+    const int height = backend.Height();
+    renderQueue.Begin({0, 0, width, height});
     // render level + level background background
-    currentLevel->Render(GraphicsEngine::getInstance().Screen(), transformer);
-    // render hero
-    Point2D heroPos{ hero->GetPosition().x, hero->GetPosition().y };
-    heroPos = transformer.FromUniverseToScreen(heroPos);
-    hero->Render(GraphicsEngine::getInstance().Screen(), {heroPos.x, heroPos.y, 32, 32});
+    if (GraphicsEngine::getInstance().IsIndexedMode())
+    {
+        if (!indexedFrame || indexedFrame->getWidth() != width || indexedFrame->getHeight() != height)
+        {
+            MemoryScope scope(MemoryCategory::Render);
+            indexedFrame.reset(new IndexedSurface(width, height));
+        }
+        indexedFrame->Fill(IndexedSurface::transparent);
+        currentLevel->RenderLayers(*indexedFrame, renderTransformer);
+        // palette effects only need to change the palette
+        Surface* target = backend.GetTargetSurface();
+        if (target == nullptr)
+        {
+            if (!resolvedFrame || resolvedFrame->getWidth() != width || resolvedFrame->getHeight() != height)
+            {
+                resolvedFrame.reset(new Surface(width, height, false));
+            }
+            target = resolvedFrame.get();
+        }
+        indexedFrame->Resolve(NativePalette(GraphicsEngine::getInstance().GetGlobalPalette(), *target), *target);
+        if (target == resolvedFrame.get())
+        {
+            backend.Draw(*target, 0, 0);
+        }
+    }
+    else
+    {
+        currentLevel->RenderLayers(renderQueue, renderTransformer);
+    }
+    // events and hero
+    snapshot.Submit(renderQueue, renderTransformer);
     // TODO: render level foreground
+    // draw calls of the previous frame
+    int drawCalls = renderQueue.GetStats().drawCalls;
+    if (drawCalls != shownDrawCalls)
+    {
+        shownDrawCalls = drawCalls;
+        drawCallsText.Set("Draw calls = " + std::to_string(drawCalls), {255, 255, 255, 160});
+    }
+    renderQueue.PushText(overlayDepth, drawCallsText, 300, 45);
+    renderQueue.Submit(backend);
+}
+
+uint64_t Game::GetStateHash() const
+{
+    StateHash h;
+    hero->HashState(h);
+    Point2D view = transformer.GetCameraPositionInUniverse(PositionAnchor::LeftTop);
+    h.Add(view.x).Add(view.y);
+    currentLevel->HashState(h);
+    return h.Value();
 }
 
 void Game::Up()
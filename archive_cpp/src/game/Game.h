@@ -6,6 +6,9 @@
 #include "game/Camera.h"
 #include "game/Hero.h"
 #include "game/WorldTransformations.h"
+#include "gfx/RenderQueue.h"
+#include "gfx/IndexedSurface.h"
+#include "utils/TripleBuffer.h"
 
 #include <memory>
 
@@ -25,11 +28,30 @@ public:
     virtual void HeroCrunch() override;
     virtual void HeroLeft() override;
     virtual void HeroRight() override;
+    // hero, camera and events, equal after equal input (see InputLog)
+    uint64_t GetStateHash() const;
 private:
     Camera                  camera;    
     LevelPtr                currentLevel;
     std::unique_ptr<Hero>   hero;
     WorldTransformations    transformer;
+    // simulation steps for the render thread, and its own transformations
+    TripleBuffer<RenderSnapshot>    snapshots;
+    WorldTransformations    renderTransformer;
+    // events further than this (in tiles) from the view and the hero sleep
+    static constexpr int    activityMargin = 10;
+    std::vector<Rectangle2D> activeAreas;
+    RenderQueue             renderQueue;
+    // framebuffer of the indexed rendering mode, and its colors when the
+    // render backend has no surface to resolve it to
+    std::unique_ptr<IndexedSurface> indexedFrame;
+    std::unique_ptr<Surface>        resolvedFrame;
+    // on top of everything
+    static constexpr uint8_t overlayDepth = 255;
+    int                     shownDrawCalls = -1;
+    TextRun                 drawCallsText;
+
+    void PublishSnapshot();
 };
 
 #endif // GAME_H
@@ -51,36 +51,29 @@ void Hero::UpdateState(GameClock::time_point now)
     _animations.Update();
 }
 
-void Hero::Render(Surface& screen, const Rectangle2D& positionOnSurface)
+void Hero::Capture(RenderSnapshot& snapshot, uint8_t depth) const
 {
-    int x = positionOnSurface.x;
-    int y = positionOnSurface.y;
-    if (x >= 0 && y >= 0 && x < screen.getWidth() && y < screen.getHeight())
+    const Rectangle2D position = GetPosition();
+    const auto& a = _animations.GetCurrent();
+    // calculate position of current frame
+    int dx = _actualPosition[ConvexHullPoint::RightTop].x - _actualPosition[ConvexHullPoint::LeftTop].x;
+    int dy = _actualPosition[ConvexHullPoint::LeftDown].y - _actualPosition[ConvexHullPoint::LeftTop].y;
+    int ground_y = position.y + dy;
+    int center_x = position.x + dx / 2;
+    int anim_x = center_x - a.GetCurrentFrame().getWidth() / 2;
+    int anim_y = ground_y - a.GetCurrentFrame().getHeight();
+
+    if (_orientation == HeroOrientation::Left)
+    {
+        snapshot.AddSprite(depth, a.GetCurrentFrame(), {anim_x, anim_y}, true);
+    }
+    else
     {
-        const auto& a = _animations.GetCurrent();
-        // calculate position of current frame
-        int dx = _actualPosition[ConvexHullPoint::RightTop].x - _actualPosition[ConvexHullPoint::LeftTop].x;
-        int dy = _actualPosition[ConvexHullPoint::LeftDown].y - _actualPosition[ConvexHullPoint::LeftTop].y;
-        int ground_y = positionOnSurface.y + dy;
-        int center_x = positionOnSurface.x + dx / 2;
-        int anim_x = center_x - a.GetCurrentFrame().getWidth() / 2;
-        int anim_y = ground_y - a.GetCurrentFrame().getHeight();
-
-        if (_orientation == HeroOrientation::Left)
-        {
-            screen.Draw(a.GetCurrentFrameMirrored(), anim_x, anim_y);
-        }
-        else
-        {
-            screen.Draw(a.GetCurrentFrame(), anim_x, anim_y);
-        }
-        for (const auto& v : _convexHull)
-        {
-            int x = positionOnSurface.x + v.dx;
-            int y = positionOnSurface.y + v.dy;
-            if (x >= 0 && y >= 0 && x < screen.getWidth() && y < screen.getHeight())
-                screen.PutPixel(x, y, {255, 255, 255});
-        }
+        snapshot.AddSprite(depth, a.GetCurrentFrame(), {anim_x, anim_y});
+    }
+    for (const auto& v : _convexHull)
+    {
+        snapshot.AddPixel(depth, {position.x + v.dx, position.y + v.dy}, {255, 255, 255});
     }
 }
 
@@ -90,15 +83,22 @@ Rectangle2D Hero::GetPosition() const
             _actualPosition[ConvexHullPoint::LeftTop].y, 16, 32};
 }
 
+Rectangle2D Hero::GetBoundingBox() const
+{
+    const auto& lt = _actualPosition[ConvexHullPoint::LeftTop];
+    const auto& rd = _actualPosition[ConvexHullPoint::RightDown];
+    return {lt.x, lt.y, rd.x - lt.x + 1, rd.y - lt.y + 1};
+}
+
 Vector2D Hero::GetMovementVector() const
 {
     return _movementVector;
 }
 
-void Hero::SetMovementVector(const Vector2D& v, const CollisionEngine::NeighborhoodStats& stats)
+void Hero::SetMovementVector(const Vector2D& v, const CollisionEngine::Contacts& contacts)
 {
     _movementVector = v;
-    _collisionStats = stats;
+    _collisionStats = contacts;
 }
 
 void Hero::BigJump()
@@ -137,3 +137,14 @@ void Hero::Ground()
     _lastEvent = HeroEvent::InputDown;
     //_physics.Idle();
 }
+
+void Hero::HashState(StateHash& h) const
+{
+    for (const auto& p : _actualPosition)
+    {
+        h.Add(p.x).Add(p.y);
+    }
+    h.Add(_movementVector.dx).Add(_movementVector.dy).Add(_orientation).Add(_lastEvent);
+    h.Add(_collisionStats.onTheGround).Add(_collisionStats.inFrontOfLeftWall)
+     .Add(_collisionStats.inFrontOfRightWall).Add(_collisionStats.touchCeiling);
+}
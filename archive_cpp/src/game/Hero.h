@@ -3,7 +3,9 @@
 
 #include "utils/Utils.h"
 #include "gfx/Animation.h"
+#include "game/RenderSnapshot.h"
 #include "utils/ContrAnim.h"
+#include "utils/StateHash.h"
 #include "CollisionEngine.h"
 #include "physics/HeroPhysics.h"
 
@@ -46,18 +48,23 @@ public:
     // implement Entity interface
     void SetPosition(const Point2D& p);
     void UpdateState(GameClock::time_point now);
-    void Render(Surface& screen, const Rectangle2D& positionOnSurface);
+    // the current frame and the hull, at the position in the universe
+    void Capture(RenderSnapshot& snapshot, uint8_t depth) const;
     Rectangle2D GetPosition() const;
+    // box used for collisions with the terrain
+    Rectangle2D GetBoundingBox() const;
     const std::vector<Point2D>& GetConvexHull() const { return _actualPosition; }
     //
     Vector2D GetMovementVector() const;
-    void SetMovementVector(const Vector2D& v, const CollisionEngine::NeighborhoodStats& stats);
+    void SetMovementVector(const Vector2D& v, const CollisionEngine::Contacts& contacts);
     //
     void BigJump();
     void Jump();
     void MoveLeft();
     void MoveRight();
     void Ground();
+    // position, movement, orientation and contacts
+    void HashState(StateHash& h) const;
 private:
     std::vector<Point2D>        _actualPosition;
     const std::vector<Vector2D>  _convexHull;
@@ -68,7 +75,7 @@ private:
     HeroEvent                   _lastEvent = HeroEvent::NoInput;
     const int                   _normalWalkSpeed;
     //PhysicalBodyMechanics       _physics;
-    CollisionEngine::NeighborhoodStats  _collisionStats;
+    CollisionEngine::Contacts   _collisionStats;
     physics::HeroPhysics        _physics;
 };
 
@@ -1,6 +1,9 @@
 #ifndef ISTORYBOARD_H
 #define ISTORYBOARD_H
 
+// UpdateState() and the input methods are called on the simulation thread,
+// Render() on the render thread at the same time; what Render() reads of the
+// simulation has to be handed over (see Game and RenderSnapshot).
 struct IStoryBoard
 {
     virtual ~IStoryBoard();
@@ -0,0 +1,174 @@
+#include "InputLog.h"
+#include "utils/BinaryReader.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+const char magic[4] = {'O', 'J', 'I', 'L'};
+constexpr uint8_t version = 1;
+
+template <typename T>
+void Write(std::ofstream& s, const T& value)
+{
+    s.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// runs are mostly short, 7 bits per byte
+void WriteVarint(std::ofstream& s, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        Write(s, static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    Write(s, static_cast<uint8_t>(value));
+}
+
+uint32_t ReadVarint(std::ifstream& s)
+{
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t b = 0;
+        BinaryReader::read(s, b);
+        value |= static_cast<uint32_t>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+        {
+            break;
+        }
+    }
+    return value;
+}
+
+}
+
+void ApplyInput(IStoryBoard& board, uint8_t keys)
+{
+    if (keys & CameraUp)
+    {
+        board.Up();
+    }
+    if (keys & CameraDown)
+    {
+        board.Down();
+    }
+    if (keys & CameraRight)
+    {
+        board.Right();
+    }
+    if (keys & CameraLeft)
+    {
+        board.Left();
+    }
+    if (keys & HeroDown)
+    {
+        board.HeroCrunch();
+    }
+    if (keys & HeroUp)
+    {
+        board.HeroJump();
+    }
+    if (keys & HeroLeft)
+    {
+        board.HeroLeft();
+    }
+    if (keys & HeroRight)
+    {
+        board.HeroRight();
+    }
+}
+
+void InputLog::Append(uint8_t keys)
+{
+    if (!runs.empty() && runs.back().keys == keys && runs.back().steps < UINT32_MAX)
+    {
+        ++runs.back().steps;
+    }
+    else
+    {
+        runs.push_back({keys, 1});
+    }
+}
+
+uint64_t InputLog::StepCount() const
+{
+    uint64_t steps = 0;
+    for (const auto& r : runs)
+    {
+        steps += r.steps;
+    }
+    return steps;
+}
+
+void InputLog::Save(const std::string& filename) const
+{
+    std::ofstream file(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Input log " + filename + " cannot be written.");
+    }
+    file.write(magic, sizeof(magic));
+    Write(file, version);
+    Write(file, stepMs);
+    Write(file, width);
+    Write(file, height);
+    Write(file, seed);
+    Write(file, startTime);
+    Write(file, static_cast<uint16_t>(level.size()));
+    file.write(level.data(), level.size());
+    Write(file, static_cast<uint32_t>(runs.size()));
+    for (const auto& r : runs)
+    {
+        Write(file, r.keys);
+        WriteVarint(file, r.steps);
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Input log " + filename + " cannot be written.");
+    }
+}
+
+InputLog InputLog::Load(const std::string& filename)
+{
+    using BinaryReader::read;
+    std::ifstream file(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Input log " + filename + " not found.");
+    }
+    char m[sizeof(magic)];
+    uint8_t v = 0;
+    read(file, m);
+    read(file, v);
+    if (!file || std::memcmp(m, magic, sizeof(magic)) != 0 || v != version)
+    {
+        throw std::runtime_error(filename + " is not an input log of this version.");
+    }
+    InputLog log;
+    uint16_t levelLength = 0;
+    uint32_t runCount = 0;
+    read(file, log.stepMs);
+    read(file, log.width);
+    read(file, log.height);
+    read(file, log.seed);
+    read(file, log.startTime);
+    read(file, levelLength);
+    log.level.resize(levelLength);
+    file.read(&log.level[0], levelLength);
+    read(file, runCount);
+    for (uint32_t i = 0; i < runCount && file; ++i)
+    {
+        Run r;
+        read(file, r.keys);
+        r.steps = ReadVarint(file);
+        log.runs.push_back(r);
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Input log " + filename + " is truncated.");
+    }
+    return log;
+}
@@ -0,0 +1,57 @@
+#ifndef INPUTLOG_H
+#define INPUTLOG_H
+
+#include "game/IStoryBoard.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// keys held during one simulation step
+enum InputKeys : uint8_t
+{
+    CameraUp    = 1,
+    CameraDown  = 2,
+    CameraLeft  = 4,
+    CameraRight = 8,
+    HeroUp      = 16,
+    HeroDown    = 32,
+    HeroLeft    = 64,
+    HeroRight   = 128
+};
+
+// calls the input methods of the story board for the keys held
+void ApplyInput(IStoryBoard& board, uint8_t keys);
+
+// Input of a play session, the keys of every simulation step stored as runs
+// of equal steps. With the level, the seed, the step length, the clock at
+// the first step and the internal resolution (the camera and the active
+// areas depend on it) a replay reaches the same state as the session.
+class InputLog
+{
+public:
+    struct Run
+    {
+        uint8_t     keys;
+        uint32_t    steps;
+    };
+
+    std::string level;
+    uint32_t    seed = 0;
+    uint16_t    stepMs = 30;
+    uint16_t    width = 0;
+    uint16_t    height = 0;
+    int64_t     startTime = 0;
+
+    void Append(uint8_t keys);
+    uint64_t StepCount() const;
+    const std::vector<Run>& GetRuns() const { return runs; }
+
+    // throw std::runtime_error when the file cannot be written or read
+    void Save(const std::string& filename) const;
+    static InputLog Load(const std::string& filename);
+private:
+    std::vector<Run>    runs;
+};
+
+#endif // INPUTLOG_H
@@ -1,106 +1,68 @@
 #include "Layer.h"
 
-#include <type_traits>
+#include <algorithm>
+#include <assert.h>
 
-Layer::Layer(int w, int h, bool repeat_horiz, bool repeat_vert, bool no_view_beyond_edge,
-             bool warp_eff, unsigned tile_no)
-    : width(w)
-    , height(h)
+Layer::Layer(int width_in_tiles, int height_in_tiles, bool repeat_horiz, bool repeat_vert,
+             bool no_view_beyond_edge, bool warp_eff, TileSetPtr tile_set, Arena* arena)
+    : tileSet(std::move(tile_set))
+    , tileIds(width_in_tiles * height_in_tiles, 0, ArenaAllocator<TileId>(arena))
+    , tileFlags(width_in_tiles * height_in_tiles, 0, ArenaAllocator<uint8_t>(arena))
+    , memory(MemoryCategory::LevelGrid, HeapBytes(tileIds) + HeapBytes(tileFlags))
+    , widthInTiles(width_in_tiles)
+    , heightInTiles(height_in_tiles)
     , repeatHoriz(repeat_horiz)
     , repeatVert(repeat_vert)
     , noViewBeyondEdge(no_view_beyond_edge)
     , warpEffect(warp_eff)
-{
-    Rectangle2D world { 0, 0, 0, 0 };
-    world.w = width;
-    world.h = height;
-    // TODO: find out better approximation
-    tiles.reset(new tile_tree{world, 2000, 2000});
-    tiles_v.reserve(tile_no);
-}
+{ }
 
-void Layer::Add(TilePtr t)
+void Layer::SetTile(int tx, int ty, TileId id, bool flipped)
 {
-    tiles->Insert(t);
-    tiles_v.push_back(t);
+    assert(tx >= 0 && tx < widthInTiles && ty >= 0 && ty < heightInTiles);
+    tileIds[ty * widthInTiles + tx] = id;
+    tileFlags[ty * widthInTiles + tx] = flipped ? TileFlipped : 0;
 }
 
-const std::vector<TilePtr>& Layer::GetTiles() const
+bool Layer::IsCollidableAt(int x, int y) const
 {
-    return tiles_v;
+    if (x < 0 || y < 0 || x >= GetWidth() || y >= GetHeight())
+    {
+        return false;
+    }
+    int tx = x / TileCoordinates::tileWidth;
+    int ty = y / TileCoordinates::tileHeight;
+    TileId id = GetTileId(tx, ty);
+    if (id == 0)
+    {
+        return false;
+    }
+    return tileSet->IsCollidableAt(id, IsFlipped(tx, ty),
+                                   x - tx * TileCoordinates::tileWidth,
+                                   y - ty * TileCoordinates::tileHeight);
 }
 
-void Layer::Render(Surface &screen, const WorldTransformations& tr)
+void Layer::Render(RenderQueue& queue, const WorldTransformations& tr, uint8_t depth) const
 {
-    if (width == 0 || height == 0)
-    {
-        return;
-    }
-    int layer_x = tr.GetCameraPositionInUniverse(PositionAnchor::LeftTop).x;
-    int layer_y = tr.GetCameraPositionInUniverse(PositionAnchor::LeftTop).y;
-    std::vector<Point2D> points{
-        {layer_x, layer_y},
-        {layer_x, layer_y + screen.getHeight()},
-        {layer_x + screen.getWidth(), layer_y + screen.getHeight()},
-        {layer_x + screen.getWidth(), layer_y}
-    };
-    typename std::remove_reference<decltype(tiles->GetEntitles(points[0]))>::type* entitles_set[4];
-    int i = 0;
-    for (const auto& p: points)
+    ForEachVisibleTile(queue.GetView(), tr, [&](TileId id, bool flipped, int x, int y)
     {
-        entitles_set[i] = &tiles->GetEntitles(p);
-        bool found_duplicate = false;
-        for (int k = 0; k < i; ++k)
-        {
-            if (entitles_set[k] == entitles_set[i])
-            {
-                found_duplicate = true;
-                break;
-            }
-        }
-        if (found_duplicate)
+        const Surface* s = tileSet->GetImage(id, flipped);
+        if (s != nullptr)
         {
-            ++i;
-            continue;
+            queue.PushSprite(depth, *s, x, y);
         }
-        for (auto& t_ptr: *entitles_set[i])
-        {
-            Tile& t = *t_ptr;
-            auto pp = tr.FromUniverseToScreen({t.x, t.y});
-            int x1 = pp.x;
-            int y1 = pp.y;
-            int x2 = x1 + 32;
-            int y2 = y1 + 32;
-
-            if (x2 < 0 || y2 < 0)
-                continue;
-
-            if (x1 > screen.getWidth() || y1 > screen.getHeight())
-                continue;
-
-            int repeatH = 0;
-            int repeatV = 0;
-            if (repeatHoriz)
-            {
-                repeatH = screen.getWidth() / width;
-            }
-            if (repeatVert)
-            {
-                repeatV = screen.getHeight() / height;
-            }
+    });
+}
 
-            for (int h = 0; h <= repeatH; ++h)
-            {
-                for (int v = 0; v <= repeatV; ++v)
-                {
-                    int X = x1 + h * width;
-                    int Y = y1 + v * height;
-                    if (X < -32 || Y < -32 || X > screen.getWidth() || Y > screen.getHeight())
-                        continue;
-                    t.Render(screen, {X, Y, 32, 32});
-                }
-            }
+void Layer::Render(IndexedSurface& target, const WorldTransformations& tr) const
+{
+    ForEachVisibleTile({0, 0, target.getWidth(), target.getHeight()}, tr,
+                       [&](TileId id, bool flipped, int x, int y)
+    {
+        const IndexedSurface* s = tileSet->GetIndexedImage(id, flipped);
+        if (s != nullptr)
+        {
+            target.Draw(*s, x, y);
         }
-        ++i;
-    }
+    });
 }
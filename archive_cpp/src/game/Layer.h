@@ -1,42 +1,113 @@
 #ifndef LAYER_H
 #define LAYER_H
 
-#include "Tile.h"
+#include "TileSet.h"
+#include "gfx/RenderQueue.h"
+#include "gfx/IndexedSurface.h"
 #include "game/WorldTransformations.h"
-#include "utils/BSPTree2D.h"
+#include "utils/Arena.h"
+#include "utils/MemoryStats.h"
 
-#include <memory>
-
-typedef std::shared_ptr<Tile> TilePtr;
-
-template<typename T>
-struct pos_getter {
-    Point2D operator()(const T& t) const {
-        return {t->GetPosition().x, t->GetPosition().y};
-    }
-};
-
-typedef BSPTree2D<TilePtr, pos_getter<TilePtr>> tile_tree;
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
+// A layer is a dense grid of tile ids (0 = no tile) plus per-cell flags.
+// Images, collision masks and animations come from the shared TileSet.
 class Layer
 {
 public:
-    Layer(int w, int h, bool repeat_horiz, bool repeat_vert, bool no_view_beyond_edge,
-          bool warp_eff, unsigned tile_no);
-    void Add(TilePtr t);
-    const std::vector<TilePtr>& GetTiles() const;
-    int GetHeight() const { return height; }
-    int GetWidth() const { return width; }
-    void Render(Surface &screen, const WorldTransformations& tr);
+    enum TileFlags : uint8_t
+    {
+        TileFlipped = 1
+    };
+
+    // the grid is allocated in arena, on the heap without one
+    Layer(int width_in_tiles, int height_in_tiles, bool repeat_horiz, bool repeat_vert,
+          bool no_view_beyond_edge, bool warp_eff, TileSetPtr tile_set, Arena* arena = nullptr);
+    void SetTile(int tx, int ty, TileId id, bool flipped);
+    TileId GetTileId(int tx, int ty) const { return tileIds[ty * widthInTiles + tx]; }
+    bool IsFlipped(int tx, int ty) const { return tileFlags[ty * widthInTiles + tx] & TileFlipped; }
+    int GetHeight() const { return heightInTiles * TileCoordinates::tileHeight; }
+    int GetWidth() const { return widthInTiles * TileCoordinates::tileWidth; }
+    int GetWidthInTiles() const { return widthInTiles; }
+    int GetHeightInTiles() const { return heightInTiles; }
+    const TileSet& GetTileSet() const { return *tileSet; }
+    // x, y in pixels
+    bool IsCollidableAt(int x, int y) const;
+    // pushes the tiles overlapping the view of the queue
+    void Render(RenderQueue& queue, const WorldTransformations& tr, uint8_t depth) const;
+    // composites the 8 bit tile images into target (which is the view)
+    void Render(IndexedSurface& target, const WorldTransformations& tr) const;
 private:
-    std::unique_ptr<tile_tree>  tiles;
-    std::vector<TilePtr>        tiles_v;
-    int width = 0;
-    int height = 0;
+    TileSetPtr              tileSet;
+    ArenaVector<TileId>     tileIds;
+    ArenaVector<uint8_t>    tileFlags;
+    MemoryCharge            memory;
+    int widthInTiles = 0;
+    int heightInTiles = 0;
     bool repeatHoriz = false;
     bool repeatVert = false;
     bool noViewBeyondEdge = false;
     bool warpEffect = false;    
+
+    // calls fn(id, flipped, x, y) for every non empty tile overlapping view
+    // (screen coordinates), repeated layers wrap around
+    template <class Fn>
+    void ForEachVisibleTile(const Rectangle2D& view, const WorldTransformations& tr, Fn&& fn) const;
+
+    // floor division, also for negative numbers
+    static int FloorDiv(int a, int b)
+    {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+
+    static int Wrap(int a, int b)
+    {
+        int m = a % b;
+        return (m < 0) ? m + b : m;
+    }
 };
 
+template <class Fn>
+void Layer::ForEachVisibleTile(const Rectangle2D& view, const WorldTransformations& tr, Fn&& fn) const
+{
+    if (widthInTiles == 0 || heightInTiles == 0)
+    {
+        return;
+    }
+    const int tw = TileCoordinates::tileWidth;
+    const int th = TileCoordinates::tileHeight;
+    Point2D origin = tr.GetCameraPositionInUniverse(PositionAnchor::LeftTop);
+    int tx_begin = FloorDiv(origin.x + view.x, tw);
+    int ty_begin = FloorDiv(origin.y + view.y, th);
+    int tx_end = FloorDiv(origin.x + view.x + view.w - 1, tw);
+    int ty_end = FloorDiv(origin.y + view.y + view.h - 1, th);
+    if (!repeatHoriz)
+    {
+        tx_begin = std::max(tx_begin, 0);
+        tx_end = std::min(tx_end, widthInTiles - 1);
+    }
+    if (!repeatVert)
+    {
+        ty_begin = std::max(ty_begin, 0);
+        ty_end = std::min(ty_end, heightInTiles - 1);
+    }
+
+    for (int ty = ty_begin; ty <= ty_end; ++ty)
+    {
+        const int row = Wrap(ty, heightInTiles) * widthInTiles;
+        const int y = ty * th - origin.y;
+        for (int tx = tx_begin; tx <= tx_end; ++tx)
+        {
+            const int cell = row + Wrap(tx, widthInTiles);
+            TileId id = tileIds[cell];
+            if (id != 0)
+            {
+                fn(id, (tileFlags[cell] & TileFlipped) != 0, tx * tw - origin.x, y);
+            }
+        }
+    }
+}
+
 #endif // LAYER_H
@@ -2,96 +2,92 @@
 
 #include "gfx/GraphicsEngine.h"
 
-class ObjectLookupMap
-{
-public:
-    ObjectLookupMap(int map_width_in_tiles, int map_height_in_tiles)
-        : mapWidth(map_width_in_tiles)
-        , mapHeight(map_height_in_tiles)
-    {
-        nodes.assign(mapWidth * mapHeight, Node());
-    }
-    void Add(IEvent* ev, const TileCoordinates& c)
-    {
-        getNodeAt(c).event = ev;
-    }
-    void Add(Tile* tl, const TileCoordinates& c)
-    {
-        getNodeAt(c).tile = tl;
-    }
-    IEvent* GetEventAt(const TileCoordinates& c) const
-    {
-        return getNodeAtC(c).event;
-    }
-    Tile* GetTileAt(const TileCoordinates& c) const
-    {
-        return getNodeAtC(c).tile;
-    }
-    bool IsEmpty(const TileCoordinates& c) const
-    {
-        return getNodeAtC(c).isEmpty();
-    }
-private:
-    struct Node
-    {
-        Tile*   tile = nullptr;
-        IEvent*  event = nullptr;
-
-        bool isEmpty() const { return tile == nullptr && event == nullptr; }
-    };
-    Node& getNodeAt(const TileCoordinates& c)
-    {
-        assert(c.x + c.y * mapWidth < (int)nodes.size());
-        return nodes[c.x + c.y * mapWidth];
-    }
-    const Node& getNodeAtC(const TileCoordinates& c) const
-    {
-        return const_cast<ObjectLookupMap*>(this)->getNodeAt(c);
-    }
+#include <algorithm>
 
-    const int mapWidth;
-    const int mapHeight;
-
-    std::vector<Node> nodes;
-};
-
-Level::Level(unsigned worldWidth, unsigned worldHeight, std::vector<Layer> ls,
-             unsigned actionLayer, std::vector<EventPtr> es, const Point2D& heroStartPos)
-    : layers(std::move(ls))
+Level::Level(std::unique_ptr<Arena> arena_, unsigned worldWidth, unsigned worldHeight, TileSetPtr ts,
+             std::vector<Layer> ls, unsigned actionLayer, EventStore es, const Point2D& heroStartPos)
+    : arena(std::move(arena_))
+    , tileSet(std::move(ts))
+    , layers(std::move(ls))
     , events(std::move(es))
     , heroStartPosition(heroStartPos)
     , world_width(worldWidth)
     , world_height(worldHeight)
     , action_layer(actionLayer)
+    , collisionBitmap(layers[action_layer], arena.get())
+    , eventGrid(world_width, world_height, 4 * TileCoordinates::tileWidth, arena.get())
+    , scheduler(events.Size(), arena.get())
 {
-    auto farest_point = FromUnivCoord(world_width, world_height);
-    lookupMap.reset(new ObjectLookupMap{farest_point.x, farest_point.y});
-    // preprocess tiles
-    for (auto& t : layers[action_layer].GetTiles())
-    {
-        lookupMap->Add(t.get(), t->tc);
-    }
-    // preprocess event
-    for (auto& e: events)
+    events.SortByType();
+    for (int i = 0; i < events.Size(); ++i)
     {
-        lookupMap->Add(e.get(), e->GetTileCoord());
+        const Point2D& p = events.GetPosition(i);
+        eventGrid.Insert({p.x, p.y, TileCoordinates::tileWidth, TileCoordinates::tileHeight}, i);
     }
 }
 
 Level::~Level() { }
 
-void Level::Render(Surface &screen, const WorldTransformations& tr)
+void Level::Update(const time_point& now, const std::vector<Rectangle2D>& activeAreas)
 {
-    RenderLayers(screen, layers.size() - 1, 3, tr);
-    RenderLayers(screen, 3, 3, tr);
+    for (const auto& w : events.GetWakeUps())
+    {
+        scheduler.WakeAt(w.event, w.time);
+    }
+    events.GetWakeUps().clear();
+    selectedEvents.clear();
+    scheduler.Tick(now, eventGrid, activeAreas.data(), activeAreas.size(), [&](int e)
+    {
+        selectedEvents.push_back(e);
+    });
+    std::sort(selectedEvents.begin(), selectedEvents.end());
+    events.Update(now, selectedEvents);
+}
+
+void Level::RenderLayers(RenderQueue& queue, const WorldTransformations& tr)
+{
+    tileSet->Update(GameClock::now());
+    RenderLayers(queue, layers.size() - 1, 3, tr);
+    //RenderLayers(queue, 2, 0, tr);
+}
 
-    for (auto& ev: events)
+void Level::RenderLayers(IndexedSurface& target, const WorldTransformations& tr)
+{
+    tileSet->Update(GameClock::now());
+    for (int l = layers.size() - 1; l >= 3; --l)
     {
-        Point2D ev_pos = tr.FromUniverseToScreen({ev->getX(), ev->getY()});
-        ev->Render(screen, {ev_pos.x, ev_pos.y, 32, 32});
+        const auto& layer = layers[l];
+        if (world_height != layer.GetHeight() || world_width != layer.GetWidth())
+        {
+            layer.Render(target, tr.CreateNewWT(layer.GetWidth(), layer.GetHeight()));
+        }
+        else
+        {
+            layer.Render(target, tr);
+        }
     }
+}
 
-    //RenderLayers(screen, 2, 0, tr);
+void Level::CaptureEvents(RenderSnapshot& snapshot, const Rectangle2D& view)
+{
+    // only events within the view get to the snapshot
+    selectedEvents.clear();
+    ForEachEventIn(view, [&](int e)
+    {
+        selectedEvents.push_back(e);
+    });
+    std::sort(selectedEvents.begin(), selectedEvents.end());
+    events.Capture(snapshot, selectedEvents, GetSpriteDepth());
+}
+
+uint8_t Level::GetSpriteDepth() const
+{
+    return GetLayerDepth(action_layer) + 1;
+}
+
+uint8_t Level::GetHeroDepth() const
+{
+    return GetSpriteDepth() + 2;
 }
 
 Point2D Level::GetHeroStartPosition() const
@@ -104,26 +100,28 @@ Rectangle2D Level::GetUniverseSize() const
     return {0, 0, static_cast<int>(world_width), static_cast<int>(world_height)};
 }
 
-IEvent* Level::EventAt(int x, int y) const
+EventCommand Level::CollisionWithHero(int event, const time_point& now)
 {
-    if (x < 0 || y < 0 || x >= world_width || y >= world_height)
-    {
-        return nullptr;
-    }
-    return lookupMap->GetEventAt(FromUnivCoord(x, y));
+    return events.CollisionWithHero(event, now);
 }
 
-Tile* Level::TileAt(int x, int y) const
+bool Level::IsCollidableAt(int x, int y) const
 {
-    if (x < 0 || y < 0 || x >= world_width || y >= world_height)
-    {
-        return nullptr;
-    }
-    return lookupMap->GetTileAt(FromUnivCoord(x, y));
+    return collisionBitmap.IsSolid(x, y);
+}
+
+const CollisionBitmap& Level::GetCollisionBitmap() const
+{
+    return collisionBitmap;
+}
+
+void Level::HashState(StateHash& h) const
+{
+    events.HashState(h);
 }
 
 
-void Level::RenderLayers(Surface& screen, int from, int to, const WorldTransformations& tr)
+void Level::RenderLayers(RenderQueue& queue, int from, int to, const WorldTransformations& tr) const
 {
     for (int l = from; l >= to; --l)
     {
@@ -132,11 +130,16 @@ void Level::RenderLayers(Surface& screen, int from, int to, const WorldTransform
         if (world_height != layer.GetHeight() || world_width != layer.GetWidth())
         {
             const auto& tr_loc = tr.CreateNewWT(layer.GetWidth(), layer.GetHeight());
-            layer.Render(screen, tr_loc);
+            layer.Render(queue, tr_loc, GetLayerDepth(l));
         }
         else
         {
-            layer.Render(screen, tr);
+            layer.Render(queue, tr, GetLayerDepth(l));
         }
     }
 }
+
+uint8_t Level::GetLayerDepth(int l) const
+{
+    return static_cast<uint8_t>(4 * (layers.size() - 1 - l));
+}
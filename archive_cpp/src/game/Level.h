@@ -2,14 +2,17 @@
 #define LEVEL_H
 
 #include "gfx/Surface.h"
+#include "gfx/RenderQueue.h"
 #include "game/WorldTransformations.h"
 #include "Layer.h"
-#include "Event.h"
+#include "CollisionBitmap.h"
+#include "BroadPhaseGrid.h"
+#include "ActivityScheduler.h"
+#include "EventStore.h"
 #include <vector>
 #include <memory>
 #include <assert.h>
 
-class ObjectLookupMap;
 /*
  * Responsibilities:
  * - contains all objects which belong to specified level
@@ -19,28 +22,67 @@ class ObjectLookupMap;
 class Level
 {
 public:
-    Level(unsigned worldWidth, unsigned worldHeight, std::vector<Layer> ls,
-          unsigned actionLayer, std::vector<EventPtr> es, const Point2D& heroStartPos);
+    // arena holds the layer grids and events, the level adds its collision
+    // bitmap and event grid to it; unloading frees its blocks at once
+    Level(std::unique_ptr<Arena> arena, unsigned worldWidth, unsigned worldHeight, TileSetPtr ts,
+          std::vector<Layer> ls, unsigned actionLayer, EventStore es, const Point2D& heroStartPos);
     ~Level();
-    void Render(Surface& screen, const WorldTransformations& tr);
+    // updates events within the areas (around the camera, the hero, ...),
+    // the rest of them sleep
+    void Update(const time_point& now, const std::vector<Rectangle2D>& activeAreas);
+    // pushes the visible layers and events, layer l gets depth
+    // 4 * (layer count - 1 - l), sprites go just above the action layer
+    // render thread: the tile layers, the events come from a snapshot
+    void RenderLayers(RenderQueue& queue, const WorldTransformations& tr);
+    // indexed rendering mode: the layers are composited into an 8 bit framebuffer
+    void RenderLayers(IndexedSurface& target, const WorldTransformations& tr);
+    // simulation thread: the events within view (universe coordinates)
+    void CaptureEvents(RenderSnapshot& snapshot, const Rectangle2D& view);
+    // events at the sprite depth, their messages one above, the hero above
+    // both; all below the next layer
+    uint8_t GetSpriteDepth() const;
+    uint8_t GetHeroDepth() const;
     Point2D GetHeroStartPosition() const;
     Rectangle2D GetUniverseSize() const;
-    IEvent* EventAt(int x, int y) const;
-    Tile* TileAt(int x, int y) const;
+    // calls fn(int event) for every event overlapping r
+    template <class Fn>
+    void ForEachEventIn(const Rectangle2D& r, Fn&& fn) const;
+    EventCommand CollisionWithHero(int event, const time_point& now);
+    bool IsCollidableAt(int x, int y) const;
+    // terrain of the action layer, built once at load
+    const CollisionBitmap& GetCollisionBitmap() const;
+    // the events, the rest of the level does not change
+    void HashState(StateHash& h) const;
 private:   
+    // destroyed last, everything below may live in it
+    std::unique_ptr<Arena>  arena;
+    TileSetPtr              tileSet;
     std::vector<Layer>      layers;
-    std::vector<EventPtr>   events;
+    EventStore              events;
+    std::vector<int>        selectedEvents; // scratch buffer for the event systems
 
     Point2D heroStartPosition;
 
-    std::unique_ptr<ObjectLookupMap>     lookupMap;
     const int world_width = 0;
     const int world_height = 0;
     const int action_layer = 0;
+    const CollisionBitmap collisionBitmap;
+    BroadPhaseGrid eventGrid;
+    ActivityScheduler scheduler;
 
-    void RenderLayers(Surface& screen, int from, int to, const WorldTransformations& tr);
+    void RenderLayers(RenderQueue& queue, int from, int to, const WorldTransformations& tr) const;
+    uint8_t GetLayerDepth(int l) const;
 };
 
+template <class Fn>
+void Level::ForEachEventIn(const Rectangle2D& r, Fn&& fn) const
+{
+    eventGrid.QueryRect(r, [&](BroadPhaseGrid::ProxyId id)
+    {
+        fn(static_cast<int>(eventGrid.GetUserData(id)));
+    });
+}
+
 typedef std::shared_ptr<Level> LevelPtr;
 
 #endif // LEVEL_H
@@ -0,0 +1,45 @@
+#include "RenderSnapshot.h"
+
+void RenderSnapshot::Clear()
+{
+    camera = {0, 0};
+    items.clear();
+}
+
+void RenderSnapshot::AddSprite(uint8_t depth, const Surface& s, const Point2D& p, bool mirrored)
+{
+    items.push_back({&s, p, Color32(), depth, mirrored ? Kind::MirroredSprite : Kind::Sprite});
+}
+
+void RenderSnapshot::AddText(uint8_t depth, const TextRun& t, const Point2D& p)
+{
+    items.push_back({&t, p, Color32(), depth, Kind::Text});
+}
+
+void RenderSnapshot::AddPixel(uint8_t depth, const Point2D& p, const Color32& c)
+{
+    items.push_back({nullptr, p, c, depth, Kind::Pixel});
+}
+
+void RenderSnapshot::Submit(RenderQueue& queue, const WorldTransformations& tr) const
+{
+    for (const auto& i : items)
+    {
+        Point2D p = tr.FromUniverseToScreen(i.position);
+        switch (i.kind)
+        {
+        case Kind::Sprite:
+            queue.PushSprite(i.depth, *static_cast<const Surface*>(i.source), p.x, p.y);
+            break;
+        case Kind::MirroredSprite:
+            queue.PushSpriteMirrored(i.depth, *static_cast<const Surface*>(i.source), p.x, p.y);
+            break;
+        case Kind::Text:
+            queue.PushText(i.depth, *static_cast<const TextRun*>(i.source), p.x, p.y);
+            break;
+        case Kind::Pixel:
+            queue.PushPixel(i.depth, p.x, p.y, i.color);
+            break;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef RENDERSNAPSHOT_H
+#define RENDERSNAPSHOT_H
+
+#include "game/WorldTransformations.h"
+#include "gfx/RenderQueue.h"
+#include "gfx/TextRun.h"
+#include "utils/Utils.h"
+
+#include <cstdint>
+#include <vector>
+
+// What the render thread needs of one simulation step: the camera and the
+// sprites, texts and pixels of the entities around it, with their current
+// animation frames resolved. Positions are in universe coordinates. The
+// surfaces and texts referenced belong to the level and the hero and do
+// not change while they live, so a snapshot can be drawn while the
+// simulation goes on.
+class RenderSnapshot
+{
+public:
+    // left top corner of the view in the universe
+    Point2D camera = {0, 0};
+
+    void Clear();
+    void AddSprite(uint8_t depth, const Surface& s, const Point2D& p, bool mirrored = false);
+    void AddText(uint8_t depth, const TextRun& t, const Point2D& p);
+    void AddPixel(uint8_t depth, const Point2D& p, const Color32& c);
+    size_t Size() const { return items.size(); }
+
+    // pushes everything to queue, tr maps the positions to the screen
+    void Submit(RenderQueue& queue, const WorldTransformations& tr) const;
+private:
+    enum class Kind : uint8_t
+    {
+        Sprite,
+        MirroredSprite,
+        Text,
+        Pixel
+    };
+
+    struct Item
+    {
+        const void*     source;     // Surface or TextRun, nullptr for pixels
+        Point2D         position;
+        Color32         color;
+        uint8_t         depth;
+        Kind            kind;
+    };
+
+    std::vector<Item>   items;
+};
+
+#endif // RENDERSNAPSHOT_H
@@ -0,0 +1,38 @@
+#include "Replay.h"
+#include "Game.h"
+#include "utils/Time.h"
+
+#include <chrono>
+#include <stdlib.h>
+
+ReplayResult RunReplay(const InputLog& log)
+{
+    typedef std::chrono::steady_clock Clock;
+    ReplayResult result;
+    srand(log.seed);
+    GameClock::time_point now{GameClock::duration(log.startTime)};
+    GameClock::SetVirtualTime(now);
+
+    auto start = Clock::now();
+    Game game(log.level);
+    auto loaded = Clock::now();
+    // as App::Simulate: the clock of the step, the input, the update
+    for (const auto& run : log.GetRuns())
+    {
+        for (uint32_t s = 0; s < run.steps; ++s)
+        {
+            ApplyInput(game, run.keys);
+            game.UpdateState(static_cast<long>(now.time_since_epoch().count()));
+            now += GameClock::duration(log.stepMs);
+            GameClock::SetVirtualTime(now);
+        }
+        result.steps += run.steps;
+    }
+    auto done = Clock::now();
+    GameClock::UseRealTime();
+
+    result.loadSeconds = std::chrono::duration<double>(loaded - start).count();
+    result.simulationSeconds = std::chrono::duration<double>(done - loaded).count();
+    result.stateHash = game.GetStateHash();
+    return result;
+}
@@ -0,0 +1,22 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game/InputLog.h"
+
+#include <cstdint>
+
+struct ReplayResult
+{
+    uint64_t    steps = 0;
+    double      loadSeconds = 0;
+    double      simulationSeconds = 0;
+    uint64_t    stateHash = 0;      // Game::GetStateHash() after the last step
+};
+
+// Plays the session of the log back headless and as fast as the CPU allows:
+// the level is loaded as recorded, GameClock is virtual and moves stepMs
+// ahead per step, nothing is rendered. The graphics engine has to be
+// initialized with the resolution of the log (InitializeHeadless).
+ReplayResult RunReplay(const InputLog& log);
+
+#endif // REPLAY_H
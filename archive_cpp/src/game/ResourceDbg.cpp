@@ -22,7 +22,8 @@ void ResourceDbg::UpdateState(long /*currentTime*/)
 
 void ResourceDbg::Render(long /*currentTime*/)
 {
-    auto& screen = GraphicsEngine::getInstance().Screen();
+    auto& screen = GraphicsEngine::getInstance().Backend();
+    labelCount = 0;
     DisplayTileSets(screen);
     DisplayAnimations(screen);
     DisplayEvents(screen);
@@ -48,7 +49,18 @@ void ResourceDbg::Right()
     dx -= 20;
 }
 
-void ResourceDbg::DisplayTileSets(Surface& screen)
+const TextRun& ResourceDbg::Label(const std::string& text, const Color32& c)
+{
+    if (labelCount == labels.size())
+    {
+        labels.emplace_back();
+    }
+    TextRun& label = labels[labelCount++];
+    label.Set(text, c);
+    return label;
+}
+
+void ResourceDbg::DisplayTileSets(IRenderBackend& screen)
 {
     int x = 0;
     int y = 0;
@@ -64,7 +76,7 @@ void ResourceDbg::DisplayTileSets(Surface& screen)
     }
 }
 
-void ResourceDbg::DisplayAnimations(Surface& screen)
+void ResourceDbg::DisplayAnimations(IRenderBackend& screen)
 {
     int set_id = 0;
     int y = 0;
@@ -72,7 +84,7 @@ void ResourceDbg::DisplayAnimations(Surface& screen)
     {
         int max_height = 15;
         int x = 350;
-        screen.WriteText(to_string(set_id), x + dx - 20, y + dy, {0, 255, 0});
+        screen.DrawText(Label(to_string(set_id), {0, 255, 0}), x + dx - 20, y + dy);
         int anim_id = 0;
         for (auto& a : v)
         {
@@ -81,10 +93,9 @@ void ResourceDbg::DisplayAnimations(Surface& screen)
             screen.Draw(s, x + dx, y + dy);
             if (anim_id % 10 == 0)
             {
-                screen.WriteText(to_string(anim_id),
-                             x + dx + s.getWidth() / 2,
-                             y + dy + s.getHeight() / 2,
-                            {255, 255, 255, 255});
+                screen.DrawText(Label(to_string(anim_id), {255, 255, 255, 255}),
+                                x + dx + s.getWidth() / 2,
+                                y + dy + s.getHeight() / 2);
             }
             x += a.GetMaxWidth();
             max_height = std::max(max_height, a.GetMaxHeight());
@@ -95,5 +106,5 @@ void ResourceDbg::DisplayAnimations(Surface& screen)
     }
 }
 
-void ResourceDbg::DisplayEvents(Surface& /*screen*/)
+void ResourceDbg::DisplayEvents(IRenderBackend& /*screen*/)
 { }
@@ -4,7 +4,10 @@
 #include "IStoryBoard.h"
 #include "gfx/Surface.h"
 #include "gfx/Animation.h"
+#include "gfx/RenderBackend.h"
+#include "gfx/TextRun.h"
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -23,15 +26,20 @@ public:
     void Left();
     void Right();
 private:
-    int dx = 0;
-    int dy = 0;
+    // moved by the simulation thread, read by the render thread
+    std::atomic<int> dx{0};
+    std::atomic<int> dy{0};
 
     std::vector<SurfaceSharedPtr> tiles;
     std::vector<std::vector<Animation>> animations;
-
-    void DisplayTileSets(Surface& screen);
-    void DisplayAnimations(Surface& screen);
-    void DisplayEvents(Surface& screen);
+    // labels drawn this frame, rasterized again only when they change
+    std::vector<TextRun> labels;
+    size_t labelCount = 0;
+
+    const TextRun& Label(const std::string& text, const Color32& c);
+    void DisplayTileSets(IRenderBackend& screen);
+    void DisplayAnimations(IRenderBackend& screen);
+    void DisplayEvents(IRenderBackend& screen);
 };
 
 typedef std::shared_ptr<ResourceDbg> ResourceDbgPtr;
@@ -1 +0,0 @@
-#include "Tile.h"
@@ -0,0 +1,127 @@
+#include "TileSet.h"
+#include "utils/BinaryReader.h"
+
+#include <cstring>
+#include <assert.h>
+
+TileSet::TileSet(int anim_offset)
+    : animOffset(anim_offset)
+{ }
+
+void TileSet::AddTile(const SurfaceSharedPtr& image, const SurfaceSharedPtr& flippedImage,
+                      const char* collisionMask, const char* flippedCollisionMask)
+{
+    images.push_back(image);
+    images.push_back(flippedImage);
+    auto offset = collisionMasks.size();
+    collisionMasks.resize(offset + 2 * collisionMaskSize);
+    memcpy(&collisionMasks[offset], collisionMask, collisionMaskSize);
+    memcpy(&collisionMasks[offset + collisionMaskSize], flippedCollisionMask, collisionMaskSize);
+    memory.Set(MemoryCategory::TileSet, HeapBytes(collisionMasks) + HeapBytes(images));
+}
+
+void TileSet::AddAnimatedTile(const Animation& a)
+{
+    animations.push_back(a);
+}
+
+const Surface* TileSet::GetImage(TileId id, bool flipped) const
+{
+    if (!IsAnimated(id))
+    {
+        return images[id * 2 + (flipped ? 1 : 0)].get();
+    }
+    const auto* a = GetAnimation(id);
+    if (a == nullptr || a->FrameCount() == 0)
+    {
+        return nullptr;
+    }
+    return &a->GetCurrentFrame();
+}
+
+const IndexedSurface* TileSet::GetIndexedImage(TileId id, bool flipped) const
+{
+    if (!IsAnimated(id))
+    {
+        int i = id * 2 + (flipped ? 1 : 0);
+        return i < static_cast<int>(indexedImages.size()) ? indexedImages[i].get() : nullptr;
+    }
+    const auto* a = GetAnimation(id);
+    int index = id - animOffset;
+    if (a == nullptr || index >= static_cast<int>(animationFrameImages.size()))
+    {
+        return nullptr;
+    }
+    const auto& frames = animationFrameImages[index];
+    int f = a->GetPlayback().GetCurrentFrame();
+    if (f >= static_cast<int>(frames.size()) || frames[f] >= static_cast<int>(indexedImages.size()))
+    {
+        return nullptr;
+    }
+    return indexedImages[frames[f]].get();
+}
+
+void TileSet::SetIndexedImages(TileId id, IndexedSurfacePtr image, IndexedSurfacePtr flippedImage)
+{
+    if (indexedImages.size() < images.size())
+    {
+        indexedImages.resize(images.size());
+    }
+    indexedImages[id * 2] = std::move(image);
+    indexedImages[id * 2 + 1] = std::move(flippedImage);
+}
+
+void TileSet::SetAnimatedTileFrames(TileId id, const std::vector<std::pair<TileId, bool>>& frames)
+{
+    int index = id - animOffset;
+    assert(index >= 0);
+    if (static_cast<int>(animationFrameImages.size()) <= index)
+    {
+        animationFrameImages.resize(index + 1);
+    }
+    auto& frameImages = animationFrameImages[index];
+    frameImages.clear();
+    for (const auto& f : frames)
+    {
+        frameImages.push_back(f.first * 2 + (f.second ? 1 : 0));
+    }
+}
+
+const char* TileSet::GetCollisionMask(TileId id, bool flipped) const
+{
+    if (IsAnimated(id))
+    {
+        // TODO: animated tiles have no collision data yet
+        return nullptr;
+    }
+    return &collisionMasks[(id * 2 + (flipped ? 1 : 0)) * collisionMaskSize];
+}
+
+bool TileSet::IsCollidableAt(TileId id, bool flipped, int dx, int dy) const
+{
+    const char* mask = GetCollisionMask(id, flipped);
+    if (mask == nullptr)
+    {
+        return false;
+    }
+    assert(dx >= 0 && dx < tileSize && dy >= 0 && dy < tileSize);
+    return BinaryReader::IsBitSetAt(mask, dy * tileSize + dx);
+}
+
+void TileSet::Update(const time_point& now)
+{
+    for (auto& a : animations)
+    {
+        a.Update(now);
+    }
+}
+
+const Animation* TileSet::GetAnimation(TileId id) const
+{
+    int index = id - animOffset;
+    if (index < 0 || index >= static_cast<int>(animations.size()))
+    {
+        return nullptr;
+    }
+    return &animations[index];
+}
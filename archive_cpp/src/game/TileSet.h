@@ -0,0 +1,60 @@
+#ifndef TILESET_H
+#define TILESET_H
+
+#include "gfx/Animation.h"
+#include "gfx/IndexedSurface.h"
+#include "utils/MemoryStats.h"
+#include "utils/Time.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+typedef uint16_t TileId;
+
+// Tile tables shared by all layers of a level. Layers keep only tile ids,
+// the images, collision masks and animated tiles are stored here once.
+class TileSet
+{
+public:
+    static constexpr int tileSize = 32;
+    static constexpr int collisionMaskSize = tileSize * tileSize / 8;
+
+    // animated tile ids start at anim_offset (see J2L AnimOffset)
+    explicit TileSet(int anim_offset);
+    void AddTile(const SurfaceSharedPtr& image, const SurfaceSharedPtr& flippedImage,
+                 const char* collisionMask, const char* flippedCollisionMask);
+    void AddAnimatedTile(const Animation& a);
+    // 8 bit images for the indexed rendering mode, optional
+    void SetIndexedImages(TileId id, IndexedSurfacePtr image, IndexedSurfacePtr flippedImage);
+    // frame f of animated tile id shows the static tile frames[f] (id, flipped)
+    void SetAnimatedTileFrames(TileId id, const std::vector<std::pair<TileId, bool>>& frames);
+
+    int GetStaticTileCount() const { return static_cast<int>(images.size() / 2); }
+    bool IsAnimated(TileId id) const { return id >= GetStaticTileCount(); }
+    // returns nullptr if there is nothing to draw
+    const Surface* GetImage(TileId id, bool flipped) const;
+    const IndexedSurface* GetIndexedImage(TileId id, bool flipped) const;
+    // returns nullptr if the tile never collides
+    const char* GetCollisionMask(TileId id, bool flipped) const;
+    bool IsCollidableAt(TileId id, bool flipped, int dx, int dy) const;
+    // advances all animated tiles, called once per frame
+    void Update(const time_point& now);
+private:
+    const int                       animOffset;
+    std::vector<SurfaceSharedPtr>   images; // [id * 2 + flipped]
+    std::vector<char>               collisionMasks; // collisionMaskSize per image
+    std::vector<Animation>          animations;
+    std::vector<IndexedSurfacePtr>  indexedImages; // as images
+    // per animated tile, images index of every frame
+    std::vector<std::vector<int>>   animationFrameImages;
+    // the masks, the images are charged as surfaces
+    MemoryCharge                    memory;
+
+    const Animation* GetAnimation(TileId id) const;
+};
+
+typedef std::shared_ptr<TileSet> TileSetPtr;
+
+#endif // TILESET_H
@@ -9,79 +9,36 @@ Animation::Animation(double fps)
 { }
 
 Animation::Animation(std::initializer_list<std::string> frames)
+    : _fps(10)
 {
     for (const auto& f: frames)
     {
-        _frames.push_back({ResourceFactory::GetInstance().LoadSurface(f, 255, 0, 255)});
-        _framesInfo.push_back({});
+        PushFrame(ResourceFactory::GetInstance().LoadSurface(f, 255, 0, 255));
     }
 
-    if (_frames.size() != 0)
+    if (FrameCount() != 0)
     {
-        _strategy.reset(new NormalAnimationStrategy(10, _frames.size()));
-    }
-
-    for (const auto& f: _frames)
-    {
-        _maxWidth = std::max(f->getWidth(), _maxWidth);
-        _maxHeight = std::max(f->getHeight(), _maxHeight);
+        SetStrategy(AnimationStrategy::Normal);
     }
 }
 
-Animation::Animation(const Animation& a)
-    : _frames(a._frames)
-    , _mirroredFrames(a._mirroredFrames)
-    , _framesInfo(a._framesInfo)
-    , _fps(a._fps)
-    , _maxWidth(a._maxWidth)
-    , _maxHeight(a._maxHeight)
-{
-    _strategy.reset(a._strategy->Clone());
-}
-
-Animation& Animation::operator=(const Animation& a)
-{
-    _frames = a._frames;
-    _mirroredFrames = a._mirroredFrames;
-    _framesInfo = a._framesInfo;
-    _fps = a._fps;
-    _maxWidth = a._maxWidth;
-    _maxHeight = a._maxHeight;
-    _strategy.reset(a._strategy->Clone());
-    return *this;
-}
-
 const Surface& Animation::GetCurrentFrame() const
 {
-    assert(_strategy.get() != nullptr && "No animation strategy assigned!");
-    assert(_frames.size() > (unsigned int)_strategy->GetCurrentFrame());
-    return *(_frames[_strategy->GetCurrentFrame()].get());
+    assert(_frameSet && "Animation has no frames!");
+    assert(_frameSet->frames.size() > (unsigned int)_playback.GetCurrentFrame());
+    return *(_frameSet->frames[_playback.GetCurrentFrame()].get());
 }
 
-const Surface& Animation::GetCurrentFrameMirrored() const
+const Surface& Animation::GetFrame(int index) const
 {
-    assert(_strategy.get() != nullptr && "No animation strategy assigned!");
-    assert(_mirroredFrames.size() > (unsigned int)_strategy->GetCurrentFrame());
-    return *(_mirroredFrames[_strategy->GetCurrentFrame()].get());
+    assert(_frameSet && "Animation has no frames!");
+    assert(index >= 0 && _frameSet->frames.size() > (unsigned int)index);
+    return *(_frameSet->frames[index].get());
 }
 
 void Animation::SetStrategy(AnimationStrategy s)
 {
-    switch (s)
-    {
-    case AnimationStrategy::Normal:
-        _strategy.reset(new NormalAnimationStrategy(_fps, _frames.size()));
-        break;
-    case AnimationStrategy::Oscillate:
-        _strategy.reset(new OscillateAnimationStrategy(_fps, _frames.size()));
-        break;
-    case AnimationStrategy::OnlyFirtsFrame:
-        _strategy.reset(new AnimateOnlyFirtsFrame);
-        break;
-    case AnimationStrategy::AnimateTillLastFrame:
-        _strategy.reset(new AnimateTillTheEnd(_fps, _frames.size()));
-        break;
-    }
+    _playback = AnimationPlayback(s, _fps, FrameCount());
 }
 
 void Animation::PushFrame(const SurfaceSharedPtr& frame)
@@ -91,32 +48,47 @@ void Animation::PushFrame(const SurfaceSharedPtr& frame)
 
 void Animation::PushFrame(const SurfaceSharedPtr& frame, const AnimFrameInfo& info)
 {
-    _frames.push_back(frame);
-    _framesInfo.push_back(info);
-    _maxWidth = std::max(frame->getWidth(), _maxWidth);
-    _maxHeight = std::max(frame->getHeight(), _maxHeight);
+    auto& fs = MutableFrames();
+    fs.frames.push_back(frame);
+    fs.framesInfo.push_back(info);
+    fs.maxWidth = std::max(frame->getWidth(), fs.maxWidth);
+    fs.maxHeight = std::max(frame->getHeight(), fs.maxHeight);
 }
 
 void Animation::Update(const time_point& timeTick)
 {
-    _strategy->Update(timeTick);
+    _playback.Update(timeTick);
 }
 
-void Animation::SetUpMirroredFrames()
+unsigned int Animation::FrameCount() const
 {
-    SurfaceCopyEffects eff;
-    eff.flipVertically = true;
-    for (const auto& f: _frames)
-    {
-        Surface s = f->Copy(eff);
-        SurfaceSharedPtr sptr = std::make_shared<Surface>(Surface());
-        sptr->swap(s);
-        _mirroredFrames.push_back(sptr);
-    }
+    return _frameSet ? _frameSet->frames.size() : 0;
+}
+
+int Animation::GetMaxWidth() const
+{
+    return _frameSet ? _frameSet->maxWidth : 0;
+}
+
+int Animation::GetMaxHeight() const
+{
+    return _frameSet ? _frameSet->maxHeight : 0;
 }
 
 bool Animation::IsFinished() const
 {
-    assert(_strategy.get() != nullptr);
-    return _strategy->IsFinished();
+    return _playback.IsFinished();
+}
+
+Animation::FrameSet& Animation::MutableFrames()
+{
+    if (!_frameSet)
+    {
+        _frameSet = std::make_shared<FrameSet>();
+    }
+    else if (_frameSet.use_count() > 1)
+    {
+        _frameSet = std::make_shared<FrameSet>(*_frameSet);
+    }
+    return *_frameSet;
 }
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include "AnimationCalculator.h"
 #include "Surface.h"
 
@@ -17,50 +18,49 @@ struct AnimFrameInfo
     short GunspotY;     // Relative to hotspot
 };
 
-enum class AnimationStrategy
-{
-    Normal,
-    Oscillate, // 1234321 patern
-    OnlyFirtsFrame,
-    AnimateTillLastFrame
-};
-
 class Animation
 {
 public:
     explicit Animation(double fps);
     Animation(std::initializer_list<std::string> frames);
-    Animation(const Animation&);
+    // copies share frames and only duplicate the playback state
+    Animation(const Animation&) = default;
     Animation(Animation&&) = default;
-    Animation& operator=(const Animation&);
+    Animation& operator=(const Animation&) = default;
     Animation& operator=(Animation&&) = default;
     // gets current frame, in order to proper working Update() method
     // has to be frequently called
     const Surface& GetCurrentFrame() const;
-    const Surface& GetCurrentFrameMirrored() const;
+    const Surface& GetFrame(int index) const;
+    // playback state, may be kept apart from the frames (see EventStore)
+    const AnimationPlayback& GetPlayback() const { return _playback; }
+    double GetFps() const { return _fps; }
     void SetStrategy(AnimationStrategy s);
-    // adds a new frame (if you use mirroed frames
-    // then SetUpMirroredFrames() need to be called
+    // adds a new frame
     void PushFrame(const SurfaceSharedPtr& frame);
     void PushFrame(const SurfaceSharedPtr& frame, const AnimFrameInfo& info);
     // updates the internal frame calculator
     void Update(const time_point& timeTick);
-    // prepare mirrored frames (corresponds to GetCurrentFrameMirrored())
-    void SetUpMirroredFrames();
-    inline unsigned int FrameCount() const
-    { return _frames.size(); }
-    int GetMaxWidth() const { return _maxWidth; }
-    int GetMaxHeight() const { return _maxHeight; }
+    unsigned int FrameCount() const;
+    int GetMaxWidth() const;
+    int GetMaxHeight() const;
     bool IsFinished() const;
 protected:
-    std::unique_ptr<IAnimationStrategy> _strategy;
-    std::vector<SurfaceSharedPtr>   _frames;
-    std::vector<SurfaceSharedPtr>   _mirroredFrames;
-    std::vector<AnimFrameInfo>      _framesInfo;
+    // Frames are immutable once an animation has been copied, so all copies
+    // share one FrameSet. Modifying methods detach it first (copy on write).
+    struct FrameSet
+    {
+        std::vector<SurfaceSharedPtr>   frames;
+        std::vector<AnimFrameInfo>      framesInfo;
+        int maxWidth = 0;
+        int maxHeight = 0;
+    };
+
+    std::shared_ptr<FrameSet>   _frameSet;
+    AnimationPlayback           _playback;
+    double                      _fps = 0;
 
-    double _fps = 0;
-    int _maxWidth = 0;
-    int _maxHeight = 0;
+    FrameSet& MutableFrames();
 };
 
 #endif // ANIMATION_H
@@ -1,166 +1,107 @@
 #include "AnimationCalculator.h"
 
 #include <assert.h>
+#include <limits>
 
-IAnimationStrategy::~IAnimationStrategy() { }
-
-NormalAnimationStrategy::NormalAnimationStrategy(double fps, int frame_count)
-    : timer(fps)
-    , frameCount(frame_count)
-{
-    assert(frameCount != 0);
-    assert(fps != 0.0);
-}
-
-int NormalAnimationStrategy::GetCurrentFrame() const
-{
-    return currentFrame;
-}
-
-bool NormalAnimationStrategy::IsFinished() const
+AnimationPlayback::AnimationPlayback(AnimationStrategy s, double fps, int frame_count)
+    : frameCount(static_cast<int16_t>(frame_count))
+    , strategy(s)
 {
-    return false;
-}
-
-void NormalAnimationStrategy::Restart(const time_point& current)
-{
-    currentFrame = 0;
-    timer.Restart(current);
-}
-
-void NormalAnimationStrategy::Update(const time_point& current)
-{
-    if (timer.IsNextFrame(current))
+    assert(frame_count != 0);
+    assert(frame_count <= std::numeric_limits<int16_t>::max());
+    if (strategy != AnimationStrategy::OnlyFirtsFrame)
     {
-        ++currentFrame;
-        if (currentFrame >= frameCount)
-        {
-            currentFrame = 0;
-        }
+        assert(fps != 0.0);
+        framePeriod = static_cast<int32_t>(1000.0 / fps);
     }
 }
 
-IAnimationStrategy* NormalAnimationStrategy::Clone() const
-{
-    return new NormalAnimationStrategy(*this);
-}
-
-OscillateAnimationStrategy::OscillateAnimationStrategy(double fps, int frame_count)
-    : timer(fps)
-    , frameCount(frame_count)
+bool AnimationPlayback::IsFinished() const
 {
-    assert(fps != 0.0);
-    assert(frameCount != 0);
-}
-
-int OscillateAnimationStrategy::GetCurrentFrame() const
-{
-    return currentFrame;
+    if (strategy == AnimationStrategy::AnimateTillLastFrame)
+    {
+        return currentFrame >= frameCount - 1;
+    }
+    return false;
 }
 
-bool OscillateAnimationStrategy::IsFinished() const
+time_point AnimationPlayback::GetLastFrameTime() const
 {
-    return false;
+    return lastFrame + miliseconds(framePeriod * (frameCount - 1 - currentFrame));
 }
 
-void OscillateAnimationStrategy::Restart(const time_point& current)
+void AnimationPlayback::Restart(const time_point& current)
 {
     currentFrame = 0;
     countDirection = true;
-    timer.Restart(current);
+    lastFrame = current;
 }
 
-void OscillateAnimationStrategy::Update(const time_point& current)
+void AnimationPlayback::Update(const time_point& current)
 {
-    if (timer.IsNextFrame(current))
+    switch (strategy)
     {
-        if (countDirection)
+    case AnimationStrategy::Normal:
+        if (IsNextFrame(current))
         {
             ++currentFrame;
+            if (currentFrame >= frameCount)
+            {
+                currentFrame = 0;
+            }
         }
-        else
+        break;
+    case AnimationStrategy::Oscillate:
+        if (IsNextFrame(current))
         {
-            --currentFrame;
-        }
+            if (countDirection)
+            {
+                ++currentFrame;
+            }
+            else
+            {
+                --currentFrame;
+            }
 
-        if (currentFrame >= frameCount)
-        {
-            auto new_frame = frameCount - 2;
-            currentFrame = (new_frame >= 0)? new_frame : 0;
+            if (currentFrame >= frameCount)
+            {
+                auto new_frame = frameCount - 2;
+                currentFrame = (new_frame >= 0)? new_frame : 0;
+            }
+            else if (currentFrame < 0)
+            {
+                auto new_frame = 1;
+                currentFrame = (new_frame >= frameCount)? 0 : new_frame;
+            }
         }
-        else if (currentFrame < 0)
+        break;
+    case AnimationStrategy::OnlyFirtsFrame:
+        break;
+    case AnimationStrategy::AnimateTillLastFrame:
+        if (IsNextFrame(current))
         {
-            auto new_frame = 1;
-            currentFrame = (new_frame >= frameCount)? 0 : new_frame;
+            if (currentFrame < frameCount - 1)
+            {
+                ++currentFrame;
+            }
         }
+        break;
     }
 }
 
-IAnimationStrategy* OscillateAnimationStrategy::Clone() const
-{
-    return new OscillateAnimationStrategy(*this);
-}
-
-int AnimateOnlyFirtsFrame::GetCurrentFrame() const
-{
-    return 0;
-}
-
-bool AnimateOnlyFirtsFrame::IsFinished() const
-{
-    return false;
-}
-
-void AnimateOnlyFirtsFrame::Restart(const time_point&)
-{ }
-
-void AnimateOnlyFirtsFrame::Update(const time_point&)
-{ }
-
-IAnimationStrategy* AnimateOnlyFirtsFrame::Clone() const
-{
-    return new AnimateOnlyFirtsFrame(*this);
-}
-
-AnimateTillTheEnd::AnimateTillTheEnd(double fps, int frame_count)
-    : timer(fps)
-    , frameCount(frame_count)
+bool AnimationPlayback::IsNextFrame(const time_point& current)
 {
-    assert(fps != 0.0);
-    assert(frameCount != 0);
-}
-
-int AnimateTillTheEnd::GetCurrentFrame() const
-{
-    return currentFrame;
-}
-
-bool AnimateTillTheEnd::IsFinished() const
-{
-    return currentFrame >= frameCount - 1;
-}
+    miliseconds diff = current - lastFrame;
 
-void AnimateTillTheEnd::Restart(const time_point& current)
-{
-    currentFrame = 0;
-    timer.Restart(current);
-}
-
-void AnimateTillTheEnd::Update(const time_point& current)
-{
-    if (timer.IsNextFrame(current))
+    if (diff.count() >= framePeriod)
     {
-        if (currentFrame < frameCount - 1)
-        {
-            ++currentFrame;
-        }
+        lastFrame = current;
+        return true;
     }
-}
 
-IAnimationStrategy* AnimateTillTheEnd::Clone() const
-{
-    return new AnimateTillTheEnd(*this);
+    return false;
 }
+
 /*
 void AnimationCalculator::SetCurrentFrame(int Frame)
 {
@@ -3,101 +3,43 @@
 
 #include "utils/Time.h"
 
-class FrameCalcHelper
-{
-public:
-    FrameCalcHelper(double fps_)
-        : fps(fps_)
-        , frame_period(static_cast<int>(1000.0 / fps_))
-    { }
-    void Restart(const time_point& current)
-    {
-        time = current;
-    }
-    bool IsNextFrame(const time_point& current)
-    {
-        miliseconds diff = current - time;
-
-        if (diff >= frame_period)
-        {
-            time = current;
-            return true;
-        }
-
-        return false;
-    }
-private:
-    const double        fps;
-    time_point          time;
-    const miliseconds   frame_period;
-};
-
-struct IAnimationStrategy
-{
-    virtual ~IAnimationStrategy();
-    virtual int GetCurrentFrame() const = 0;
-    virtual bool IsFinished() const = 0;
-    virtual void Restart(const time_point& current) = 0;
-    virtual void Update(const time_point& current) = 0;
-    virtual IAnimationStrategy* Clone() const = 0;
-};
-
-class NormalAnimationStrategy : public IAnimationStrategy
-{
-public:
-    NormalAnimationStrategy(double fps, int frame_count);
-    virtual int GetCurrentFrame() const override;
-    virtual bool IsFinished() const override;
-    virtual void Restart(const time_point& current) override;
-    virtual void Update(const time_point& current) override;
-    virtual IAnimationStrategy* Clone() const override;
-private:
-    FrameCalcHelper timer;
-    int             frameCount;
-    int             currentFrame = 0;
-};
+#include <cstdint>
 
-class OscillateAnimationStrategy : public IAnimationStrategy
+enum class AnimationStrategy : uint8_t
 {
-public:
-    OscillateAnimationStrategy(double fps, int frame_count);
-    virtual int GetCurrentFrame() const override;
-    virtual bool IsFinished() const override;
-    virtual void Restart(const time_point& current) override;
-    virtual void Update(const time_point& current) override;
-    virtual IAnimationStrategy* Clone() const override;
-private:
-    FrameCalcHelper timer;
-    const int       frameCount;
-    int             currentFrame = 0;
-    bool            countDirection = true;
+    Normal,
+    Oscillate, // 1234321 patern
+    OnlyFirtsFrame,
+    AnimateTillLastFrame
 };
 
-class AnimateOnlyFirtsFrame : public IAnimationStrategy
+// Playback state of an animation. This is a small value type: copying it or
+// switching the strategy never allocates and updates dispatch with a switch
+// instead of a virtual call.
+class AnimationPlayback
 {
 public:
-    virtual int GetCurrentFrame() const override;
-    virtual bool IsFinished() const override;
-    virtual void Restart(const time_point& current) override;
-    virtual void Update(const time_point& current) override;
-    virtual IAnimationStrategy* Clone() const override;
+    AnimationPlayback() = default;
+    AnimationPlayback(AnimationStrategy s, double fps, int frame_count);
+
+    int GetCurrentFrame() const { return currentFrame; }
+    AnimationStrategy GetStrategy() const { return strategy; }
+    bool IsFinished() const;
+    // AnimateTillLastFrame: when the last frame is due, given updates on time
+    time_point GetLastFrameTime() const;
+    void Restart(const time_point& current);
+    void Update(const time_point& current);
 private:
+    time_point          lastFrame;
+    int32_t             framePeriod = 0; // in miliseconds
+    int16_t             frameCount = 1;
+    int16_t             currentFrame = 0;
+    AnimationStrategy   strategy = AnimationStrategy::OnlyFirtsFrame;
+    bool                countDirection = true;
+
+    bool IsNextFrame(const time_point& current);
 };
 
-class AnimateTillTheEnd : public IAnimationStrategy
-{
-public:
-    AnimateTillTheEnd(double fps, int frame_count);
-    virtual int GetCurrentFrame() const override;
-    virtual bool IsFinished() const override;
-    virtual void Restart(const time_point& current) override;
-    virtual void Update(const time_point& current) override;
-    virtual IAnimationStrategy* Clone() const override;
-private:
-    FrameCalcHelper timer;
-    const int       frameCount;
-    int             currentFrame = 0;
-};
 /*
 class AnimationCalculator
 {
@@ -0,0 +1,108 @@
+#include "Font.h"
+
+#include <algorithm>
+#include <SDL2/SDL2_gfxPrimitives_font.h>
+
+namespace {
+
+const int atlasWidth = 256;
+const int builtInGlyphSize = 8;
+
+}
+
+constexpr int Font::firstChar;
+constexpr int Font::glyphCount;
+
+Font::Font(const std::vector<SurfaceSharedPtr>& images)
+{
+    // simple shelf packing, glyphs are small and of similar height
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    for (int i = 0; i < glyphCount && i < static_cast<int>(images.size()); ++i)
+    {
+        if (!images[i])
+        {
+            continue;
+        }
+        int w = images[i]->getWidth();
+        int h = images[i]->getHeight();
+        if (x + w > atlasWidth)
+        {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        Glyph& g = glyphs[i];
+        g.x = static_cast<int16_t>(x);
+        g.y = static_cast<int16_t>(y);
+        g.w = static_cast<int16_t>(w);
+        g.h = static_cast<int16_t>(h);
+        g.advance = static_cast<int16_t>(w + 1);
+        x += w;
+        shelfHeight = std::max(shelfHeight, h);
+        lineHeight = std::max(lineHeight, h);
+    }
+    // the fonts do not always have an image for the space
+    Glyph& space = glyphs[0];
+    if (space.advance == 0)
+    {
+        space.advance = static_cast<int16_t>(std::max(lineHeight / 3, 1));
+    }
+
+    Surface s(atlasWidth, std::max(y + shelfHeight, 1));
+    atlas.swap(s);
+    for (int i = 0; i < glyphCount && i < static_cast<int>(images.size()); ++i)
+    {
+        if (images[i])
+        {
+            atlas.Draw(*images[i], glyphs[i].x, glyphs[i].y);
+        }
+    }
+}
+
+std::shared_ptr<Font> Font::BuiltIn()
+{
+    // white glyphs on a transparent background, 16 glyphs in a row
+    const int perRow = 16;
+    std::shared_ptr<Font> f(new Font());
+    Surface s(perRow * builtInGlyphSize, (glyphCount / perRow) * builtInGlyphSize);
+    f->atlas.swap(s);
+    f->lineHeight = builtInGlyphSize;
+    for (int i = 0; i < glyphCount; ++i)
+    {
+        Glyph& g = f->glyphs[i];
+        g.x = static_cast<int16_t>((i % perRow) * builtInGlyphSize);
+        g.y = static_cast<int16_t>((i / perRow) * builtInGlyphSize);
+        g.w = builtInGlyphSize;
+        g.h = builtInGlyphSize;
+        g.advance = builtInGlyphSize;
+        const unsigned char* bits = &gfxPrimitivesFontdata[(firstChar + i) * builtInGlyphSize];
+        for (int y = 0; y < builtInGlyphSize; ++y)
+        {
+            for (int x = 0; x < builtInGlyphSize; ++x)
+            {
+                if (bits[y] & (0x80 >> x))
+                {
+                    f->atlas.PutPixel(g.x + x, g.y + y, {255, 255, 255, 255});
+                }
+            }
+        }
+    }
+    return f;
+}
+
+const Font::Glyph& Font::GetGlyph(unsigned char c) const
+{
+    return (c < firstChar) ? glyphs[0] : glyphs[c - firstChar];
+}
+
+int Font::MeasureWidth(const std::string& text) const
+{
+    int w = 0;
+    for (char c : text)
+    {
+        w += GetGlyph(static_cast<unsigned char>(c)).advance;
+    }
+    return w;
+}
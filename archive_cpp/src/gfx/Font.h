@@ -0,0 +1,49 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include "gfx/Surface.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Glyphs of one font packed into a single atlas surface. Characters
+// 32..255 are supported, like in the JJ2 font sets; anything else is
+// drawn as a space.
+class Font
+{
+public:
+    static constexpr int firstChar = 32;
+    static constexpr int glyphCount = 224;
+
+    struct Glyph
+    {
+        int16_t x = 0;  // position in the atlas
+        int16_t y = 0;
+        int16_t w = 0;
+        int16_t h = 0;
+        int16_t advance = 0;
+    };
+
+    // glyphs[i] is character firstChar + i, nullptr for an empty glyph
+    explicit Font(const std::vector<SurfaceSharedPtr>& glyphs);
+    // the 8x8 font of SDL2_gfx, used until a JJ2 font is loaded
+    static std::shared_ptr<Font> BuiltIn();
+
+    const Surface& GetAtlas() const { return atlas; }
+    const Glyph& GetGlyph(unsigned char c) const;
+    int GetLineHeight() const { return lineHeight; }
+    int MeasureWidth(const std::string& text) const;
+private:
+    Font() = default;
+
+    Surface                         atlas;
+    std::array<Glyph, glyphCount>   glyphs;
+    int                             lineHeight = 0;
+};
+
+typedef std::shared_ptr<const Font> FontPtr;
+
+#endif // FONT_H
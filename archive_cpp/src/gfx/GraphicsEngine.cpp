@@ -1,6 +1,10 @@
 #include "GraphicsEngine.h"
+#include "SurfaceBackend.h"
+#include "TextureBackend.h"
+#include "utils/MemoryStats.h"
 
-#include <SDL2/SDL2_gfxPrimitives.h>
+#include <algorithm>
+#include <iostream>
 #include <SDL2/SDL.h>
 
 GraphicsEngine GraphicsEngine::engine;
@@ -10,28 +14,36 @@ GraphicsEngine& GraphicsEngine::getInstance()
     return engine;
 }
 
-void GraphicsEngine::InitializeGfxMode(int width_, int height_)
+void GraphicsEngine::InitializeGfxMode(int width_, int height_, int scale_, RenderBackendType type)
 {
-    width = width_;
-    height = height_;
+    scale = std::min(std::max(scale_, 1), 4);
 
-    sdlWindow = SDL_CreateWindow("OpenJazz2", 0, 0, width, height, SDL_WINDOW_OPENGL);
-    
-    auto s = new Surface();
-    auto winSurf = SDL_GetWindowSurface(sdlWindow);
-    if (winSurf == nullptr) {
-        std::cout << "Unable to create window surface: " << SDL_GetError() << std::endl;
+    sdlWindow = SDL_CreateWindow("OpenJazz2", 0, 0, width_, height_, SDL_WINDOW_OPENGL);
+    if (sdlWindow == nullptr) {
+        std::cout << "Unable to create window: " << SDL_GetError() << std::endl;
+    }
+
+    if (type == RenderBackendType::Texture)
+    {
+        backend.reset(new TextureBackend(sdlWindow, scale));
+    }
+    else
+    {
+        backend.reset(new SurfaceBackend(sdlWindow, scale));
     }
-    
-    sdlRenderer = SDL_CreateRenderer(sdlWindow, -1, 0);
-    
-    s->__setNativeImplementation(winSurf, sdlRenderer);
-    screen.reset(s);
 }
 
-Surface& GraphicsEngine::Screen()
+void GraphicsEngine::InitializeHeadless(int width_, int height_)
 {
-    return *screen;
+    scale = 1;
+    MemoryScope scope(MemoryCategory::Render);
+    headlessTarget.reset(new Surface(width_, height_, false));
+    backend.reset(new SurfaceBackend(*headlessTarget));
+}
+
+IRenderBackend& GraphicsEngine::Backend()
+{
+    return *backend;
 }
 
 Palette& GraphicsEngine::GetGlobalPalette()
@@ -39,15 +51,28 @@ Palette& GraphicsEngine::GetGlobalPalette()
     return globalPalette;
 }
 
+const FontPtr& GraphicsEngine::GetFont()
+{
+    if (!font)
+    {
+        font = Font::BuiltIn();
+    }
+    return font;
+}
+
+void GraphicsEngine::SetFont(FontPtr f)
+{
+    font = std::move(f);
+}
+
 void GraphicsEngine::BeginFrame()
 {
-    SDL_FillRect((SDL_Surface*)screen->__getNativeImplementation(), NULL, 0x000000);
+    backend->BeginFrame();
 }
 
 void GraphicsEngine::Render()
 {
-//    SDL_Flip((SDL_Surface*)screen->__getNativeImplementation());
-    SDL_UpdateWindowSurface(sdlWindow);
+    backend->Present();
 }
 
 GraphicsEngine::GraphicsEngine()
@@ -57,7 +82,12 @@ GraphicsEngine::GraphicsEngine()
 
 GraphicsEngine::~GraphicsEngine()
 {
-    SDL_FreeSurface((SDL_Surface*)screen->__getNativeImplementation());
-    screen->__setNativeImplementation(nullptr, nullptr);
+    // headless tools (benchmarks) never create the window
+    backend.reset();
+    headlessTarget.reset();
+    if (sdlWindow != nullptr)
+    {
+        SDL_DestroyWindow(sdlWindow);
+    }
     SDL_Quit();
 }
@@ -4,6 +4,8 @@
 #include <memory>
 #include "gfx/Surface.h"
 #include "gfx/Color32.h"
+#include "gfx/Font.h"
+#include "gfx/RenderBackend.h"
 #include <SDL2/SDL.h>
 
 class GraphicsEngine
@@ -11,22 +13,37 @@ class GraphicsEngine
 public:
     static GraphicsEngine& getInstance();
 
-    void InitializeGfxMode(int width_, int height_);
-    Surface& Screen();
+    // the game is drawn at width_ / scale x height_ / scale and upscaled to
+    // the window when presented (scale 1 to 4)
+    void InitializeGfxMode(int width_, int height_, int scale_ = 1,
+                           RenderBackendType type = RenderBackendType::Surface);
+    // no window, frames are drawn into a surface nobody shows (replays)
+    void InitializeHeadless(int width_, int height_);
+    // everything on screen is drawn through it
+    IRenderBackend& Backend();
     Palette& GetGlobalPalette();
+    // text is drawn with the built-in font until another one is set
+    const FontPtr& GetFont();
+    void SetFont(FontPtr f);
     void BeginFrame();
+    // the level layers are composited in 8 bit and resolved through the palette
+    bool IsIndexedMode() const { return indexedMode; }
+    void SetIndexedMode(bool on) { indexedMode = on; }
     void Render();
-    int Width() const { return width; }
-    int Height() const { return height; }
+    // internal resolution
+    int Width() const { return backend->Width(); }
+    int Height() const { return backend->Height(); }
+    int Scale() const { return scale; }
 private:
     static GraphicsEngine       engine;
 
     Palette                     globalPalette;
-    std::unique_ptr<Surface>    screen;
+    FontPtr                     font;
+    std::unique_ptr<IRenderBackend> backend;
+    std::unique_ptr<Surface>    headlessTarget;
     SDL_Window*                 sdlWindow = nullptr;
-    SDL_Renderer*               sdlRenderer = nullptr;
-    int width = 0;
-    int height = 0;
+    int scale = 1;
+    bool indexedMode = false;
 public:
     GraphicsEngine();
     ~GraphicsEngine();
@@ -0,0 +1,117 @@
+#include "IndexedSurface.h"
+
+#include <algorithm>
+#include <cstring>
+#include <assert.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// dst[i] = src[i] unless src[i] is transparent
+inline void CopyRowKeyed(uint8_t* dst, const uint8_t* src, int n)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i keep = _mm_cmpeq_epi8(s, zero);
+        d = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, s));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (src[i] != IndexedSurface::transparent)
+        {
+            dst[i] = src[i];
+        }
+    }
+}
+
+inline void ResolveRow(uint32_t* dst, const uint8_t* src, int n, const uint32_t* palette)
+{
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i idx8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        __m256i idx = _mm256_cvtepu8_epi32(idx8);
+        __m256i c = _mm256_i32gather_epi32(reinterpret_cast<const int*>(palette), idx, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), c);
+    }
+#else
+    for (; i + 4 <= n; i += 4)
+    {
+        dst[i] = palette[src[i]];
+        dst[i + 1] = palette[src[i + 1]];
+        dst[i + 2] = palette[src[i + 2]];
+        dst[i + 3] = palette[src[i + 3]];
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        dst[i] = palette[src[i]];
+    }
+}
+
+}
+
+constexpr uint8_t IndexedSurface::transparent;
+
+NativePalette::NativePalette(const Palette& p, const Surface& target)
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        colors[i] = target.MapColor(p.colors[i]);
+    }
+}
+
+IndexedSurface::IndexedSurface(int width_, int height_)
+    : width(width_)
+    , height(height_)
+    , pixels(width_ * height_, transparent)
+    , memory(MemoryStats::CurrentCategory(), pixels.size())
+{ }
+
+void IndexedSurface::Fill(uint8_t index)
+{
+    std::fill(pixels.begin(), pixels.end(), index);
+}
+
+void IndexedSurface::Draw(const IndexedSurface& s, int x, int y)
+{
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + s.width, width);
+    int y1 = std::min(y + s.height, height);
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    for (int row = y0; row < y1; ++row)
+    {
+        CopyRowKeyed(Row(row) + x0, s.Row(row - y) + (x0 - x), x1 - x0);
+    }
+}
+
+void IndexedSurface::Resolve(const NativePalette& palette, Surface& target) const
+{
+    assert(target.getWidth() >= width && target.getHeight() >= height);
+    int pitch = 0;
+    uint32_t* out = target.LockPixels(pitch);
+    if (out == nullptr)
+    {
+        return;
+    }
+    for (int y = 0; y < height; ++y)
+    {
+        ResolveRow(out + y * pitch, Row(y), width, palette.colors);
+    }
+    target.UnlockPixels();
+}
@@ -0,0 +1,52 @@
+#ifndef INDEXEDSURFACE_H
+#define INDEXEDSURFACE_H
+
+#include "gfx/Surface.h"
+#include "gfx/Color32.h"
+#include "utils/MemoryStats.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Palette converted to the pixel format of a target surface, see
+// IndexedSurface::Resolve(). Rebuilding it is all a palette effect costs.
+struct NativePalette
+{
+    uint32_t colors[256];
+
+    NativePalette(const Palette& p, const Surface& target);
+};
+
+// 8 bit image with colors taken from a palette. Index 0 is transparent
+// when drawn on another indexed surface, as in the JJ2 palettes.
+class IndexedSurface
+{
+public:
+    static constexpr uint8_t transparent = 0;
+
+    IndexedSurface(int width, int height);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    uint8_t* Row(int y) { return &pixels[y * width]; }
+    const uint8_t* Row(int y) const { return &pixels[y * width]; }
+
+    void Fill(uint8_t index);
+    void PutPixel(int x, int y, uint8_t index) { pixels[y * width + x] = index; }
+    // clipped copy, transparent pixels of s are skipped
+    void Draw(const IndexedSurface& s, int x, int y);
+    // converts the whole image to target (same size or larger) through the
+    // palette, with an AVX2 gather when built with it
+    void Resolve(const NativePalette& palette, Surface& target) const;
+private:
+    int                     width;
+    int                     height;
+    std::vector<uint8_t>    pixels;
+    // charged to the scope the surface is made in, as Surface
+    MemoryCharge            memory;
+};
+
+typedef std::shared_ptr<const IndexedSurface> IndexedSurfacePtr;
+
+#endif // INDEXEDSURFACE_H
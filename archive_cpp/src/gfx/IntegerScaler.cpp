@@ -0,0 +1,113 @@
+#include "IntegerScaler.h"
+
+#include <assert.h>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+template <int factor>
+void ScaleRow(uint32_t* dst, const uint32_t* src, int width)
+{
+    int i = 0;
+#ifdef __SSE2__
+    for (; i + 4 <= width; i += 4)
+    {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i* out = reinterpret_cast<__m128i*>(dst + i * factor);
+        switch (factor)
+        {
+        case 2:
+            _mm_storeu_si128(out, _mm_unpacklo_epi32(p, p));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi32(p, p));
+            break;
+        case 3:
+            _mm_storeu_si128(out, _mm_shuffle_epi32(p, _MM_SHUFFLE(1, 0, 0, 0)));
+            _mm_storeu_si128(out + 1, _mm_shuffle_epi32(p, _MM_SHUFFLE(2, 2, 1, 1)));
+            _mm_storeu_si128(out + 2, _mm_shuffle_epi32(p, _MM_SHUFFLE(3, 3, 3, 2)));
+            break;
+        case 4:
+            _mm_storeu_si128(out, _mm_shuffle_epi32(p, _MM_SHUFFLE(0, 0, 0, 0)));
+            _mm_storeu_si128(out + 1, _mm_shuffle_epi32(p, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_storeu_si128(out + 2, _mm_shuffle_epi32(p, _MM_SHUFFLE(2, 2, 2, 2)));
+            _mm_storeu_si128(out + 3, _mm_shuffle_epi32(p, _MM_SHUFFLE(3, 3, 3, 3)));
+            break;
+        }
+    }
+#endif
+    for (; i < width; ++i)
+    {
+        for (int k = 0; k < factor; ++k)
+        {
+            dst[i * factor + k] = src[i];
+        }
+    }
+}
+
+template <int factor>
+void Scale(const uint32_t* src, int srcPitch, int width, int height, uint32_t* dst, int dstPitch)
+{
+    for (int y = 0; y < height; ++y)
+    {
+        uint32_t* first = dst + y * factor * dstPitch;
+        ScaleRow<factor>(first, src + y * srcPitch, width);
+        for (int k = 1; k < factor; ++k)
+        {
+            std::memcpy(first + k * dstPitch, first, width * factor * sizeof(uint32_t));
+        }
+    }
+}
+
+}
+
+void UpscaleInteger(const uint32_t* src, int srcPitch, int width, int height,
+                    uint32_t* dst, int dstPitch, int factor)
+{
+    switch (factor)
+    {
+    case 1:
+        for (int y = 0; y < height; ++y)
+        {
+            std::memcpy(dst + y * dstPitch, src + y * srcPitch, width * sizeof(uint32_t));
+        }
+        break;
+    case 2:
+        Scale<2>(src, srcPitch, width, height, dst, dstPitch);
+        break;
+    case 3:
+        Scale<3>(src, srcPitch, width, height, dst, dstPitch);
+        break;
+    case 4:
+        Scale<4>(src, srcPitch, width, height, dst, dstPitch);
+        break;
+    default:
+        assert(false && "unsupported scale factor");
+        break;
+    }
+}
+
+void UpscaleInteger(Surface& src, Surface& dst, int factor, int x, int y)
+{
+    assert(x >= 0 && y >= 0);
+    assert(x + src.getWidth() * factor <= dst.getWidth() && y + src.getHeight() * factor <= dst.getHeight());
+    int srcPitch = 0;
+    int dstPitch = 0;
+    const uint32_t* in = src.LockPixels(srcPitch);
+    uint32_t* out = dst.LockPixels(dstPitch);
+    if (in != nullptr && out != nullptr)
+    {
+        UpscaleInteger(in, srcPitch, src.getWidth(), src.getHeight(),
+                       out + y * dstPitch + x, dstPitch, factor);
+    }
+    if (out != nullptr)
+    {
+        dst.UnlockPixels();
+    }
+    if (in != nullptr)
+    {
+        src.UnlockPixels();
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef INTEGERSCALER_H
+#define INTEGERSCALER_H
+
+#include "gfx/Surface.h"
+
+#include <cstdint>
+
+// Nearest neighbour upscaling by a whole factor (1 to 4): every source pixel
+// becomes a factor x factor block. Each output row is built once with SSE2
+// and copied for the remaining factor - 1 rows. Pitches are in pixels.
+void UpscaleInteger(const uint32_t* src, int srcPitch, int width, int height,
+                    uint32_t* dst, int dstPitch, int factor);
+
+// scales the whole of src into dst at (x, y), dst has to be large enough;
+// both surfaces need the same 32 bit pixel format
+void UpscaleInteger(Surface& src, Surface& dst, int factor, int x, int y);
+
+#endif // INTEGERSCALER_H
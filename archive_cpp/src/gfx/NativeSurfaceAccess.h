@@ -0,0 +1,28 @@
+#ifndef NATIVESURFACEACCESS_H
+#define NATIVESURFACEACCESS_H
+
+#include "gfx/Surface.h"
+
+#include <SDL2/SDL.h>
+
+// The SDL surface behind a Surface, reachable by the render backends only:
+// they wrap the window in a Surface, clear it and make textures from it.
+// Everything else draws through Surface and IRenderBackend.
+class NativeSurfaceAccess
+{
+    friend class SurfaceBackend;
+    friend class TextureBackend;
+
+    static SDL_Surface* Get(const Surface& s)
+    {
+        return static_cast<SDL_Surface*>(const_cast<Surface&>(s).__getNativeImplementation());
+    }
+
+    // s frees native when it is destroyed, unless it is set to nullptr first
+    static void Set(Surface& s, SDL_Surface* native)
+    {
+        s.__setNativeImplementation(native);
+    }
+};
+
+#endif // NATIVESURFACEACCESS_H
@@ -0,0 +1,24 @@
+#include "RenderBackend.h"
+
+bool ParseRenderBackendType(const std::string& name, RenderBackendType& type)
+{
+    if (name == "surface")
+    {
+        type = RenderBackendType::Surface;
+        return true;
+    }
+    if (name == "texture")
+    {
+        type = RenderBackendType::Texture;
+        return true;
+    }
+    return false;
+}
+
+void IRenderBackend::DrawText(const TextRun& text, int x, int y)
+{
+    if (text.GetSurface() != nullptr)
+    {
+        Draw(*text.GetSurface(), x, y);
+    }
+}
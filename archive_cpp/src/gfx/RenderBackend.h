@@ -0,0 +1,46 @@
+#ifndef RENDERBACKEND_H
+#define RENDERBACKEND_H
+
+#include "gfx/Surface.h"
+#include "gfx/Color32.h"
+#include "gfx/TextRun.h"
+
+#include <string>
+
+enum class RenderBackendType
+{
+    Surface,    // SDL_BlitSurface into the window surface
+    Texture     // SDL_Renderer with a texture per surface
+};
+
+// parses "surface" / "texture", returns false for anything else
+bool ParseRenderBackendType(const std::string& name, RenderBackendType& type);
+
+// Where a frame is drawn. Surfaces are the images of the game; a backend
+// may keep its own copy of them (a texture), made on first draw and again
+// whenever Surface::GetContentId() changes. Coordinates are in the
+// internal resolution, Width() x Height().
+class IRenderBackend
+{
+public:
+    virtual ~IRenderBackend() { }
+
+    virtual const char* GetName() const = 0;
+    virtual int Width() const = 0;
+    virtual int Height() const = 0;
+    // starts a frame with a black screen
+    virtual void BeginFrame() = 0;
+    // makes the copy of s ahead of the first draw (loading screens)
+    virtual void Prepare(const Surface& s) = 0;
+    virtual void Draw(const Surface& s, int x, int y) = 0;
+    // s flipped horizontally
+    virtual void DrawMirrored(const Surface& s, int x, int y) = 0;
+    virtual void DrawText(const TextRun& text, int x, int y);
+    virtual void PutPixel(int x, int y, const Color32& c) = 0;
+    // the surface being drawn to, for code writing pixels directly; nullptr
+    // if the frame is not in memory
+    virtual Surface* GetTargetSurface() = 0;
+    virtual void Present() = 0;
+};
+
+#endif // RENDERBACKEND_H
@@ -0,0 +1,139 @@
+#include "RenderQueue.h"
+#include "SurfaceBackend.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace {
+
+inline bool FitsInt16(int v)
+{
+    return v >= std::numeric_limits<int16_t>::min() && v <= std::numeric_limits<int16_t>::max();
+}
+
+}
+
+void RenderQueue::Begin(const Rectangle2D& v)
+{
+    view = v;
+    commands.clear();
+    frame = RenderStats();
+}
+
+bool RenderQueue::IsVisible(const Rectangle2D& r) const
+{
+    return r.x < view.x + view.w && view.x < r.x + r.w
+        && r.y < view.y + view.h && view.y < r.y + r.h;
+}
+
+void RenderQueue::PushSprite(uint8_t depth, const Surface& s, int x, int y)
+{
+    ++frame.submitted;
+    if (!IsVisible({x, y, s.getWidth(), s.getHeight()}))
+    {
+        ++frame.culled;
+        return;
+    }
+    Push(depth, CommandKind::Sprite, &s, x, y, Color32());
+}
+
+void RenderQueue::PushSpriteMirrored(uint8_t depth, const Surface& s, int x, int y)
+{
+    ++frame.submitted;
+    if (!IsVisible({x, y, s.getWidth(), s.getHeight()}))
+    {
+        ++frame.culled;
+        return;
+    }
+    Push(depth, CommandKind::MirroredSprite, &s, x, y, Color32());
+}
+
+void RenderQueue::PushText(uint8_t depth, const TextRun& text, int x, int y)
+{
+    if (text.GetSurface() != nullptr)
+    {
+        PushSprite(depth, *text.GetSurface(), x, y);
+    }
+}
+
+void RenderQueue::PushPixel(uint8_t depth, int x, int y, const Color32& c)
+{
+    ++frame.submitted;
+    if (!IsVisible({x, y, 1, 1}))
+    {
+        ++frame.culled;
+        return;
+    }
+    Push(depth, CommandKind::Pixel, nullptr, x, y, c);
+}
+
+void RenderQueue::Submit(Surface& target)
+{
+    SurfaceBackend backend(target);
+    Submit(backend);
+}
+
+void RenderQueue::Submit(IRenderBackend& target)
+{
+    std::sort(commands.begin(), commands.end(), [](const DrawCommand& a, const DrawCommand& b)
+    {
+        if (a.depth != b.depth)
+        {
+            return a.depth < b.depth;
+        }
+        if (a.kind != b.kind)
+        {
+            return a.kind < b.kind;
+        }
+        if (a.source != b.source)
+        {
+            return std::less<const Surface*>()(a.source, b.source);
+        }
+        return a.order < b.order;
+    });
+
+    const DrawCommand* previous = nullptr;
+    for (const auto& c : commands)
+    {
+        if (previous == nullptr || previous->depth != c.depth || previous->source != c.source)
+        {
+            ++frame.batches;
+        }
+        previous = &c;
+        switch (c.kind)
+        {
+        case CommandKind::Sprite:
+            target.Draw(*c.source, c.x, c.y);
+            break;
+        case CommandKind::MirroredSprite:
+            target.DrawMirrored(*c.source, c.x, c.y);
+            break;
+        case CommandKind::Pixel:
+            target.PutPixel(c.x, c.y, c.color);
+            break;
+        }
+        ++frame.drawCalls;
+    }
+    stats = frame;
+    commands.clear();
+}
+
+void RenderQueue::Push(uint8_t depth, CommandKind kind, const Surface* source, int x, int y, const Color32& c)
+{
+    // visible commands are near the view, anything else is a bogus position
+    if (!FitsInt16(x) || !FitsInt16(y))
+    {
+        ++frame.culled;
+        return;
+    }
+    DrawCommand cmd;
+    cmd.source = source;
+    cmd.x = static_cast<int16_t>(x);
+    cmd.y = static_cast<int16_t>(y);
+    cmd.order = static_cast<uint32_t>(commands.size());
+    cmd.color = c;
+    cmd.depth = depth;
+    cmd.kind = kind;
+    commands.push_back(cmd);
+}
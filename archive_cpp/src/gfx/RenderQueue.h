@@ -0,0 +1,74 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include "gfx/RenderBackend.h"
+#include "gfx/Surface.h"
+#include "gfx/Color32.h"
+#include "gfx/TextRun.h"
+#include "utils/Utils.h"
+
+#include <cstdint>
+#include <vector>
+
+struct RenderStats
+{
+    int submitted = 0;      // commands pushed this frame
+    int culled = 0;         // rejected against the view
+    int drawCalls = 0;      // blits and pixels issued
+    int batches = 0;        // runs of commands sharing depth and source surface
+};
+
+// Draw list for one frame. Producers (layers, events, hero, ...) push draw
+// commands in screen coordinates; anything outside of the view is dropped
+// right away. Submit() sorts the commands by depth and then by source
+// surface, so consecutive draws read the same image, and issues them in
+// one pass. Lower depth is drawn first, the order of commands with equal
+// depth and source is kept.
+class RenderQueue
+{
+public:
+    // starts a new frame, view is the target area in screen coordinates
+    void Begin(const Rectangle2D& view);
+    const Rectangle2D& GetView() const { return view; }
+    bool IsVisible(const Rectangle2D& r) const;
+
+    void PushSprite(uint8_t depth, const Surface& s, int x, int y);
+    // s flipped horizontally, see Surface::DrawMirrored()
+    void PushSpriteMirrored(uint8_t depth, const Surface& s, int x, int y);
+    // the run must stay alive until Submit()
+    void PushText(uint8_t depth, const TextRun& text, int x, int y);
+    void PushPixel(uint8_t depth, int x, int y, const Color32& c);
+
+    void Submit(IRenderBackend& target);
+    // draws with a SurfaceBackend on target
+    void Submit(Surface& target);
+    // counters of the last submitted frame
+    const RenderStats& GetStats() const { return stats; }
+private:
+    enum class CommandKind : uint8_t
+    {
+        Sprite,
+        MirroredSprite,
+        Pixel
+    };
+
+    struct DrawCommand
+    {
+        const Surface*  source;     // nullptr for pixels
+        int16_t         x;
+        int16_t         y;
+        uint32_t        order;      // push order, keeps the sort stable
+        Color32         color;
+        uint8_t         depth;
+        CommandKind     kind;
+    };
+
+    Rectangle2D                 view = {0, 0, 0, 0};
+    std::vector<DrawCommand>    commands;
+    RenderStats                 stats;
+    RenderStats                 frame;
+
+    void Push(uint8_t depth, CommandKind kind, const Surface* source, int x, int y, const Color32& c);
+};
+
+#endif // RENDERQUEUE_H
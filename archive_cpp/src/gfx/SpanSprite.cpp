@@ -0,0 +1,185 @@
+#include "SpanSprite.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr int padding = 16;
+
+#ifdef __SSE2__
+// the first n lanes of s over dst, transparent ones skipped
+inline void BlendSpan(uint8_t* dst, __m128i s, int n)
+{
+    const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i take = _mm_cmplt_epi8(lanes, _mm_set1_epi8(static_cast<char>(std::min(n, 16))));
+    take = _mm_andnot_si128(_mm_cmpeq_epi8(s, _mm_setzero_si128()), take);
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+    d = _mm_or_si128(_mm_and_si128(take, s), _mm_andnot_si128(take, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), d);
+}
+
+inline __m128i Reverse(__m128i v)
+{
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+#endif
+
+// dst[i] = src[i * step] unless that is transparent
+inline void CopySpan(uint8_t* dst, const uint8_t* src, int n, int step)
+{
+    for (int i = 0; i < n; ++i, src += step)
+    {
+        if (*src != IndexedSurface::transparent)
+        {
+            dst[i] = *src;
+        }
+    }
+}
+
+}
+
+constexpr int SpanSprite::maxSpansPerRow;
+
+SpanSprite::SpanSprite(const IndexedSurface& s)
+    : width(s.getWidth())
+    , height(s.getHeight())
+    , pixels(padding, IndexedSurface::transparent)
+{
+    rowStart.reserve(height + 1);
+    for (int y = 0; y < height; ++y)
+    {
+        AddRow(s.Row(y));
+    }
+    Finish();
+}
+
+void SpanSprite::AddRow(const uint8_t* row)
+{
+    rowStart.push_back(static_cast<uint32_t>(spans.size()));
+    for (int x = 0; x < width;)
+    {
+        if (row[x] == IndexedSurface::transparent)
+        {
+            ++x;
+            continue;
+        }
+        int end = x + 1;
+        while (end < width && row[end] != IndexedSurface::transparent)
+        {
+            ++end;
+        }
+        spans.push_back({static_cast<int16_t>(x), static_cast<int16_t>(end - x),
+                         static_cast<uint32_t>(pixels.size())});
+        pixels.insert(pixels.end(), row + x, row + end);
+        x = end;
+    }
+}
+
+void SpanSprite::Finish()
+{
+    while (static_cast<int>(rowStart.size()) <= height)
+    {
+        rowStart.push_back(static_cast<uint32_t>(spans.size()));
+    }
+    opaqueCount = static_cast<int>(pixels.size()) - padding;
+
+    std::vector<Span> merged;
+    std::vector<uint8_t> mergedPixels(padding, IndexedSurface::transparent);
+    merged.reserve(spans.size());
+    mergedPixels.reserve(pixels.size() + padding);
+    uint32_t start = 0;
+    for (int y = 0; y < height; ++y)
+    {
+        const uint32_t first = rowStart[y];
+        const uint32_t last = rowStart[y + 1];
+        rowStart[y] = start;
+        if (last - first > static_cast<uint32_t>(maxSpansPerRow))
+        {
+            const int x0 = spans[first].x;
+            const int x1 = spans[last - 1].x + spans[last - 1].length;
+            const size_t offset = mergedPixels.size();
+            mergedPixels.resize(offset + (x1 - x0), IndexedSurface::transparent);
+            for (uint32_t i = first; i < last; ++i)
+            {
+                std::memcpy(&mergedPixels[offset + spans[i].x - x0], &pixels[spans[i].offset], spans[i].length);
+            }
+            merged.push_back({static_cast<int16_t>(x0), static_cast<int16_t>(x1 - x0),
+                              static_cast<uint32_t>(offset)});
+        }
+        else
+        {
+            for (uint32_t i = first; i < last; ++i)
+            {
+                Span s = spans[i];
+                s.offset = static_cast<uint32_t>(mergedPixels.size());
+                mergedPixels.insert(mergedPixels.end(), &pixels[spans[i].offset],
+                                    &pixels[spans[i].offset] + spans[i].length);
+                merged.push_back(s);
+            }
+        }
+        start = static_cast<uint32_t>(merged.size());
+    }
+    rowStart[height] = start;
+    mergedPixels.resize(mergedPixels.size() + padding, IndexedSurface::transparent);
+    spans.swap(merged);
+    pixels.swap(mergedPixels);
+    spans.shrink_to_fit();
+    pixels.shrink_to_fit();
+    memory.Set(MemoryStats::CurrentCategory(),
+               HeapBytes(rowStart) + HeapBytes(spans) + HeapBytes(pixels));
+}
+
+void SpanSprite::Draw(IndexedSurface& target, int x, int y, bool flipped) const
+{
+    const int y0 = std::max(0, -y);
+    const int y1 = std::min(height, target.getHeight() - y);
+    const int targetWidth = target.getWidth();
+    for (int row = y0; row < y1; ++row)
+    {
+        uint8_t* out = target.Row(row + y);
+        // 16 pixel stores may run into the next row, where they change
+        // nothing, but not past the last one
+        const int wideEnd = row + y + 1 < target.getHeight() ? targetWidth : targetWidth - 15;
+        for (uint32_t i = rowStart[row]; i < rowStart[row + 1]; ++i)
+        {
+            const Span& span = spans[i];
+            const uint8_t* src = &pixels[span.offset];
+            const int left = x + (flipped ? width - span.x - span.length : span.x);
+            const int l = std::max(left, 0);
+            const int r = std::min(left + span.length, targetWidth);
+            if (l >= r)
+            {
+                continue;
+            }
+            // flipped, the last pixel of the span goes leftmost
+            const uint8_t* first = flipped ? src + span.length - 1 - (l - left) : src + (l - left);
+#ifdef __SSE2__
+            if (r <= wideEnd)
+            {
+                for (int p = l; p < r; p += 16)
+                {
+                    if (!flipped)
+                    {
+                        BlendSpan(out + p, _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + (p - l))),
+                                  r - p);
+                    }
+                    else
+                    {
+                        const uint8_t* s = first - (p - l) - 15;
+                        BlendSpan(out + p, Reverse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s))), r - p);
+                    }
+                }
+                continue;
+            }
+#endif
+            CopySpan(out + l, first, r - l, flipped ? -1 : 1);
+        }
+    }
+}
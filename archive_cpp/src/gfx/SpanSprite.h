@@ -0,0 +1,60 @@
+#ifndef SPANSPRITE_H
+#define SPANSPRITE_H
+
+#include "gfx/IndexedSurface.h"
+#include "utils/MemoryStats.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 8 bit sprite kept as its opaque runs: per row the spans of pixels that
+// are not transparent, and those pixels back to back. Drawing copies the
+// spans, 16 pixels at a time with SSE2, and skips the transparent parts of
+// a sprite, so a sparse sprite costs about what its opaque pixels cost. A
+// row of more than maxSpansPerRow spans is kept as one span from its first
+// to its last opaque pixel instead, transparent pixels included and
+// skipped when copied, which is cheaper than many short copies. Made from
+// an IndexedSurface, see Jazz2AnimFormat::GetSpanSprites for J2A frames.
+class SpanSprite
+{
+public:
+    static constexpr int maxSpansPerRow = 2;
+
+    struct Span
+    {
+        int16_t     x;
+        int16_t     length;
+        uint32_t    offset;     // of the first pixel in pixels
+    };
+
+    explicit SpanSprite(const IndexedSurface& s);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int GetOpaquePixelCount() const { return opaqueCount; }
+    int GetSpanCount() const { return static_cast<int>(spans.size()); }
+
+    // clipped to target, flipped mirrors the sprite horizontally
+    void Draw(IndexedSurface& target, int x, int y, bool flipped = false) const;
+private:
+    // appends the next row, split at its transparent pixels
+    void AddRow(const uint8_t* row);
+    // merges the rows of many spans
+    void Finish();
+
+    int                     width;
+    int                     height;
+    // spans of row y are spans[rowStart[y]] up to spans[rowStart[y + 1]]
+    std::vector<uint32_t>   rowStart;
+    std::vector<Span>       spans;
+    // with padding before and after, so 16 pixel loads stay inside
+    std::vector<uint8_t>    pixels;
+    int                     opaqueCount = 0;
+    // charged to the scope the sprite is made in, as IndexedSurface
+    MemoryCharge            memory;
+};
+
+typedef std::shared_ptr<const SpanSprite> SpanSpritePtr;
+
+#endif // SPANSPRITE_H
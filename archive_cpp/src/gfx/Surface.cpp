@@ -3,15 +3,110 @@
 #include <assert.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL2_rotozoom.h>
-#include <SDL2/SDL2_gfxPrimitives.h>
+#include <atomic>
 #include "Surface.h"
+#include "utils/MemoryStats.h"
+
+namespace {
+
+uint64_t NextContentId()
+{
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+}
 
 struct NativeSurface
 {
     SDL_Surface* sdl_struct = nullptr;
-    SDL_Renderer* renderer = nullptr;
+    uint64_t contentId = NextContentId();
+    // the pixels, charged to the scope the surface is made in
+    MemoryCharge memory;
+
+    void Set(SDL_Surface* s)
+    {
+        sdl_struct = s;
+        memory.Set(MemoryStats::CurrentCategory(), s != nullptr ? static_cast<size_t>(s->pitch) * s->h : 0);
+    }
+};
+
+namespace {
+
+// 8 bit channels of a 32 bit pixel format
+struct Channels
+{
+    int r, g, b, a;
+    Uint32 amask;
+
+    explicit Channels(const SDL_PixelFormat* f)
+        : r(f->Rshift), g(f->Gshift), b(f->Bshift), a(f->Ashift), amask(f->Amask)
+    { }
+
+    static bool Fits(const SDL_PixelFormat* f)
+    {
+        return f->BytesPerPixel == 4 && f->Rloss == 0 && f->Gloss == 0 && f->Bloss == 0
+            && (f->Amask == 0 || f->Aloss == 0);
+    }
 };
 
+inline Uint32 Channel(Uint32 p, int shift)
+{
+    return (p >> shift) & 0xff;
+}
+
+inline Uint32 Blend(Uint32 s, Uint32 d, Uint32 a)
+{
+    return (s * a + d * (255 - a)) / 255;
+}
+
+// one row of DrawMirrored(): src is read from its last pixel backwards
+void BlitRowMirrored(Uint32* dst, const Uint32* src, int n, const Channels& dc, const Channels& sc,
+                     bool blend, bool keyed, Uint32 key)
+{
+    // opaque pixels are copied when the color channels are in the same place
+    bool sameColors = dc.r == sc.r && dc.g == sc.g && dc.b == sc.b;
+    Uint32 colors = (0xffu << sc.r) | (0xffu << sc.g) | (0xffu << sc.b);
+    Uint32 opaque = dc.amask;
+    for (int i = 0; i < n; ++i)
+    {
+        Uint32 p = *(src - i);
+        if (keyed && p == key)
+        {
+            continue;
+        }
+        Uint32 a = (blend && sc.amask != 0) ? Channel(p, sc.a) : 255;
+        if (a == 0)
+        {
+            continue;
+        }
+        if (a == 255 && sameColors && (blend || sc.amask == 0))
+        {
+            dst[i] = (p & colors) | opaque;
+            continue;
+        }
+        Uint32 r = Channel(p, sc.r);
+        Uint32 g = Channel(p, sc.g);
+        Uint32 b = Channel(p, sc.b);
+        Uint32 da = 255;
+        if (a != 255)
+        {
+            Uint32 d = dst[i];
+            r = Blend(r, Channel(d, dc.r), a);
+            g = Blend(g, Channel(d, dc.g), a);
+            b = Blend(b, Channel(d, dc.b), a);
+            da = dc.amask != 0 ? a + Channel(d, dc.a) * (255 - a) / 255 : 255;
+        }
+        else if (!blend && sc.amask != 0)
+        {
+            da = Channel(p, sc.a);
+        }
+        dst[i] = (r << dc.r) | (g << dc.g) | (b << dc.b) | (dc.amask != 0 ? da << dc.a : 0);
+    }
+}
+
+}
+
 Surface::Surface()
     : surface(new NativeSurface)
 { }
@@ -40,7 +135,7 @@ Surface::Surface(int width, int height, bool useAlpha)
         amask = 0;
     }
 
-    surface->sdl_struct = SDL_CreateRGBSurface(0, width, height, 32, rmask, gmask, bmask, amask);
+    surface->Set(SDL_CreateRGBSurface(0, width, height, 32, rmask, gmask, bmask, amask));
 }
 
 Surface::Surface(Surface&& s) noexcept
@@ -58,7 +153,7 @@ Surface::Surface(const std::string& filename)
     {
         throw std::runtime_error("Surface ctor: SDL_DisplayFormat returned null pointer.");
     }
-    surface->sdl_struct = s_native;
+    surface->Set(s_native);
 }
 
 void Surface::swap(Surface& s) noexcept
@@ -79,11 +174,11 @@ Surface Surface::Copy(const SurfaceCopyEffects& effects) const
     double hFlipFactor = effects.flipHorizontally ? -1.0 : 1.0;
     double vFlipFactor = effects.flipVertically ? -1.0 : 1.0;
     Surface s;
-    s.surface->sdl_struct = rotozoomSurfaceXY(const_cast<SDL_Surface*>(this->surface->sdl_struct),
-                                effects.rotationAngle,
-                                effects.widthFactor * vFlipFactor,
-                                effects.heightFactor * hFlipFactor,
-                                SMOOTHING_ON);
+    s.surface->Set(rotozoomSurfaceXY(const_cast<SDL_Surface*>(this->surface->sdl_struct),
+                                     effects.rotationAngle,
+                                     effects.widthFactor * vFlipFactor,
+                                     effects.heightFactor * hFlipFactor,
+                                     SMOOTHING_ON));
     //s.surface->sdl_struct = SDL_DisplayFormatAlpha(const_cast<SDL_Surface*>(this->surface->sdl_struct));
     return s;
 }
@@ -98,11 +193,30 @@ int Surface::getHeight() const
     return surface->sdl_struct->h;
 }
 
+uint64_t Surface::GetContentId() const
+{
+    return surface->contentId;
+}
+
+void Surface::Touch()
+{
+    surface->contentId = NextContentId();
+}
+
 void Surface::MakeTransparent(int r, int g, int b)
 {
     assert(surface->sdl_struct != nullptr);
     SDL_SetColorKey(surface->sdl_struct, SDL_TRUE,
                     SDL_MapRGB(surface->sdl_struct->format, r, g, b));
+    Touch();
+}
+
+void Surface::SetColorMod(const Color32& c)
+{
+    assert(surface->sdl_struct != nullptr);
+    SDL_SetSurfaceColorMod(surface->sdl_struct, c.GetR(), c.GetG(), c.GetB());
+    SDL_SetSurfaceAlphaMod(surface->sdl_struct, c.GetA());
+    Touch();
 }
 
 void Surface::Draw(const Surface& s, int x, int y)
@@ -115,6 +229,7 @@ void Surface::Draw(const Surface& s, int x, int y)
     dest.y = y;
 
     SDL_BlitSurface(surfSrc, NULL, surface->sdl_struct, &dest);
+    Touch();
 }
 
 void Surface::Draw(const Surface& s, const Point2D& p)
@@ -138,6 +253,61 @@ void Surface::Draw(const Surface& s, int x, int y, int src_x, int src_y, int src
     src.h = src_h;
 
     SDL_BlitSurface(surfDest, &src, surface->sdl_struct, &dest);
+    Touch();
+}
+
+void Surface::DrawMirrored(const Surface& s, int x, int y)
+{
+    SDL_Surface* src = const_cast<SDL_Surface*>(s.surface->sdl_struct);
+    SDL_Surface* dst = surface->sdl_struct;
+    assert(src != nullptr);
+
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + src->w, dst->w);
+    int y1 = std::min(y + src->h, dst->h);
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+    Touch();
+
+    Uint8 r, g, b, a;
+    SDL_GetSurfaceColorMod(src, &r, &g, &b);
+    SDL_GetSurfaceAlphaMod(src, &a);
+    SDL_BlendMode mode;
+    SDL_GetSurfaceBlendMode(src, &mode);
+    bool modulated = (r & g & b & a) != 255;
+    if (modulated || !Channels::Fits(src->format) || !Channels::Fits(dst->format)
+        || (mode != SDL_BLENDMODE_BLEND && mode != SDL_BLENDMODE_NONE))
+    {
+        // anything unusual goes through SDL, one column at a time
+        for (int column = x0; column < x1; ++column)
+        {
+            SDL_Rect srcRect = {src->w - 1 - (column - x), y0 - y, 1, y1 - y0};
+            SDL_Rect dest = {column, y0, 1, y1 - y0};
+            SDL_BlitSurface(src, &srcRect, dst, &dest);
+        }
+        return;
+    }
+
+    Uint32 key = 0;
+    bool keyed = SDL_GetColorKey(src, &key) == 0;
+    Channels sc(src->format);
+    Channels dc(dst->format);
+    SDL_LockSurface(src);
+    SDL_LockSurface(dst);
+    for (int row = y0; row < y1; ++row)
+    {
+        const Uint32* srcRow = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(src->pixels)
+                                                               + (row - y) * src->pitch);
+        Uint32* dstRow = reinterpret_cast<Uint32*>(static_cast<Uint8*>(dst->pixels) + row * dst->pitch);
+        // destination column x0 shows source column w - 1 - (x0 - x)
+        BlitRowMirrored(dstRow + x0, srcRow + src->w - 1 - (x0 - x), x1 - x0, dc, sc,
+                        mode == SDL_BLENDMODE_BLEND, keyed, key);
+    }
+    SDL_UnlockSurface(dst);
+    SDL_UnlockSurface(src);
 }
 
 void Surface::PutPixel(int x, int y, const Color32& color)
@@ -145,11 +315,30 @@ void Surface::PutPixel(int x, int y, const Color32& color)
     Uint32* pixels = (Uint32 *)surface->sdl_struct->pixels;
     Uint32 c = SDL_MapRGBA(surface->sdl_struct->format, color.GetR(), color.GetG(), color.GetB(), color.GetA());
     pixels[( y * surface->sdl_struct->w ) + x] = c;
+    Touch();
+}
+
+uint32_t Surface::MapColor(const Color32& color) const
+{
+    return SDL_MapRGBA(surface->sdl_struct->format, color.GetR(), color.GetG(), color.GetB(), color.GetA());
+}
+
+uint32_t* Surface::LockPixels(int& pitch)
+{
+    SDL_Surface* s = surface->sdl_struct;
+    if (s->format->BytesPerPixel != 4 || SDL_LockSurface(s) != 0)
+    {
+        return nullptr;
+    }
+    pitch = s->pitch / 4;
+    // the caller may write anything
+    Touch();
+    return static_cast<uint32_t*>(s->pixels);
 }
 
-void Surface::WriteText(const std::string& message, int x, int y, const Color32& c)
+void Surface::UnlockPixels()
 {
-    stringRGBA(surface->renderer, x, y, message.c_str(), c.GetR(), c.GetG(), c.GetB(), c.GetA());
+    SDL_UnlockSurface(surface->sdl_struct);
 }
 
 void* Surface::__getNativeImplementation()
@@ -157,8 +346,8 @@ void* Surface::__getNativeImplementation()
     return surface->sdl_struct;
 }
 
-void Surface::__setNativeImplementation(void* native, void* rend)
+void Surface::__setNativeImplementation(void* native)
 {
-    surface->sdl_struct = static_cast<SDL_Surface*>(native);
-    surface->renderer = static_cast<SDL_Renderer*>(rend);
+    surface->Set(static_cast<SDL_Surface*>(native));
+    Touch();
 }
@@ -1,6 +1,7 @@
 #ifndef SURFACE_H
 #define SURFACE_H
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include "gfx/Color32.h"
@@ -33,19 +34,34 @@ public:
 
     int getWidth() const;
     int getHeight() const;
+    // unique for every surface and changed by every modification, render
+    // backends use it to know when their copy (texture) is stale
+    uint64_t GetContentId() const;
 
     void MakeTransparent(int r, int g, int b);
+    // color and alpha this surface is multiplied by when drawn
+    void SetColorMod(const Color32& c);
     // Draw given surface on the current
     void Draw(const Surface& s, int x, int y);
     void Draw(const Surface& s, const Point2D& p);
     void Draw(const Surface& s, int x, int y, int src_x, int src_y, int src_w, int src_h);
+    // draws s flipped horizontally, reading its rows backwards; the pixels
+    // are exactly the ones of Draw(), only mirrored
+    void DrawMirrored(const Surface& s, int x, int y);
 
     void PutPixel(int x, int y, const Color32& color);
-    void WriteText(const std::string& message, int x, int y, const Color32& c);
+    // color in the pixel format of this surface
+    uint32_t MapColor(const Color32& color) const;
+    // direct access to the 32 bit pixels, pitch is in pixels; returns
+    // nullptr if the surface cannot be locked or is not 32 bit
+    uint32_t* LockPixels(int& pitch);
+    void UnlockPixels();
 private:
-    friend class GraphicsEngine;
+    // the render backends get at the SDL surface through it
+    friend class NativeSurfaceAccess;
     void* __getNativeImplementation();
-    void __setNativeImplementation(void* native, void* rend);
+    void __setNativeImplementation(void* native);
+    void Touch();
     std::unique_ptr<NativeSurface>    surface;
 };
 
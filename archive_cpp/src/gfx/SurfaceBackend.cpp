@@ -0,0 +1,76 @@
+#include "SurfaceBackend.h"
+#include "IntegerScaler.h"
+#include "NativeSurfaceAccess.h"
+#include "utils/MemoryStats.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <SDL2/SDL.h>
+
+SurfaceBackend::SurfaceBackend(Surface& target_)
+    : target(&target_)
+{ }
+
+SurfaceBackend::SurfaceBackend(SDL_Window* window_, int scale_)
+    : window(window_)
+    , windowSurface(new Surface())
+    , scale(std::min(std::max(scale_, 1), 4))
+{
+    MemoryScope scope(MemoryCategory::Render);
+    SDL_Surface* winSurf = SDL_GetWindowSurface(window);
+    if (winSurf == nullptr)
+    {
+        throw std::runtime_error(std::string("Unable to get the window surface: ") + SDL_GetError());
+    }
+    NativeSurfaceAccess::Set(*windowSurface, winSurf);
+    target = windowSurface.get();
+    if (scale == 1 || winSurf->format->BytesPerPixel != 4)
+    {
+        scale = 1;
+        return;
+    }
+    // internal framebuffer in the pixel format of the window, so presenting
+    // it is a plain upscale
+    const SDL_PixelFormat* f = winSurf->format;
+    framebuffer.reset(new Surface());
+    NativeSurfaceAccess::Set(*framebuffer, SDL_CreateRGBSurface(0, winSurf->w / scale, winSurf->h / scale, 32,
+                                                                f->Rmask, f->Gmask, f->Bmask, f->Amask));
+    target = framebuffer.get();
+}
+
+SurfaceBackend::~SurfaceBackend()
+{
+    if (windowSurface)
+    {
+        NativeSurfaceAccess::Set(*windowSurface, nullptr);
+    }
+}
+
+void SurfaceBackend::BeginFrame()
+{
+    SDL_FillRect(NativeSurfaceAccess::Get(*target), NULL, 0x000000);
+}
+
+void SurfaceBackend::PutPixel(int x, int y, const Color32& c)
+{
+    if (x >= 0 && y >= 0 && x < target->getWidth() && y < target->getHeight())
+    {
+        target->PutPixel(x, y, c);
+    }
+}
+
+void SurfaceBackend::Present()
+{
+    if (window == nullptr)
+    {
+        return;
+    }
+    if (framebuffer)
+    {
+        // centered, the border left by the division stays black
+        int x = (windowSurface->getWidth() - framebuffer->getWidth() * scale) / 2;
+        int y = (windowSurface->getHeight() - framebuffer->getHeight() * scale) / 2;
+        UpscaleInteger(*framebuffer, *windowSurface, scale, x, y);
+    }
+    SDL_UpdateWindowSurface(window);
+}
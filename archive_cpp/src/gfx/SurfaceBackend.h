@@ -0,0 +1,41 @@
+#ifndef SURFACEBACKEND_H
+#define SURFACEBACKEND_H
+
+#include "gfx/RenderBackend.h"
+
+#include <memory>
+
+struct SDL_Window;
+
+// Software blitting into a surface. With a window the frame is presented
+// with SDL_UpdateWindowSurface, upscaled by scale when the target is an
+// internal framebuffer; without one Present() does nothing (headless).
+class SurfaceBackend : public IRenderBackend
+{
+public:
+    explicit SurfaceBackend(Surface& target);
+    // the backend draws to the window surface when scale is 1 and to an
+    // internal framebuffer of its size / scale otherwise
+    SurfaceBackend(SDL_Window* window, int scale);
+    ~SurfaceBackend();
+
+    virtual const char* GetName() const override { return "surface"; }
+    virtual int Width() const override { return target->getWidth(); }
+    virtual int Height() const override { return target->getHeight(); }
+    virtual void BeginFrame() override;
+    virtual void Prepare(const Surface&) override { }
+    virtual void Draw(const Surface& s, int x, int y) override { target->Draw(s, x, y); }
+    virtual void DrawMirrored(const Surface& s, int x, int y) override { target->DrawMirrored(s, x, y); }
+    virtual void PutPixel(int x, int y, const Color32& c) override;
+    virtual Surface* GetTargetSurface() override { return target; }
+    virtual void Present() override;
+private:
+    Surface*                    target;
+    SDL_Window*                 window = nullptr;
+    // wraps the window surface, which SDL owns
+    std::unique_ptr<Surface>    windowSurface;
+    std::unique_ptr<Surface>    framebuffer;
+    int                         scale = 1;
+};
+
+#endif // SURFACEBACKEND_H
@@ -0,0 +1,42 @@
+#include "TextRun.h"
+
+#include "gfx/GraphicsEngine.h"
+#include "utils/MemoryStats.h"
+
+void TextRun::Set(const std::string& t, const Color32& c)
+{
+    const FontPtr& current = GraphicsEngine::getInstance().GetFont();
+    if (t == text && c.GetRGBA() == color.GetRGBA() && current == font && (surface || text.empty()))
+    {
+        return;
+    }
+    text = t;
+    color = c;
+    font = current;
+    Rasterize();
+}
+
+void TextRun::Rasterize()
+{
+    surface.reset();
+    int w = font->MeasureWidth(text);
+    if (w == 0)
+    {
+        return;
+    }
+    // text of the console or the events is charged to them
+    MemoryScope scope(MemoryStats::CurrentCategoryOr(MemoryCategory::Text));
+    surface.reset(new Surface(w, font->GetLineHeight()));
+    int x = 0;
+    for (char c : text)
+    {
+        const Font::Glyph& g = font->GetGlyph(static_cast<unsigned char>(c));
+        if (g.w > 0)
+        {
+            surface->Draw(font->GetAtlas(), x, font->GetLineHeight() - g.h, g.x, g.y, g.w, g.h);
+        }
+        x += g.advance;
+    }
+    // the glyphs are tinted when the run is drawn
+    surface->SetColorMod(color);
+}
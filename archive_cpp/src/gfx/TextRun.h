@@ -0,0 +1,29 @@
+#ifndef TEXTRUN_H
+#define TEXTRUN_H
+
+#include "gfx/Font.h"
+#include "gfx/Color32.h"
+
+#include <memory>
+#include <string>
+
+// A string laid out with the current font (GraphicsEngine::GetFont()) and
+// rasterized once into its own surface. Set() does nothing if the text,
+// the color and the font did not change, so it can be called every frame.
+class TextRun
+{
+public:
+    void Set(const std::string& text, const Color32& c);
+    const std::string& GetText() const { return text; }
+    // nullptr for an empty text
+    const Surface* GetSurface() const { return surface.get(); }
+private:
+    std::string                 text;
+    Color32                     color;
+    FontPtr                     font;
+    std::unique_ptr<Surface>    surface;
+
+    void Rasterize();
+};
+
+#endif // TEXTRUN_H
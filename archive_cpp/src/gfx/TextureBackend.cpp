@@ -0,0 +1,124 @@
+#include "TextureBackend.h"
+#include "NativeSurfaceAccess.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <SDL2/SDL.h>
+
+constexpr unsigned TextureBackend::keepFrames;
+
+TextureBackend::TextureBackend(SDL_Window* window, int scale)
+{
+    SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+    renderer = SDL_CreateRenderer(window, -1, 0);
+    if (renderer == nullptr)
+    {
+        throw std::runtime_error(std::string("Unable to create the renderer: ") + SDL_GetError());
+    }
+    int windowWidth = 0;
+    int windowHeight = 0;
+    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    scale = std::min(std::max(scale, 1), 4);
+    width = windowWidth / scale;
+    height = windowHeight / scale;
+    // pixel art, whole factors and no filtering
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    SDL_RenderSetLogicalSize(renderer, width, height);
+    SDL_RenderSetIntegerScale(renderer, SDL_TRUE);
+}
+
+TextureBackend::TextureBackend(Surface& target)
+    : width(target.getWidth())
+    , height(target.getHeight())
+{
+    SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+    renderer = SDL_CreateSoftwareRenderer(NativeSurfaceAccess::Get(target));
+    if (renderer == nullptr)
+    {
+        throw std::runtime_error(std::string("Unable to create the software renderer: ") + SDL_GetError());
+    }
+}
+
+TextureBackend::~TextureBackend()
+{
+    for (auto& t : textures)
+    {
+        SDL_DestroyTexture(t.second.texture);
+    }
+    SDL_DestroyRenderer(renderer);
+}
+
+void TextureBackend::BeginFrame()
+{
+    ++frame;
+    if (frame % keepFrames == 0)
+    {
+        ReleaseUnused();
+    }
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+}
+
+void TextureBackend::Prepare(const Surface& s)
+{
+    GetTexture(s);
+}
+
+void TextureBackend::Draw(const Surface& s, int x, int y)
+{
+    SDL_Rect dest = {x, y, s.getWidth(), s.getHeight()};
+    SDL_RenderCopy(renderer, GetTexture(s), NULL, &dest);
+}
+
+void TextureBackend::DrawMirrored(const Surface& s, int x, int y)
+{
+    SDL_Rect dest = {x, y, s.getWidth(), s.getHeight()};
+    SDL_RenderCopyEx(renderer, GetTexture(s), NULL, &dest, 0.0, NULL, SDL_FLIP_HORIZONTAL);
+}
+
+void TextureBackend::PutPixel(int x, int y, const Color32& c)
+{
+    SDL_SetRenderDrawColor(renderer, c.GetR(), c.GetG(), c.GetB(), c.GetA());
+    SDL_RenderDrawPoint(renderer, x, y);
+}
+
+void TextureBackend::Present()
+{
+    SDL_RenderPresent(renderer);
+}
+
+SDL_Texture* TextureBackend::GetTexture(const Surface& s)
+{
+    Texture& t = textures[&s];
+    t.lastUsed = frame;
+    if (t.texture == nullptr || t.contentId != s.GetContentId())
+    {
+        // a new surface, or this one changed; colorkey, color and alpha
+        // modulation are taken over by SDL
+        if (t.texture != nullptr)
+        {
+            SDL_DestroyTexture(t.texture);
+        }
+        t.texture = SDL_CreateTextureFromSurface(renderer, NativeSurfaceAccess::Get(s));
+        t.contentId = s.GetContentId();
+        t.memory.Set(MemoryCategory::Render, 4 * static_cast<size_t>(s.getWidth()) * s.getHeight());
+        ++uploads;
+    }
+    return t.texture;
+}
+
+void TextureBackend::ReleaseUnused()
+{
+    for (auto it = textures.begin(); it != textures.end(); )
+    {
+        if (frame - it->second.lastUsed > keepFrames)
+        {
+            SDL_DestroyTexture(it->second.texture);
+            it = textures.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
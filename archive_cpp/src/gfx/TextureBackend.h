@@ -0,0 +1,68 @@
+#ifndef TEXTUREBACKEND_H
+#define TEXTUREBACKEND_H
+
+#include "gfx/RenderBackend.h"
+#include "utils/MemoryStats.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+struct SDL_Window;
+struct SDL_Renderer;
+struct SDL_Texture;
+
+// SDL_Renderer backend: every surface gets a texture, made on its first
+// draw and remade when the surface changes. Draws of the same texture in a
+// row (RenderQueue sorts them so) are batched by SDL. Textures of surfaces
+// not drawn for a while are released.
+class TextureBackend : public IRenderBackend
+{
+public:
+    // draws to the window at its size / scale, SDL scales it up
+    TextureBackend(SDL_Window* window, int scale);
+    // headless, SDL's software renderer drawing into target
+    explicit TextureBackend(Surface& target);
+    ~TextureBackend();
+
+    TextureBackend(const TextureBackend&) = delete;
+    TextureBackend& operator=(const TextureBackend&) = delete;
+
+    virtual const char* GetName() const override { return "texture"; }
+    virtual int Width() const override { return width; }
+    virtual int Height() const override { return height; }
+    virtual void BeginFrame() override;
+    virtual void Prepare(const Surface& s) override;
+    virtual void Draw(const Surface& s, int x, int y) override;
+    virtual void DrawMirrored(const Surface& s, int x, int y) override;
+    virtual void PutPixel(int x, int y, const Color32& c) override;
+    virtual Surface* GetTargetSurface() override { return nullptr; }
+    virtual void Present() override;
+
+    int GetTextureCount() const { return static_cast<int>(textures.size()); }
+    // textures made since the start
+    int GetUploadCount() const { return uploads; }
+private:
+    // frames a texture is kept without being drawn
+    static constexpr unsigned keepFrames = 120;
+
+    struct Texture
+    {
+        SDL_Texture*    texture = nullptr;
+        uint64_t        contentId = 0;
+        unsigned        lastUsed = 0;
+        // 4 bytes per texel, wherever the driver keeps them
+        MemoryCharge    memory;
+    };
+
+    SDL_Renderer*   renderer = nullptr;
+    int             width = 0;
+    int             height = 0;
+    unsigned        frame = 0;
+    int             uploads = 0;
+    std::unordered_map<const Surface*, Texture>   textures;
+
+    SDL_Texture* GetTexture(const Surface& s);
+    void ReleaseUnused();
+};
+
+#endif // TEXTUREBACKEND_H
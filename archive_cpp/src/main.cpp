@@ -1,18 +1,186 @@
+#include <algorithm>
+#include <cstdio>
 #include <stdexcept>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
 #include "App.h"
+#include "data/ResourceFactory.h"
+#include "game/Replay.h"
+#include "gfx/GraphicsEngine.h"
+#include "utils/MemoryStats.h"
 
-int GameMain(int /*argc*/, char** /*argv[]*/)
+// NAME=SIZE, SIZE in bytes or with a K or M suffix
+static bool ParseMemoryBudget(const std::string& arg)
 {
+    auto eq = arg.find('=');
+    MemoryCategory c;
+    if (eq == std::string::npos || !MemoryStats::ParseCategory(arg.substr(0, eq), c))
+    {
+        return false;
+    }
+    char* end = nullptr;
+    double size = std::strtod(arg.c_str() + eq + 1, &end);
+    if (*end == 'K' || *end == 'k')
+    {
+        size *= 1024;
+        ++end;
+    }
+    else if (*end == 'M' || *end == 'm')
+    {
+        size *= 1024 * 1024;
+        ++end;
+    }
+    if (*end != 0 || size <= 0)
+    {
+        return false;
+    }
+    MemoryStats::SetBudget(c, static_cast<int64_t>(size));
+    return true;
+}
+
+// the peaks of the session are over budget, each violation is printed
+static bool OverMemoryBudget()
+{
+    auto violations = MemoryStats::GetBudgetViolations();
+    for (const auto& v : violations)
+    {
+        std::cout << "Over memory budget: " << v << std::endl;
+    }
+    return !violations.empty();
+}
+
+// plays the logs back headless, one line each with the final state hash
+static int RunReplays(const std::vector<std::string>& files)
+{
+    int failed = 0;
+    for (const auto& f : files)
+    {
+        try
+        {
+            InputLog log = InputLog::Load(f);
+            GraphicsEngine::getInstance().InitializeHeadless(log.width, log.height);
+            ReplayResult r = RunReplay(log);
+            double played = r.steps * log.stepMs / 1000.0;
+            char line[256];
+            std::snprintf(line, sizeof(line),
+                          "%s: %llu steps (%.0f s of play) in %.2f s (load %.2f s), %.0f steps/s, state %016llx",
+                          f.c_str(), static_cast<unsigned long long>(r.steps), played, r.simulationSeconds,
+                          r.loadSeconds, r.steps / std::max(r.simulationSeconds, 1e-9),
+                          static_cast<unsigned long long>(r.stateHash));
+            std::cout << line << std::endl;
+        }
+        catch (const std::exception& ex)
+        {
+            std::cout << f << ": " << ex.what() << std::endl;
+            ++failed;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+int GameMain(int argc, char** argv)
+{
+    // --scale N renders at 1/N of the window resolution (N = 1..4)
+    // --renderer surface|texture picks the render backend
+    // --record FILE saves the input of the session for --replay
+    // --replay FILE (repeatable) runs the sessions headless instead of the game
+    // --media DIR loads the game files from DIR instead of media/
+    // --memory-report FILE writes the memory use per category as JSON on exit
+    // --memory-budget NAME=SIZE (repeatable) fails replays whose peak is above it
+    int scale = 1;
+    RenderBackendType backend = RenderBackendType::Surface;
+    std::string recordFile;
+    std::string memoryReport;
+    std::vector<std::string> replays;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        // every option takes a value, it is skipped once read
+        const char* option = argv[i];
+        const char* value = argv[i + 1];
+        if (std::strcmp(option, "--renderer") == 0)
+        {
+            if (!ParseRenderBackendType(value, backend))
+            {
+                std::cout << "Unknown renderer " << value << ", expected surface or texture" << std::endl;
+            }
+        }
+        else if (std::strcmp(option, "--scale") == 0)
+        {
+            scale = std::atoi(value);
+            if (scale < 1 || scale > 4)
+            {
+                std::cout << "Unsupported scale " << value << ", expected 1 to 4" << std::endl;
+                scale = 1;
+            }
+        }
+        else if (std::strcmp(option, "--record") == 0)
+        {
+            recordFile = value;
+        }
+        else if (std::strcmp(option, "--replay") == 0)
+        {
+            replays.push_back(value);
+        }
+        else if (std::strcmp(option, "--media") == 0)
+        {
+            std::string path = value;
+            if (path.empty())
+            {
+                std::cout << "Empty media directory, using media/" << std::endl;
+            }
+            else
+            {
+                ResourceFactory::GetInstance().SetResourcePath(path.back() == '/' ? path : path + "/");
+            }
+        }
+        else if (std::strcmp(option, "--memory-report") == 0)
+        {
+            memoryReport = value;
+        }
+        else if (std::strcmp(option, "--memory-budget") == 0)
+        {
+            if (!ParseMemoryBudget(value))
+            {
+                std::cout << "Invalid memory budget " << value << ", expected category=size" << std::endl;
+            }
+        }
+        else
+        {
+            continue;
+        }
+        ++i;
+    }
+    auto writeMemoryReport = [&memoryReport]()
+    {
+        if (!memoryReport.empty())
+        {
+            std::ofstream out(memoryReport.c_str());
+            MemoryStats::WriteJson(out);
+        }
+    };
+    if (!replays.empty())
+    {
+        int result = RunReplays(replays);
+        std::cout << MemoryStats::GetReport();
+        writeMemoryReport();
+        return OverMemoryBudget() ? 1 : result;
+    }
+
     try
     {
-        App gameApplication;
+        App gameApplication(scale, backend, recordFile);
         gameApplication.Run();
     }
     catch (const std::exception& ex)
     {
         std::cout << "An exception thrown by the game: " << ex.what() <<std::endl;
     }
+    writeMemoryReport();
+    OverMemoryBudget();
 
     return 0;
 }
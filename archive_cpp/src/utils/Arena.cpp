@@ -0,0 +1,55 @@
+#include "Arena.h"
+
+#include <assert.h>
+#include <cstdint>
+
+constexpr size_t Arena::defaultBlockSize;
+
+Arena::Arena(size_t blockSize_)
+    : blockSize(blockSize_)
+{ }
+
+Arena::~Arena() { }
+
+void* Arena::Allocate(size_t bytes, size_t alignment)
+{
+    assert((alignment & (alignment - 1)) == 0 && alignment <= alignof(std::max_align_t));
+    std::lock_guard<std::mutex> lock(mutex);
+    used += bytes;
+    // large ones get a block of their own, the current block stays
+    if (bytes > blockSize / 4)
+    {
+        blocks.push_back({std::unique_ptr<char[]>(new char[bytes]), bytes});
+        reserved += bytes;
+        return blocks.back().memory.get();
+    }
+    uintptr_t p = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~(alignment - 1);
+    if (current == nullptr || p + bytes > reinterpret_cast<uintptr_t>(end))
+    {
+        blocks.push_back({std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+        reserved += blockSize;
+        current = blocks.back().memory.get();
+        end = current + blockSize;
+        p = reinterpret_cast<uintptr_t>(current);
+    }
+    current = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+size_t Arena::GetUsedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return used;
+}
+
+size_t Arena::GetReservedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return reserved;
+}
+
+int Arena::GetBlockCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(blocks.size());
+}
@@ -0,0 +1,106 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Monotonic allocator for data that lives and dies together (everything a
+// level builds). Allocations are pointer bumps in large blocks, freeing
+// one does nothing, and the blocks go when the arena does. Allocate may be
+// called from several threads at once.
+class Arena
+{
+public:
+    static constexpr size_t defaultBlockSize = 1024 * 1024;
+
+    explicit Arena(size_t blockSize = defaultBlockSize);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // alignment is a power of two, at most alignof(std::max_align_t)
+    void* Allocate(size_t bytes, size_t alignment);
+
+    // bytes handed out and bytes taken from the heap
+    size_t GetUsedBytes() const;
+    size_t GetReservedBytes() const;
+    int GetBlockCount() const;
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> memory;
+        size_t                  size;
+    };
+
+    const size_t        blockSize;
+    mutable std::mutex  mutex;
+    std::vector<Block>  blocks;
+    // the free part of the last block of blockSize
+    char*               current = nullptr;
+    char*               end = nullptr;
+    size_t              used = 0;
+    size_t              reserved = 0;
+};
+
+// Standard allocator on an Arena, or on the heap when made without one, so
+// the same container types serve the level and everything else. Containers
+// take their arena along when moved or copied.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator() noexcept = default;
+    explicit ArenaAllocator(Arena* a) noexcept
+        : arena(a)
+    { }
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena(other.GetArena())
+    { }
+
+    T* allocate(size_t n)
+    {
+        if (arena == nullptr)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t)
+    {
+        if (arena == nullptr)
+        {
+            ::operator delete(p);
+        }
+    }
+
+    Arena* GetArena() const noexcept { return arena; }
+private:
+    Arena*  arena = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return a.GetArena() == b.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return !(a == b);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // ARENA_H
@@ -15,184 +15,233 @@
 // 
 **********************************************************************************************/
 
+
 #ifndef BSPTREE2D_H
 #define BSPTREE2D_H
 
+#include "utils/Utils.h"
+
 #include <vector>
+#include <assert.h>
 
+// Space partition of a fixed world window into equally sized leaves. Splits
+// alternate between the x and the y axis, so the tree is complete and lives
+// in flat arrays: node n has children 2n + 1 and 2n + 2. Elements are kept in
+// a single arena and linked into their leaf, so erase and relocate do not
+// allocate. Elements outside of the window end up in the border leaves.
 template <typename Element, typename PositionGetter>
 class BSPTree2D
 {
 public:
-
-    typedef std::vector<Element> ElementCollection;
+    typedef int Handle;
 
     BSPTree2D(const Rectangle2D& worldWindow_, int partitionWidth, int partitionHeight)
     {
-        // build the tree
-        root = new BSTNode();
-        root->x_axis = true;
-        root->axis = partitionWidth / 2;
-        BuildTree(*root, partitionWidth, partitionHeight, worldWindow_);
+        // all nodes at the same depth have the same size, so the depth is
+        // found by halving the window until a leaf would be too small
+        Rectangle2D area = worldWindow_;
+        bool x_axis = true;
+        for (;;)
+        {
+            Rectangle2D half = area;
+            if (x_axis)
+            {
+                half.w = area.w / 2;
+            }
+            else
+            {
+                half.h = area.h / 2;
+            }
+            if (half.w < partitionWidth || half.h < partitionHeight)
+            {
+                break;
+            }
+            area = half;
+            x_axis = !x_axis;
+            ++depth;
+        }
+        splits.resize((1 << depth) - 1);
+        leafHeads.assign(1 << depth, -1);
+        BuildTree(0, 0, worldWindow_);
     }
-    virtual ~BSPTree2D()
+
+    Handle Insert(const Element& entity)
     {
-        // destroy the tree
-        Destroy(root);
+        Handle h = AllocItem();
+        items[h].value = entity;
+        Link(h, FindLeaf(PositionGetter()(items[h].value)));
+        return h;
     }
 
-    void Insert(const Element& entity)
+    Handle Insert(Element&& entity)
     {
-        PositionGetter f;
-        auto* node = Find(f(entity));
-        assert(node != nullptr);
-        node->AddElement(entity);
+        Handle h = AllocItem();
+        items[h].value = std::move(entity);
+        Link(h, FindLeaf(PositionGetter()(items[h].value)));
+        return h;
     }
 
-    void Insert(Element&& entity)
+    void Erase(Handle h)
     {
-        PositionGetter f;
-        auto* node = Find(f(entity));
-        assert(node != nullptr);
-        node->AddElement(std::move(entity));
+        Unlink(h);
+        items[h].value = Element();
+        items[h].leaf = -1;
+        items[h].next = freeItems;
+        freeItems = h;
+        --size;
     }
 
-    ElementCollection& GetEntitles(const Point2D& location)
+    // has to be called after the position of the element has changed
+    void Relocate(Handle h)
     {
-        auto* node = Find(location);
-        assert(node != nullptr);
-        if (node->leaf == nullptr)
+        int leaf = FindLeaf(PositionGetter()(items[h].value));
+        if (leaf != items[h].leaf)
         {
-            static ElementCollection empty;
-            return empty;
+            Unlink(h);
+            Link(h, leaf);
         }
-        return node->leaf->values;
+    }
+
+    Element& Get(Handle h) { return items[h].value; }
+    const Element& Get(Handle h) const { return items[h].value; }
+    int Size() const { return size; }
+
+    // calls fn(Handle, const Element&) for every element placed inside r
+    template <class Fn>
+    void Query(const Rectangle2D& r, Fn&& fn) const
+    {
+        QueryNode(0, 0, r, fn);
     }
 private:
-    // structures
-    struct BSTLeaf
+    struct Split
     {
-        ElementCollection values;
+        int axis;
     };
 
-    struct BSTNode
+    struct Item
     {
-        bool x_axis;
-        int axis;
-        BSTNode* child_l = nullptr;
-        BSTNode* child_r = nullptr;
-        BSTLeaf* leaf = nullptr;
+        Element value;
+        int     leaf = -1;
+        int     prev = -1;
+        int     next = -1; // also links the free items
+    };
+
+    int                 depth = 0;
+    std::vector<Split>  splits;     // internal nodes, the axis depends on the depth
+    std::vector<int>    leafHeads;  // first item of every leaf
+    std::vector<Item>   items;
+    int                 freeItems = -1;
+    int                 size = 0;
+
+    static bool IsXAxis(int level) { return level % 2 == 0; }
 
-        void AddElement(const Element& e)
+    void BuildTree(int node, int level, const Rectangle2D& area)
+    {
+        if (level == depth)
         {
-            assert(child_l == nullptr);
-            assert(child_r == nullptr);
-            if (leaf == nullptr)
-            {
-                leaf = new BSTLeaf();
-                // TODO: find optimal value
-                leaf->values.reserve(20);
-            }
-            leaf->values.push_back(e);
+            return;
         }
-        void AddElement(Element&& e)
+        Rectangle2D rl = area;
+        Rectangle2D rr = area;
+        if (IsXAxis(level))
         {
-            assert(child_l == nullptr);
-            assert(child_r == nullptr);
-            if (leaf == nullptr)
-            {
-                leaf = new BSTLeaf();
-                // TODO: find optimal value
-                leaf->values.reserve(20);
-            }
-            leaf->values.push_back(std::move(e));
+            rl.w = area.w / 2;
+            rr.x = area.x + rl.w;
+            rr.w = area.w - rl.w;
+            splits[node].axis = rr.x;
         }
-    };
-
-    BSTNode* root = nullptr;
+        else
+        {
+            rl.h = area.h / 2;
+            rr.y = area.y + rl.h;
+            rr.h = area.h - rl.h;
+            splits[node].axis = rr.y;
+        }
+        BuildTree(2 * node + 1, level + 1, rl);
+        BuildTree(2 * node + 2, level + 1, rr);
+    }
 
-    // helpers
-    BSTNode* Find(const Point2D& location)
+    int FindLeaf(const Point2D& location) const
     {
-        BSTNode* n = root;
-
-        while (n->child_l != nullptr && n->child_r != nullptr)
+        int n = 0;
+        for (int level = 0; level < depth; ++level)
         {
-            bool left = false;
-            if (n->x_axis && location.x < n->axis)
-            {
-                left = true;
-            }
-            else if (location.y < n->axis)
-            {
-                left = true;
-            }
-
-            if (left)
-            {
-                n = n->child_l;
-            }
-            else
-            {
-                n = n->child_r;
-            }
+            int coord = IsXAxis(level) ? location.x : location.y;
+            n = (coord < splits[n].axis) ? 2 * n + 1 : 2 * n + 2;
         }
-
-        return n;
+        return n - static_cast<int>(splits.size());
     }
 
-    void BuildTree(BSTNode& root, int minWidth, int minHeight,
-                   const Rectangle2D& area)
+    template <class Fn>
+    void QueryNode(int n, int level, const Rectangle2D& r, Fn& fn) const
     {
-        int axis = 0;
-        Rectangle2D rr, rl;
-        if (root.x_axis)
+        if (level == depth)
         {
-            axis = area.x + area.w / 2;
-            rr.y = rl.y = area.y;
-            rr.h = rl.h = area.h;
-            rl.x = area.x;
-            rr.x = area.x + area.w / 2;
-            rl.w = rr.w = area.w / 2;
+            PositionGetter f;
+            for (int i = leafHeads[n - splits.size()]; i != -1; i = items[i].next)
+            {
+                Point2D p = f(items[i].value);
+                if (p.x >= r.x && p.x < r.x + r.w && p.y >= r.y && p.y < r.y + r.h)
+                {
+                    fn(i, items[i].value);
+                }
+            }
+            return;
         }
-        else
+        int from = IsXAxis(level) ? r.x : r.y;
+        int to = IsXAxis(level) ? r.x + r.w : r.y + r.h;
+        if (from < splits[n].axis)
         {
-            axis = area.y + area.h / 2;
-            rr.x = rl.x = area.x;
-            rr.w = rl.w = area.w;
-            rl.y = area.y;
-            rr.y = area.y + area.h / 2;
-            rl.h = rr.h = area.h / 2;
+            QueryNode(2 * n + 1, level + 1, r, fn);
         }
-
-        if (rr.h < minHeight || rr.w < minWidth)
+        if (to > splits[n].axis)
         {
-            return;
+            QueryNode(2 * n + 2, level + 1, r, fn);
         }
+    }
 
-        root.child_l = new BSTNode();
-        root.child_r = new BSTNode();
-        root.child_l->x_axis = !root.x_axis;
-        root.child_r->x_axis = !root.x_axis;
-        root.child_l->axis = axis;
-        root.child_r->axis = axis;
-
-        BuildTree(*root.child_l, minWidth, minHeight, rl);
-        BuildTree(*root.child_r, minWidth, minHeight, rr);
+    Handle AllocItem()
+    {
+        ++size;
+        if (freeItems != -1)
+        {
+            Handle h = freeItems;
+            freeItems = items[h].next;
+            return h;
+        }
+        items.emplace_back();
+        return static_cast<Handle>(items.size() - 1);
     }
 
-    // Recurence functions
-    void Destroy(BSTNode* node)
+    void Link(Handle h, int leaf)
     {
-        if (node == nullptr)
+        Item& it = items[h];
+        it.leaf = leaf;
+        it.prev = -1;
+        it.next = leafHeads[leaf];
+        if (it.next != -1)
         {
-            return;
+            items[it.next].prev = h;
         }
-        Destroy(node->child_l);
-        Destroy(node->child_r);
+        leafHeads[leaf] = h;
+    }
 
-        delete node->leaf;
-        delete node;
+    void Unlink(Handle h)
+    {
+        Item& it = items[h];
+        assert(it.leaf != -1);
+        if (it.prev != -1)
+        {
+            items[it.prev].next = it.next;
+        }
+        else
+        {
+            leafHeads[it.leaf] = it.next;
+        }
+        if (it.next != -1)
+        {
+            items[it.next].prev = it.prev;
+        }
     }
 };
 
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <zlib.h>
 #include <assert.h>
 #include "utils/Mpl.h"
@@ -11,16 +12,36 @@
 namespace BinaryReader
 {
 
+// size bytes as they are in the file, for blocks inflated later
+inline std::unique_ptr<char[]> ReadBlock(std::ifstream& fileStream, unsigned long size)
+{
+    std::unique_ptr<char[]> data(new char[size]);
+    fileStream.read(&data[0], size);
+    if (!fileStream)
+    {
+        throw std::runtime_error("Truncated data block.");
+    }
+    return data;
+}
+
+inline std::unique_ptr<char[]> Decompress(const char* c_data, unsigned long compressSize,
+                                          unsigned long uncompressSize)
+{
+    std::unique_ptr<char[]> u_data(new char[uncompressSize]);
+    const unsigned long expectedSize = uncompressSize;
+    if (::uncompress((unsigned char*)&u_data[0], &uncompressSize, (const unsigned char*)c_data,
+                     compressSize) != Z_OK || uncompressSize != expectedSize)
+    {
+        throw std::runtime_error("Truncated or corrupt data block.");
+    }
+    return u_data;
+}
+
 inline std::unique_ptr<char[]> ReadAndDecompress(std::ifstream& fileStream, unsigned long compressSize,
                                                            unsigned long uncompressSize)
 {
-    std::unique_ptr<char[]> c_data(new char[compressSize]);
-    std::unique_ptr<char[]> u_data(new char[uncompressSize]);
-    fileStream.read(&c_data[0], compressSize);
-    assert((unsigned char)c_data[0] == 0x78);
-    assert((unsigned char)c_data[1] == 0xda);
-    ::uncompress((unsigned char*)&u_data[0], &uncompressSize, (const unsigned char*)&c_data[0], compressSize);
-    return std::move(u_data);
+    std::unique_ptr<char[]> c_data = ReadBlock(fileStream, compressSize);
+    return Decompress(&c_data[0], compressSize, uncompressSize);
 }
 
 template <typename T>
@@ -0,0 +1,184 @@
+#ifndef BINARYVIEW_H
+#define BINARYVIEW_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "utils/BinaryWriter.h"
+#include "utils/Mpl.h"
+
+// Read-only views of file structures inside a decompressed buffer. A view
+// checks once that the buffer holds the whole structure and then reads
+// fields in place, nothing is copied up front. Structures are described by
+// one field list, an X macro, from which both the view and a plain struct
+// for the writers are generated:
+//
+//     #define POINT_FIELDS(X) X(Left, int32_t) X(Top, int32_t) X(Name, char[16])
+//
+//     class PointView { BINARY_VIEW_BODY(PointView, POINT_FIELDS) };
+//     struct Point { BINARY_STRUCT_BODY(POINT_FIELDS) };
+//
+// Field types are arithmetic types, records with a Codec specialization and
+// arrays of either; NULL_type elements take no bytes, for fields a version
+// of the format leaves out. Field lists may use the template parameters of
+// the class they are expanded in.
+namespace BinaryView
+{
+
+template <typename T>
+class Array;
+
+// how a T is stored: its size in the file, what reading it in place gives
+// and how it is appended to a buffer
+template <typename T>
+struct Codec
+{
+    static_assert(std::is_arithmetic<T>::value, "records need their own Codec");
+    static constexpr size_t size = sizeof(T);
+    typedef T type;
+
+    static T Read(const char* s)
+    {
+        T t;
+        ::memcpy(&t, s, sizeof(T));
+        return t;
+    }
+
+    static void Write(std::vector<char>& out, const T& t)
+    {
+        BinaryWriter::write(out, t);
+    }
+};
+
+template <>
+struct Codec<NULL_type>
+{
+    static constexpr size_t size = 0;
+    typedef NULL_type type;
+
+    static NULL_type Read(const char*) { return NULL_type(); }
+    static void Write(std::vector<char>&, const NULL_type&) { }
+};
+
+template <typename T, size_t N>
+struct Codec<T[N]>
+{
+    static constexpr size_t size = N * Codec<T>::size;
+    typedef Array<T> type;
+
+    static Array<T> Read(const char* s) { return Array<T>(s, N); }
+
+    static void Write(std::vector<char>& out, const T (&a)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            Codec<T>::Write(out, a[i]);
+        }
+    }
+};
+
+// count elements stored one after another, read on access
+template <typename T>
+class Array
+{
+public:
+    typedef typename Codec<T>::type value_type;
+
+    Array(const char* first, size_t count)
+        : first(first)
+        , count(count)
+    { }
+
+    size_t size() const { return count; }
+    const char* data() const { return first; }
+
+    value_type operator[](size_t i) const
+    {
+        assert(i < count);
+        return Codec<T>::Read(first + i * Codec<T>::size);
+    }
+
+    // for indices that come from the file
+    value_type at(size_t i) const
+    {
+        if (i >= count)
+        {
+            throw std::runtime_error("Index " + std::to_string(i) + " out of a table of " +
+                                     std::to_string(count) + ".");
+        }
+        return (*this)[i];
+    }
+private:
+    const char* first;
+    size_t      count;
+};
+
+// the characters up to the first null, or all of them
+inline std::string ToString(const Array<char>& a)
+{
+    const void* end = ::memchr(a.data(), 0, a.size());
+    return std::string(a.data(), end ? static_cast<const char*>(end) - a.data() : a.size());
+}
+
+// throws when a buffer of size bytes is shorter than required
+inline const char* Require(const char* data, size_t size, size_t required, const char* what)
+{
+    if (data == nullptr || size < required)
+    {
+        throw std::runtime_error(std::string(what) + " is truncated: " + std::to_string(size) +
+                                 " bytes, " + std::to_string(required) + " needed.");
+    }
+    return data;
+}
+
+template <typename T>
+using Field = T;
+
+}
+
+#define BINARY_VIEW_ID(name, Type) name##Field,
+#define BINARY_VIEW_SIZE(name, Type) BinaryView::Codec<Type>::size,
+#define BINARY_VIEW_ACCESSOR(name, Type) \
+    typename BinaryView::Codec<Type>::type name() const \
+    { \
+        return BinaryView::Codec<Type>::Read(bytes + std::integral_constant<size_t, Offset(name##Field)>::value); \
+    }
+#define BINARY_STRUCT_MEMBER(name, Type) BinaryView::Field<Type> name;
+#define BINARY_STRUCT_WRITE(name, Type) BinaryView::Codec<Type>::Write(out, name);
+
+// Field ids, Offset(id), Size() and an accessor per field; the constructor
+// throws std::runtime_error when size is less than Size()
+#define BINARY_VIEW_BODY(Name, FIELDS) \
+public: \
+    enum FieldId { FIELDS(BINARY_VIEW_ID) FieldCount }; \
+    static constexpr size_t Offset(int field) \
+    { \
+        const size_t sizes[] = { FIELDS(BINARY_VIEW_SIZE) 0 }; \
+        size_t offset = 0; \
+        for (int f = 0; f < field; ++f) \
+        { \
+            offset += sizes[f]; \
+        } \
+        return offset; \
+    } \
+    static constexpr size_t Size() { return Offset(FieldCount); } \
+    Name(const char* data, size_t size) \
+        : bytes(BinaryView::Require(data, size, Size(), #Name)) \
+    { } \
+    FIELDS(BINARY_VIEW_ACCESSOR) \
+private: \
+    const char* bytes;
+
+// the fields as members and write(out), appending them in file layout
+#define BINARY_STRUCT_BODY(FIELDS) \
+    FIELDS(BINARY_STRUCT_MEMBER) \
+    void write(std::vector<char>& out) const \
+    { \
+        FIELDS(BINARY_STRUCT_WRITE) \
+    }
+
+#endif // BINARYVIEW_H
@@ -0,0 +1,48 @@
+#ifndef BINARYWRITER_H
+#define BINARYWRITER_H
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+// Counterpart of BinaryReader: members are appended to a buffer as the
+// readers expect them, byte for byte.
+namespace BinaryWriter
+{
+
+template <typename T>
+inline void write(std::vector<char>& out, const T& member)
+{
+    const char* bytes = reinterpret_cast<const char*>(&member);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// zlib at the best compression, the readers expect its 0x78 0xda header
+inline std::vector<char> Compress(const std::vector<char>& data)
+{
+    uLongf size = compressBound(data.size());
+    std::vector<char> compressed(size);
+    if (::compress2(reinterpret_cast<Bytef*>(compressed.data()), &size,
+                    reinterpret_cast<const Bytef*>(data.data()), data.size(), Z_BEST_COMPRESSION) != Z_OK)
+    {
+        throw std::runtime_error("Cannot compress a data block.");
+    }
+    compressed.resize(size);
+    return compressed;
+}
+
+inline void WriteFile(const std::string& filename, const std::vector<char>& data)
+{
+    std::ofstream file(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    file.write(data.data(), data.size());
+    if (!file)
+    {
+        throw std::runtime_error("Cannot write " + filename);
+    }
+}
+
+}
+
+#endif // BINARYWRITER_H
@@ -1,39 +1,75 @@
 #include "GameConsoleWriter.h"
 
-GameConsoleWriter::GameConsoleWriter(Surface& screen_)
-    : screen(screen_)
+#include "gfx/GraphicsEngine.h"
+
+#include <algorithm>
+#include <string>
+
+constexpr int GameConsoleWriter::lineAmount;
+constexpr int GameConsoleWriter::maxLineLength;
+
+GameConsoleWriter::GameConsoleWriter(IRenderBackend& target_)
+    : target(target_)
     , lineHeight(10)
-    , lineAmount(20)
+    , memory(MemoryCategory::Logger, sizeof(lines))
 {
+    runVersions.fill(0);
 }
 
-void GameConsoleWriter::Write(char c)
+void GameConsoleWriter::Write(const char* text, size_t length)
 {
-    if (c == '\n')
+    std::lock_guard<std::mutex> lock(linesMutex);
+    if (lineCount == 0)
     {
-        buffer.push_back(std::string());
-        return;
+        NewLine();
+    }
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (text[i] == '\n')
+        {
+            NewLine();
+            continue;
+        }
+        Line& l = lines[(firstLine + lineCount - 1) % lineAmount];
+        if (l.length < maxLineLength)
+        {
+            l.text[l.length++] = text[i];
+            ++l.version;
+        }
     }
-    WriteToBuffer(c);
-}
-
-void GameConsoleWriter::Write(double d)
-{
-    WriteToBuffer(d);
 }
 
-void GameConsoleWriter::Write(int i)
+void GameConsoleWriter::Display()
 {
-    WriteToBuffer(i);
+    int line_height = std::max(lineHeight, GraphicsEngine::getInstance().GetFont()->GetLineHeight() + 2);
+    std::lock_guard<std::mutex> lock(linesMutex);
+    MemoryScope scope(MemoryCategory::Logger);
+    for (int i = 0; i < lineCount; ++i)
+    {
+        // only the lines which changed since the last frame are rasterized
+        int slot = (firstLine + i) % lineAmount;
+        const Line& l = lines[slot];
+        if (runVersions[slot] != l.version)
+        {
+            runs[slot].Set(std::string(l.text, l.length), {255, 255, 255, 160});
+            runVersions[slot] = l.version;
+        }
+        target.DrawText(runs[slot], 10, (i + 1) * line_height);
+    }
 }
 
-void GameConsoleWriter::Display()
+void GameConsoleWriter::NewLine()
 {
-    int current_line = 1;
-    for (auto& l : buffer)
+    // the oldest line is overwritten when the ring is full
+    if (lineCount == lineAmount)
+    {
+        firstLine = (firstLine + 1) % lineAmount;
+    }
+    else
     {
-        int line_coord_y = current_line * lineHeight;
-        screen.WriteText(l, 10, line_coord_y, {255, 255, 255, 160});
-        current_line++;
+        ++lineCount;
     }
+    Line& l = lines[(firstLine + lineCount - 1) % lineAmount];
+    l.length = 0;
+    ++l.version;
 }
@@ -1,44 +1,48 @@
 #ifndef SDLCONSOLEWRITER_H
 #define SDLCONSOLEWRITER_H
 
-#include "gfx/Surface.h"
+#include "gfx/RenderBackend.h"
+#include "gfx/TextRun.h"
+#include "utils/MemoryStats.h"
 #include "utils/MicroLogger.h"
-#include <vector>
-#include <sstream>
+#include <array>
+#include <cstdint>
+#include <mutex>
 
+// Keeps the last lineAmount lines of the log in a fixed ring of fixed size
+// lines (longer lines are cut). Write() comes from the logger's flush
+// thread, Display() from the render loop.
 class GameConsoleWriter : public ILogWriter
 {
 public:
-    GameConsoleWriter(Surface& screen_);
+    static constexpr int lineAmount = 20;
+    static constexpr int maxLineLength = 120;
 
-    virtual void Write(char c);
-    virtual void Write(double d);
-    virtual void Write(int i);
+    GameConsoleWriter(IRenderBackend& target_);
+
+    virtual void Write(const char* text, size_t length);
 
     void Display();
 private:
-    Surface&    screen;
-    int         lineHeight;
-    int         lineAmount;
-    std::vector<std::string>   buffer;
-
-    template <typename T>
-    void WriteToBuffer(T v)
+    struct Line
     {
-        if (buffer.empty())
-        {
-            buffer.push_back(std::string());
-        }
-
-        while (buffer.size() > static_cast<unsigned int>(lineAmount))
-        {
-            buffer.erase(buffer.begin());
-        }
-
-        std::basic_stringstream<char>   ss;
-        ss << v;
-        buffer.back() += ss.str();
-    }
+        int         length = 0;
+        uint32_t    version = 0;    // bumped on every change
+        char        text[maxLineLength];
+    };
+
+    IRenderBackend& target;
+    int         lineHeight;
+    std::mutex  linesMutex;
+    std::array<Line, lineAmount>    lines;
+    int         firstLine = 0;
+    int         lineCount = 0;
+    // rasterized lines, per slot of lines
+    std::array<TextRun, lineAmount>     runs;
+    std::array<uint32_t, lineAmount>    runVersions;
+    MemoryCharge                        memory;
+
+    void NewLine();
 };
 
 #endif // SDLCONSOLEWRITER_H
@@ -0,0 +1,254 @@
+#include "JobSystem.h"
+
+namespace {
+
+// the system and the deque the current thread works on, -1 for threads
+// that are not workers
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local int currentWorker = -1;
+
+}
+
+constexpr int64_t JobSystem::Deque::capacity;
+
+bool JobSystem::Deque::Push(Job* job)
+{
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= capacity)
+    {
+        return false;
+    }
+    jobs[b % capacity].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* JobSystem::Deque::Pop()
+{
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b)
+    {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Job* job = jobs[b % capacity].load(std::memory_order_relaxed);
+    if (t == b)
+    {
+        // the last one, a thief may be taking it as well
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* JobSystem::Deque::Steal()
+{
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b)
+    {
+        return nullptr;
+    }
+    Job* job = jobs[t % capacity].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return job;
+}
+
+JobSystem& JobSystem::Instance()
+{
+    static JobSystem instance(std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+    return instance;
+}
+
+JobSystem::JobSystem(int workerCount)
+{
+    for (int i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back(new Worker);
+    }
+    // the deques exist before any worker looks at them
+    for (int i = 0; i < workerCount; ++i)
+    {
+        workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeUp.notify_all();
+    }
+    for (auto& w : workers)
+    {
+        w->thread.join();
+    }
+}
+
+void JobSystem::Submit(Job& job, JobCounter& counter)
+{
+    job.counter = &counter;
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    Enqueue(job);
+}
+
+void JobSystem::SubmitAfter(JobCounter& dependency, Job& job, JobCounter& counter)
+{
+    job.counter = &counter;
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+        if (dependency.pending.load(std::memory_order_acquire) > 0)
+        {
+            // queued by the job that brings dependency to zero
+            job.next = dependency.continuations;
+            dependency.continuations = &job;
+            return;
+        }
+    }
+    Enqueue(job);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    const int self = currentSystem == this ? currentWorker : -1;
+    while (counter.pending.load(std::memory_order_acquire) > 0)
+    {
+        Job* job = Take(self);
+        if (job != nullptr)
+        {
+            Execute(*job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    // the job that finished last may still hold the lock
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+void JobSystem::Enqueue(Job& job)
+{
+    if (currentSystem == this && currentWorker >= 0)
+    {
+        if (!workers[currentWorker]->deque.Push(&job))
+        {
+            // the deque is full, the job would only wait behind 1024 others
+            Execute(job);
+            return;
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        job.next = nullptr;
+        if (injectionTail != nullptr)
+        {
+            injectionTail->next = &job;
+        }
+        else
+        {
+            injectionHead = &job;
+        }
+        injectionTail = &job;
+    }
+
+    queued.fetch_add(1);
+    if (sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeUp.notify_one();
+    }
+}
+
+Job* JobSystem::Take(int self)
+{
+    Job* job = nullptr;
+    if (self >= 0)
+    {
+        job = workers[self]->deque.Pop();
+    }
+    if (job == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        job = injectionHead;
+        if (job != nullptr)
+        {
+            injectionHead = job->next;
+            if (injectionHead == nullptr)
+            {
+                injectionTail = nullptr;
+            }
+        }
+    }
+    const int count = WorkerCount();
+    for (int i = 1; job == nullptr && i <= count; ++i)
+    {
+        int victim = (self + i) % count;
+        if (victim != self)
+        {
+            job = workers[victim]->deque.Steal();
+        }
+    }
+    if (job != nullptr)
+    {
+        queued.fetch_sub(1);
+    }
+    return job;
+}
+
+void JobSystem::Execute(Job& job)
+{
+    // the job may be gone once its counter is done
+    JobCounter& counter = *job.counter;
+    job.function(job);
+
+    Job* ready = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            ready = counter.continuations;
+            counter.continuations = nullptr;
+        }
+    }
+    while (ready != nullptr)
+    {
+        Job* next = ready->next;
+        Enqueue(*ready);
+        ready = next;
+    }
+}
+
+void JobSystem::WorkerLoop(int self)
+{
+    currentSystem = this;
+    currentWorker = self;
+    while (!stopping)
+    {
+        Job* job = Take(self);
+        if (job != nullptr)
+        {
+            Execute(*job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        ++sleeping;
+        wakeUp.wait(lock, [this]() { return queued.load() > 0 || stopping; });
+        --sleeping;
+    }
+}
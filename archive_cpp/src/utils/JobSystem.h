@@ -0,0 +1,158 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Job;
+
+// Counts the jobs submitted against it that have not finished yet. Jobs
+// submitted with JobSystem::SubmitAfter wait for the counter to reach zero
+// before they are queued. A counter must outlive the Wait on it.
+class JobCounter
+{
+public:
+    bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+private:
+    friend class JobSystem;
+
+    std::atomic<int>    pending{0};
+    std::mutex          mutex;
+    Job*                continuations = nullptr;
+};
+
+// A unit of work: calls function(job) on some thread. Jobs belong to the
+// caller, are not copied and must stay alive until their counter is done;
+// begin and end are free for ranges, data for whatever the function needs.
+// A job must not throw.
+struct Job
+{
+    void        (*function)(Job&) = nullptr;
+    const void* data = nullptr;
+    int         begin = 0;
+    int         end = 0;
+    JobCounter* counter = nullptr;
+    Job*        next = nullptr;
+};
+
+// Work stealing scheduler. Every worker owns a deque: it pushes and pops
+// its own jobs at the bottom, idle workers steal from the top of the
+// others. Threads that are not workers queue into a shared list, and a
+// thread waiting on a counter runs jobs instead of blocking, so the main
+// thread takes part and nested waits inside jobs do not deadlock. With no
+// workers (a single hardware thread) everything runs on the waiting thread.
+// There is one instance, shared by asset loading and the simulation
+// (CollisionWorld), so nothing else should start threads for short work.
+class JobSystem
+{
+public:
+    // hardware threads - 1 workers, the waiting thread is the last one
+    static JobSystem& Instance();
+
+    explicit JobSystem(int workerCount);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    int WorkerCount() const { return static_cast<int>(workers.size()); }
+
+    void Submit(Job& job, JobCounter& counter);
+    // queues job once dependency is done, counter counts it from now
+    void SubmitAfter(JobCounter& dependency, Job& job, JobCounter& counter);
+    // runs jobs until counter is done
+    void Wait(JobCounter& counter);
+
+    // calls fn(first, last) on subranges of [begin, end) of at least grain
+    // indices, in parallel, and returns when all are done
+    template <typename Function>
+    void ParallelFor(int begin, int end, int grain, const Function& fn);
+private:
+    // Chase-Lev deque of fixed capacity, after Le et al., "Correct and
+    // Efficient Work-Stealing for Weak Memory Models"
+    class Deque
+    {
+    public:
+        bool Push(Job* job);
+        Job* Pop();
+        Job* Steal();
+    private:
+        static constexpr int64_t capacity = 1024;
+
+        std::atomic<int64_t>    top{0};
+        std::atomic<int64_t>    bottom{0};
+        std::atomic<Job*>       jobs[capacity];
+    };
+
+    struct Worker
+    {
+        Deque           deque;
+        std::thread     thread;
+    };
+
+    template <typename Function>
+    static void RunRange(Job& job)
+    {
+        (*static_cast<const Function*>(job.data))(job.begin, job.end);
+    }
+
+    void Enqueue(Job& job);
+    Job* Take(int self);
+    void Execute(Job& job);
+    void WorkerLoop(int self);
+
+    std::vector<std::unique_ptr<Worker>>    workers;
+
+    // jobs queued by threads that are not workers
+    std::mutex                  injectionMutex;
+    Job*                        injectionHead = nullptr;
+    Job*                        injectionTail = nullptr;
+
+    std::atomic<int>            queued{0};
+    std::atomic<int>            sleeping{0};
+    std::atomic<bool>           stopping{false};
+    std::mutex                  sleepMutex;
+    std::condition_variable     wakeUp;
+};
+
+template <typename Function>
+void JobSystem::ParallelFor(int begin, int end, int grain, const Function& fn)
+{
+    constexpr int maxChunks = 64;
+    const int count = end - begin;
+    if (count <= 0)
+    {
+        return;
+    }
+    grain = std::max(grain, 1);
+    const int chunks = std::min({maxChunks, (count + grain - 1) / grain, 4 * (WorkerCount() + 1)});
+    if (chunks <= 1 || workers.empty())
+    {
+        fn(begin, end);
+        return;
+    }
+
+    const int size = (count + chunks - 1) / chunks;
+    Job jobs[maxChunks];
+    JobCounter counter;
+    for (int c = 1; c < chunks; ++c)
+    {
+        jobs[c].function = &RunRange<Function>;
+        jobs[c].data = &fn;
+        jobs[c].begin = begin + c * size;
+        jobs[c].end = std::min(end, begin + (c + 1) * size);
+        if (jobs[c].begin < jobs[c].end)
+        {
+            Submit(jobs[c], counter);
+        }
+    }
+    fn(begin, std::min(end, begin + size));
+    Wait(counter);
+}
+
+#endif // JOBSYSTEM_H
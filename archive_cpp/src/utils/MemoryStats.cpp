@@ -0,0 +1,219 @@
+#include "MemoryStats.h"
+
+#include <atomic>
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+constexpr int categoryCount = static_cast<int>(MemoryCategory::Count);
+
+const char* const names[categoryCount] =
+{
+    "other", "render", "tile_set", "anim_set", "level_file", "level_grid", "collision", "events",
+    "text", "logger", "audio"
+};
+
+struct Counter
+{
+    std::atomic<int64_t>    bytes{0};
+    std::atomic<int64_t>    peak{0};
+    std::atomic<int64_t>    budget{0};
+
+    void Add(int64_t delta)
+    {
+        const int64_t now = bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+        int64_t p = peak.load(std::memory_order_relaxed);
+        while (now > p && !peak.compare_exchange_weak(p, now, std::memory_order_relaxed))
+        { }
+    }
+
+    MemoryStats::Usage Get() const
+    {
+        MemoryStats::Usage u;
+        u.bytes = bytes.load(std::memory_order_relaxed);
+        u.peak = peak.load(std::memory_order_relaxed);
+        u.budget = budget.load(std::memory_order_relaxed);
+        return u;
+    }
+};
+
+Counter counters[categoryCount];
+Counter total;
+
+thread_local MemoryCategory currentCategory = MemoryCategory::Other;
+
+std::string FormatBytes(int64_t bytes)
+{
+    char s[32];
+    if (bytes >= 10 * 1024 * 1024 || bytes <= -10 * 1024 * 1024)
+    {
+        std::snprintf(s, sizeof(s), "%.1f MB", bytes / (1024.0 * 1024.0));
+    }
+    else
+    {
+        std::snprintf(s, sizeof(s), "%.1f KB", bytes / 1024.0);
+    }
+    return s;
+}
+
+}
+
+const char* MemoryStats::GetName(MemoryCategory c)
+{
+    return names[static_cast<int>(c)];
+}
+
+bool MemoryStats::ParseCategory(const std::string& name, MemoryCategory& c)
+{
+    for (int i = 0; i < categoryCount; ++i)
+    {
+        if (name == names[i])
+        {
+            c = static_cast<MemoryCategory>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MemoryStats::Charge(MemoryCategory c, int64_t bytes)
+{
+    if (bytes != 0)
+    {
+        counters[static_cast<int>(c)].Add(bytes);
+        total.Add(bytes);
+    }
+}
+
+MemoryStats::Usage MemoryStats::Get(MemoryCategory c)
+{
+    return counters[static_cast<int>(c)].Get();
+}
+
+MemoryStats::Usage MemoryStats::GetTotal()
+{
+    return total.Get();
+}
+
+MemoryCategory MemoryStats::CurrentCategory()
+{
+    return currentCategory;
+}
+
+MemoryCategory MemoryStats::CurrentCategoryOr(MemoryCategory fallback)
+{
+    return currentCategory == MemoryCategory::Other ? fallback : currentCategory;
+}
+
+void MemoryStats::SetBudget(MemoryCategory c, int64_t bytes)
+{
+    counters[static_cast<int>(c)].budget.store(bytes, std::memory_order_relaxed);
+}
+
+std::vector<std::string> MemoryStats::GetBudgetViolations()
+{
+    std::vector<std::string> violations;
+    for (int i = 0; i < categoryCount; ++i)
+    {
+        Usage u = counters[i].Get();
+        if (u.budget > 0 && u.peak > u.budget)
+        {
+            violations.push_back(std::string(names[i]) + " peaked at " + FormatBytes(u.peak) +
+                                 ", budget " + FormatBytes(u.budget));
+        }
+    }
+    return violations;
+}
+
+std::string MemoryStats::GetReport()
+{
+    std::string report = "memory        current       peak\n";
+    char line[80];
+    for (int i = 0; i <= categoryCount; ++i)
+    {
+        Usage u = i < categoryCount ? counters[i].Get() : total.Get();
+        if (u.peak == 0)
+        {
+            continue;
+        }
+        std::snprintf(line, sizeof(line), "%-11s %10s %10s%s\n", i < categoryCount ? names[i] : "total",
+                      FormatBytes(u.bytes).c_str(), FormatBytes(u.peak).c_str(),
+                      u.budget > 0 && u.peak > u.budget ? " over budget" : "");
+        report += line;
+    }
+    return report;
+}
+
+void MemoryStats::WriteJson(std::ostream& out)
+{
+    auto write = [&out](const char* name, const Usage& u, bool last)
+    {
+        out << "    \"" << name << "\": {\"bytes\": " << u.bytes << ", \"peak\": " << u.peak;
+        if (u.budget > 0)
+        {
+            out << ", \"budget\": " << u.budget;
+        }
+        out << (last ? "}\n" : "},\n");
+    };
+    out << "{\n  \"categories\": {\n";
+    for (int i = 0; i < categoryCount; ++i)
+    {
+        write(names[i], counters[i].Get(), i + 1 == categoryCount);
+    }
+    out << "  },\n";
+    Usage t = total.Get();
+    out << "  \"total\": {\"bytes\": " << t.bytes << ", \"peak\": " << t.peak << "}\n}\n";
+}
+
+MemoryScope::MemoryScope(MemoryCategory c)
+    : previous(currentCategory)
+{
+    currentCategory = c;
+}
+
+MemoryScope::~MemoryScope()
+{
+    currentCategory = previous;
+}
+
+MemoryCharge::MemoryCharge(MemoryCategory c, size_t bytes)
+{
+    Set(c, bytes);
+}
+
+MemoryCharge::MemoryCharge(const MemoryCharge& m)
+{
+    Set(m.category, m.bytes);
+}
+
+MemoryCharge::MemoryCharge(MemoryCharge&& m) noexcept
+    : category(m.category)
+    , bytes(m.bytes)
+{
+    m.bytes = 0;
+}
+
+MemoryCharge& MemoryCharge::operator=(MemoryCharge m) noexcept
+{
+    std::swap(category, m.category);
+    std::swap(bytes, m.bytes);
+    return *this;
+}
+
+MemoryCharge::~MemoryCharge()
+{
+    Reset();
+}
+
+void MemoryCharge::Set(MemoryCategory c, size_t b)
+{
+    if (c != category)
+    {
+        MemoryStats::Charge(category, -static_cast<int64_t>(bytes));
+        bytes = 0;
+        category = c;
+    }
+    MemoryStats::Charge(category, static_cast<int64_t>(b) - static_cast<int64_t>(bytes));
+    bytes = b;
+}
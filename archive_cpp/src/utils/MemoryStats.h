@@ -0,0 +1,106 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// What memory is charged to. Surfaces and indexed surfaces are charged to
+// the category of the MemoryScope they are created in, everything else
+// through a MemoryCharge kept by its owner.
+enum class MemoryCategory : uint8_t
+{
+    Other,          // untagged surfaces
+    Render,         // frame buffers, views
+    TileSet,        // tile images and collision masks
+    AnimSet,        // decoded animation files and their frames
+    LevelFile,      // parsed level files kept by ResourceFactory
+    LevelGrid,      // layer tile grids
+    Collision,      // level collision bitmaps
+    Events,         // the event store
+    Text,           // rasterized text and fonts
+    Logger,         // log rings and the on-screen console
+    Audio,          // sample blocks and decoded samples
+    Count
+};
+
+// Bytes held per category, counted with relaxed atomics so any thread can
+// charge. The peak is the highest value since the start.
+class MemoryStats
+{
+public:
+    struct Usage
+    {
+        int64_t     bytes = 0;
+        int64_t     peak = 0;
+        int64_t     budget = 0;     // 0: none
+    };
+
+    // snake case, as in the reports
+    static const char* GetName(MemoryCategory c);
+    static bool ParseCategory(const std::string& name, MemoryCategory& c);
+
+    // bytes may be negative, to give memory back
+    static void Charge(MemoryCategory c, int64_t bytes);
+    static Usage Get(MemoryCategory c);
+    static Usage GetTotal();
+
+    // what the current thread's surfaces are charged to
+    static MemoryCategory CurrentCategory();
+    // the same, fallback instead of Other outside of any scope
+    static MemoryCategory CurrentCategoryOr(MemoryCategory fallback);
+
+    // peak bytes a category may reach, checked by GetBudgetViolations
+    static void SetBudget(MemoryCategory c, int64_t bytes);
+    // one line per category over its budget
+    static std::vector<std::string> GetBudgetViolations();
+
+    // a table for humans and the same as a JSON object for tools
+    static std::string GetReport();
+    static void WriteJson(std::ostream& out);
+};
+
+// Surfaces created on this thread while the scope lives are charged to its
+// category. Scopes nest; jobs run on other threads open their own.
+class MemoryScope
+{
+public:
+    explicit MemoryScope(MemoryCategory c);
+    ~MemoryScope();
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+private:
+    MemoryCategory  previous;
+};
+
+// Bytes charged for as long as the owner keeps this. Copying charges the
+// bytes again, moving hands them over.
+class MemoryCharge
+{
+public:
+    MemoryCharge() = default;
+    MemoryCharge(MemoryCategory c, size_t bytes);
+    MemoryCharge(const MemoryCharge& m);
+    MemoryCharge(MemoryCharge&& m) noexcept;
+    MemoryCharge& operator=(MemoryCharge m) noexcept;
+    ~MemoryCharge();
+
+    // charges the difference to what was charged before
+    void Set(MemoryCategory c, size_t bytes);
+    void Reset() { Set(category, 0); }
+    size_t GetBytes() const { return bytes; }
+private:
+    MemoryCategory  category = MemoryCategory::Other;
+    size_t          bytes = 0;
+};
+
+// bytes a vector holds on the heap
+template <typename Vector>
+size_t HeapBytes(const Vector& v)
+{
+    return v.capacity() * sizeof(typename Vector::value_type);
+}
+
+#endif // MEMORYSTATS_H
@@ -0,0 +1,257 @@
+#include "MicroLogger.h"
+#include "MemoryStats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const std::chrono::milliseconds flushPeriod{10};
+
+}
+
+constexpr size_t MicroLogger::ringCapacity;
+constexpr size_t MicroLogger::recordCapacity;
+
+// Single producer (the owning thread) / single consumer (Drain) byte ring.
+// head and tail only grow, the producer publishes whole records by moving
+// head, so the consumer never sees a half written record.
+class MicroLogger::Ring
+{
+public:
+    static_assert((ringCapacity & (ringCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+    std::atomic<bool> owned{true};
+
+    bool Push(const char* data, size_t length)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+        if (ringCapacity - (h - t) < length)
+        {
+            return false;
+        }
+        size_t pos = h & (ringCapacity - 1);
+        size_t first = std::min(length, ringCapacity - pos);
+        std::memcpy(&buffer[pos], data, first);
+        std::memcpy(&buffer[0], data + first, length - first);
+        head.store(h + length, std::memory_order_release);
+        return true;
+    }
+
+    // appends everything available to out
+    void PopAll(std::vector<char>& out)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        while (t != h)
+        {
+            size_t pos = t & (ringCapacity - 1);
+            size_t n = std::min(h - t, ringCapacity - pos);
+            out.insert(out.end(), &buffer[pos], &buffer[pos] + n);
+            t += n;
+        }
+        tail.store(t, std::memory_order_release);
+    }
+private:
+    std::atomic<size_t>     head{0};
+    std::atomic<size_t>     tail{0};
+    char                    buffer[ringCapacity];
+    MemoryCharge            memory{MemoryCategory::Logger, ringCapacity};
+};
+
+// the line being formatted by a thread, and its ring
+struct MicroLogger::ThreadRecord
+{
+    Ring*   ring = nullptr;
+    size_t  size = 0;
+    char    data[recordCapacity];
+
+    ~ThreadRecord()
+    {
+        if (ring != nullptr)
+        {
+            // unfinished lines are lost, the ring goes to the next new thread
+            ring->owned.store(false, std::memory_order_release);
+        }
+    }
+};
+
+MicroLogger& MicroLogger::Instance()
+{
+    static MicroLogger l;
+    return l;
+}
+
+MicroLogger::~MicroLogger()
+{
+    if (flushThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        flushThread.join();
+    }
+    Drain();
+}
+
+void MicroLogger::AppendWriter(std::unique_ptr<ILogWriter>&& writer)
+{
+    std::lock_guard<std::mutex> lock(drainMutex);
+    writers.push_back(std::move(writer));
+    if (!flushThread.joinable())
+    {
+        flushThread = std::thread(&MicroLogger::FlushLoop, this);
+    }
+}
+
+void MicroLogger::Flush()
+{
+    Drain();
+}
+
+void MicroLogger::Write(char c)
+{
+    ThreadRecord& r = GetThreadRecord();
+    r.data[r.size++] = c;
+    if (c == '\n' || r.size == recordCapacity)
+    {
+        Commit(r);
+    }
+}
+
+void MicroLogger::Write(int i)
+{
+    Write(static_cast<long long>(i));
+}
+
+void MicroLogger::Write(long i)
+{
+    Write(static_cast<long long>(i));
+}
+
+void MicroLogger::Write(long long i)
+{
+    char s[32];
+    int n = std::snprintf(s, sizeof(s), "%lld", i);
+    Write(s, n);
+}
+
+void MicroLogger::Write(unsigned i)
+{
+    Write(static_cast<unsigned long long>(i));
+}
+
+void MicroLogger::Write(unsigned long i)
+{
+    Write(static_cast<unsigned long long>(i));
+}
+
+void MicroLogger::Write(unsigned long long i)
+{
+    char s[32];
+    int n = std::snprintf(s, sizeof(s), "%llu", i);
+    Write(s, n);
+}
+
+void MicroLogger::Write(double d)
+{
+    // the default formatting of std::ostream
+    char s[32];
+    int n = std::snprintf(s, sizeof(s), "%g", d);
+    Write(s, n);
+}
+
+void MicroLogger::Write(const std::string& s)
+{
+    Write(s.data(), s.size());
+}
+
+void MicroLogger::Write(const char* s)
+{
+    Write(s, std::strlen(s));
+}
+
+void MicroLogger::Write(const char* s, size_t length)
+{
+    ThreadRecord& r = GetThreadRecord();
+    for (size_t i = 0; i < length; ++i)
+    {
+        r.data[r.size++] = s[i];
+        if (s[i] == '\n' || r.size == recordCapacity)
+        {
+            Commit(r);
+        }
+    }
+}
+
+MicroLogger::ThreadRecord& MicroLogger::GetThreadRecord()
+{
+    static thread_local ThreadRecord record;
+    if (record.ring == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        // reuse the ring of a finished thread
+        for (auto& r : rings)
+        {
+            bool expected = false;
+            if (r->owned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                record.ring = r.get();
+                break;
+            }
+        }
+        if (record.ring == nullptr)
+        {
+            rings.emplace_back(new Ring());
+            record.ring = rings.back().get();
+        }
+    }
+    return record;
+}
+
+void MicroLogger::Commit(ThreadRecord& r)
+{
+    if (!r.ring->Push(r.data, r.size))
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    r.size = 0;
+}
+
+void MicroLogger::Drain()
+{
+    std::lock_guard<std::mutex> lock(drainMutex);
+    batch.clear();
+    {
+        std::lock_guard<std::mutex> ringsLock(ringsMutex);
+        for (auto& r : rings)
+        {
+            r->PopAll(batch);
+        }
+    }
+    if (batch.empty())
+    {
+        return;
+    }
+    for (auto& w : writers)
+    {
+        w->Write(batch.data(), batch.size());
+    }
+}
+
+void MicroLogger::FlushLoop()
+{
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!stopping)
+    {
+        wake.wait_for(lock, flushPeriod);
+        lock.unlock();
+        Drain();
+        lock.lock();
+    }
+}
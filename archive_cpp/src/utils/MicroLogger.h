@@ -1,41 +1,53 @@
 #ifndef MICROLOGGER_H
 #define MICROLOGGER_H
 
-#include <string>
-#include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <fstream>
-#include <stdexcept>
+#include <iostream>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 #include <assert.h>
 
+// Log levels, the statements below OPENJAZZ_LOG_LEVEL are removed at
+// compile time together with the evaluation of their arguments.
+#define OPENJAZZ_LOG_DEBUG      0
+#define OPENJAZZ_LOG_INFO       1
+#define OPENJAZZ_LOG_WARNING    2
+#define OPENJAZZ_LOG_ERROR      3
+
+#ifndef OPENJAZZ_LOG_LEVEL
+#ifdef NDEBUG
+#define OPENJAZZ_LOG_LEVEL OPENJAZZ_LOG_INFO
+#else
+#define OPENJAZZ_LOG_LEVEL OPENJAZZ_LOG_DEBUG
+#endif
+#endif
+
+// Sinks are called from the flush thread only, with whole records
+// (usually lines) batched together.
 class ILogWriter
 {
 public:
-    virtual void Write(char c) = 0;
-    virtual void Write(double d) = 0;
-    virtual void Write(int i) = 0;
+    virtual void Write(const char* text, size_t length) = 0;
     virtual ~ILogWriter() {}
 };
 
 class ConsoleWriter : public ILogWriter
 {
 public:
-    virtual void Write(char c)
-    {        
-        std::cout << c;
-    }
-
-    virtual void Write(double d)
+    virtual void Write(const char* text, size_t length)
     {
-        std::cout << d;
-    }
-
-    virtual void Write(int i)
-    {
-        std::cout << i;
+        std::cout.write(text, length);
+        std::cout.flush();
     }
 };
+
 class FileWriter : public ILogWriter
 {
 public:
@@ -53,37 +65,37 @@ public:
         outputFile.close();
     }
 
-    virtual void Write(char c)
-    {
-        outputFile << c;
-    }
-
-    virtual void Write(double d)
-    {
-        outputFile << d;
-    }
-
-    virtual void Write(int i)
+    virtual void Write(const char* text, size_t length)
     {
-        outputFile << i;
+        outputFile.write(text, length);
     }
 private:
     std::ofstream outputFile;
 };
 
+/*
+ * Asynchronous logger. The calling thread only formats into a thread local
+ * record and, at the end of a line, copies the record into its own
+ * single-producer ring buffer; it never waits for a lock or for the sinks.
+ * A background thread drains the rings in batches to the writers. When a
+ * ring is full the record is dropped (see GetDroppedCount()). Records keep
+ * their order within a thread, not across threads.
+ */
 class MicroLogger
 {
 public:
-    static MicroLogger& Instance()
-    {
-        static MicroLogger l;
-        return l;
-    }
+    // bytes of a thread's ring, records up to recordCapacity bytes are kept whole
+    static constexpr size_t ringCapacity = 64 * 1024;
+    static constexpr size_t recordCapacity = 512;
 
-    void AppendWriter(std::unique_ptr<ILogWriter>&& writer)
-    {
-        writers.push_back(std::move(writer));
-    }
+    static MicroLogger& Instance();
+    ~MicroLogger();
+
+    // the flush thread starts with the first writer
+    void AppendWriter(std::unique_ptr<ILogWriter>&& writer);
+    // writes everything logged so far (by complete lines) to the writers
+    void Flush();
+    uint64_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
 
     void printf(const char *s)
     {
@@ -126,28 +138,49 @@ public:
     }
 
 private:
-    template <typename T>
-    void Write(T c)
-    {
-        for (auto& w : writers)
-        {
-            w->Write(c);
-        }
-    }
-
-    void Write(const std::string& s)
-    {
-        for (auto c: s)
-        {
-            Write(c);
-        }
-    }
+    class Ring;
+    struct ThreadRecord;
+
+    MicroLogger() = default;
+
+    void Write(char c);
+    void Write(int i);
+    void Write(long i);
+    void Write(long long i);
+    void Write(unsigned i);
+    void Write(unsigned long i);
+    void Write(unsigned long long i);
+    void Write(double d);
+    void Write(const std::string& s);
+    void Write(const char* s);
+    void Write(const char* s, size_t length);
+
+    ThreadRecord& GetThreadRecord();
+    void Commit(ThreadRecord& r);
+    void Drain();
+    void FlushLoop();
 
     std::vector<std::unique_ptr<ILogWriter>>    writers;
+    std::vector<std::unique_ptr<Ring>>          rings;      // one per (living) thread
+    std::mutex                                  ringsMutex; // registration
+    std::mutex                                  drainMutex; // single consumer
+    std::vector<char>                           batch;
+    std::mutex                                  wakeMutex;
+    std::condition_variable                     wake;
+    std::thread                                 flushThread;
+    bool                                        stopping = false;
+    std::atomic<uint64_t>                       dropped{0};
 };
 
 #define LOG (MicroLogger::Instance())
 
+// LOG_DEBUG << ... is compiled out when OPENJAZZ_LOG_LEVEL is above debug
+#define OPENJAZZ_LOG_AT(level) if ((level) < OPENJAZZ_LOG_LEVEL) {} else LOG
+#define LOG_DEBUG   OPENJAZZ_LOG_AT(OPENJAZZ_LOG_DEBUG)
+#define LOG_INFO    OPENJAZZ_LOG_AT(OPENJAZZ_LOG_INFO)
+#define LOG_WARNING OPENJAZZ_LOG_AT(OPENJAZZ_LOG_WARNING)
+#define LOG_ERROR   OPENJAZZ_LOG_AT(OPENJAZZ_LOG_ERROR)
+
 template <typename T>
 inline MicroLogger& operator<<(MicroLogger& logger, T v)
 {
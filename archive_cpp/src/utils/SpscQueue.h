@@ -0,0 +1,71 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded queue from one producer thread to one consumer thread, without
+// locks and without allocating after construction: the items live in a
+// ring of Capacity slots, each side advances its own index and only reads
+// the other one. Push fails when the ring is full instead of waiting, so
+// neither side ever blocks. Capacity is a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity is a power of two");
+public:
+    // producer: false when full, item is then not queued
+    bool Push(const T& item)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == Capacity)
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == Capacity)
+            {
+                return false;
+            }
+        }
+        items[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: false when empty
+    bool Pop(T& item)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail)
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail)
+            {
+                return false;
+            }
+        }
+        item = items[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // either side, exact only when the other side is idle
+    size_t Size() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+private:
+    static constexpr size_t mask = Capacity - 1;
+    // indices only grow, slot = index & mask; each side keeps the last
+    // value it read of the other's index and rereads it only when that one
+    // says full or empty. The padding keeps the two sides off each other's
+    // cache lines.
+    T                   items[Capacity];
+    std::atomic<size_t> tail{0};
+    size_t              cachedHead = 0;
+    char                producerPadding[64];
+    std::atomic<size_t> head{0};
+    size_t              cachedTail = 0;
+    char                consumerPadding[64];
+};
+
+#endif // SPSCQUEUE_H
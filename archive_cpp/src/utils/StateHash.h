@@ -0,0 +1,34 @@
+#ifndef STATEHASH_H
+#define STATEHASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// 64 bit FNV-1a over game state, to tell whether two runs (a replay on two
+// builds) ended the same. Values are added one by one, never whole structs,
+// so padding does not get hashed.
+class StateHash
+{
+public:
+    template <typename T>
+    StateHash& Add(const T& value)
+    {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                      "add the members one by one");
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (unsigned char b : bytes)
+        {
+            hash = (hash ^ b) * prime;
+        }
+        return *this;
+    }
+    uint64_t Value() const { return hash; }
+private:
+    static constexpr uint64_t prime = 1099511628211ull;
+
+    uint64_t hash = 14695981039346656037ull;
+};
+
+#endif // STATEHASH_H
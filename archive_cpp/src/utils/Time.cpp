@@ -18,9 +18,38 @@
 #include "Time.h"
 
 #include <SDL2/SDL.h>
+#include <atomic>
+
+namespace {
+
+// read by the simulation and the render thread
+std::atomic<bool> virtualTime{false};
+std::atomic<GameClock::rep> virtualNow{0};
+
+}
 
 GameClock::time_point GameClock::now() noexcept
 {
+    if (virtualTime.load(std::memory_order_acquire))
+    {
+        return time_point(duration(virtualNow.load(std::memory_order_relaxed)));
+    }
     auto sdl_time = SDL_GetTicks();
     return time_point(duration(sdl_time));
 }
+
+void GameClock::SetVirtualTime(time_point t) noexcept
+{
+    virtualNow.store(t.time_since_epoch().count(), std::memory_order_relaxed);
+    virtualTime.store(true, std::memory_order_release);
+}
+
+void GameClock::UseRealTime() noexcept
+{
+    virtualTime.store(false, std::memory_order_release);
+}
+
+bool GameClock::IsVirtual() noexcept
+{
+    return virtualTime.load(std::memory_order_acquire);
+}
@@ -35,6 +35,12 @@ public:
 
     static constexpr bool is_steady = false;
     static time_point now() noexcept;
+
+    // deterministic runs (recording, replay): now() returns the time set
+    // last instead of SDL_GetTicks(), until UseRealTime()
+    static void SetVirtualTime(time_point t) noexcept;
+    static void UseRealTime() noexcept;
+    static bool IsVirtual() noexcept;
 private:
     static_assert(GameClock::duration::min() < GameClock::duration::zero(),
           "a clock's minimum duration cannot be less than its epoch");
@@ -0,0 +1,47 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Hands values from one writer thread to one reader thread without locks
+// and without either side waiting. The writer fills Back() and publishes
+// it; the reader takes the newest published value, older ones it did not
+// get to are skipped. Each side owns one of the three slots, the third is
+// exchanged through an atomic index, so the slots are reused and a writer
+// that keeps the capacity of its containers does not allocate.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // writer: the slot to fill, its content is whatever was there before
+    T& Back() { return slots[back]; }
+    void Publish()
+    {
+        uint8_t previous = middle.exchange(back | fresh, std::memory_order_acq_rel);
+        back = previous & index;
+    }
+
+    // reader: the newest published value, valid until the next Acquire()
+    const T& Acquire()
+    {
+        if (middle.load(std::memory_order_relaxed) & fresh)
+        {
+            uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+            front = previous & index;
+        }
+        return slots[front];
+    }
+    // reader: the value returned by the last Acquire()
+    const T& Front() const { return slots[front]; }
+private:
+    static constexpr uint8_t index = 0x3;
+    static constexpr uint8_t fresh = 0x4;
+
+    T                       slots[3];
+    uint8_t                 back = 0;
+    std::atomic<uint8_t>    middle{1};
+    uint8_t                 front = 2;
+};
+
+#endif // TRIPLEBUFFER_H